@@ -117,6 +117,10 @@ void* GLBuffer::MapRange(intptr offset, sizeiptr length, uint map_flags)
 		bits |= GL_MAP_FLUSH_EXPLICIT_BIT;
 	if (map_flags & MAP_UNSYNCHRONIZED_BIT)
 		bits |= GL_MAP_UNSYNCHRONIZED_BIT;
+	if (map_flags & MAP_PERSISTENT_BIT)
+		bits |= GL_MAP_PERSISTENT_BIT;
+	if (map_flags & MAP_COHERENT_BIT)
+		bits |= GL_MAP_COHERENT_BIT;
 
 	void* ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, length, bits);
 	return ptr;
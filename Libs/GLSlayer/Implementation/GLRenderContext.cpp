@@ -246,6 +246,10 @@ bool GLRenderContext::InitCommon(uint version)
 
 	GetContextInfo();
 
+	// Let the driver use as many compiler threads as it wants for Create*ShaderAsync.
+	if (_info.featuresGL.KHR_parallel_shader_compile)
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+
 	if (!_info.featuresGL.ARB_vertex_attrib_binding)
 	{
 		// We use these only if we don't have the ARB_vertex_attrib_binding extension to keep track of the current streams (buffer bindings) and attributes.
@@ -507,6 +511,8 @@ bool GLRenderContext::LoadOpenGLExtensions(uint version)
 		LOAD_EXTENSION(GL_KHR_debug);
 	}
 
+	LOAD_EXTENSION(GL_KHR_parallel_shader_compile);
+
 	if (version >= 440)
 	{
 		LOAD_EXTENSION_REQ(GL_VERSION_4_4);
@@ -2823,6 +2829,13 @@ IVertexShader* GLRenderContext::CreateVertexShader(sizei size, const void* binar
 	return shader;
 }
 
+IVertexShader* GLRenderContext::CreateVertexShaderAsync(sizei count, const char** source, bool& success)
+{
+	GLVertexShader* shader = new GLVertexShader;
+	success = shader->CreateAsync(count, source, _info.featuresGL.KHR_parallel_shader_compile);
+	return shader;
+}
+
 IVertexShader* GLRenderContext::CreateVertexShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
 {
 	GLVertexShader* shader = new GLVertexShader;
@@ -2851,6 +2864,13 @@ ITessControlShader* GLRenderContext::CreateTessControlShader(sizei size, const v
 	return shader;
 }
 
+ITessControlShader* GLRenderContext::CreateTessControlShaderAsync(sizei count, const char** source, bool& success)
+{
+	GLTessControlShader* shader = new GLTessControlShader;
+	success = shader->CreateAsync(count, source, _info.featuresGL.KHR_parallel_shader_compile);
+	return shader;
+}
+
 ITessControlShader* GLRenderContext::CreateTessControlShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
 {
 	GLTessControlShader* shader = new GLTessControlShader;
@@ -2879,6 +2899,13 @@ ITessEvaluationShader* GLRenderContext::CreateTessEvaluationShader(sizei size, c
 	return shader;
 }
 
+ITessEvaluationShader* GLRenderContext::CreateTessEvaluationShaderAsync(sizei count, const char** source, bool& success)
+{
+	GLTessEvaluationShader* shader = new GLTessEvaluationShader;
+	success = shader->CreateAsync(count, source, _info.featuresGL.KHR_parallel_shader_compile);
+	return shader;
+}
+
 ITessEvaluationShader* GLRenderContext::CreateTessEvaluationShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
 {
 	GLTessEvaluationShader* shader = new GLTessEvaluationShader;
@@ -2907,6 +2934,13 @@ IGeometryShader* GLRenderContext::CreateGeometryShader(sizei size, const void* b
 	return shader;
 }
 
+IGeometryShader* GLRenderContext::CreateGeometryShaderAsync(sizei count, const char** source, bool& success)
+{
+	GLGeometryShader* shader = new GLGeometryShader;
+	success = shader->CreateAsync(count, source, _info.featuresGL.KHR_parallel_shader_compile);
+	return shader;
+}
+
 IGeometryShader* GLRenderContext::CreateGeometryShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
 {
 	GLGeometryShader* shader = new GLGeometryShader;
@@ -2935,6 +2969,13 @@ IFragmentShader* GLRenderContext::CreateFragmentShader(sizei size, const void* b
 	return shader;
 }
 
+IFragmentShader* GLRenderContext::CreateFragmentShaderAsync(sizei count, const char** source, bool& success)
+{
+	GLFragmentShader* shader = new GLFragmentShader;
+	success = shader->CreateAsync(count, source, _info.featuresGL.KHR_parallel_shader_compile);
+	return shader;
+}
+
 IComputeShader* GLRenderContext::CreateComputeShader(sizei count, const char** source, bool& success)
 {
 	GLComputeShader* shader = new GLComputeShader;
@@ -2949,6 +2990,13 @@ IComputeShader* GLRenderContext::CreateComputeShader(sizei size, const void* bin
 	return shader;
 }
 
+IComputeShader* GLRenderContext::CreateComputeShaderAsync(sizei count, const char** source, bool& success)
+{
+	GLComputeShader* shader = new GLComputeShader;
+	success = shader->CreateAsync(count, source, _info.featuresGL.KHR_parallel_shader_compile);
+	return shader;
+}
+
 void GLRenderContext::DestroyShader(IShader* shader)
 {
 	if (shader)
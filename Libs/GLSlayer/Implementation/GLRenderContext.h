@@ -297,29 +297,35 @@ public:
 
 	virtual IVertexShader* CreateVertexShader(sizei count, const char** source, bool& success) override;
 	virtual IVertexShader* CreateVertexShader(sizei size, const void* binary, uint format, bool& success) override;
+	virtual IVertexShader* CreateVertexShaderAsync(sizei count, const char** source, bool& success) override;
 	virtual IVertexShader* CreateVertexShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) override;
 	virtual IVertexShader* CreateVertexShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) override;
 
 	virtual ITessControlShader* CreateTessControlShader(sizei count, const char** source, bool& success) override;
 	virtual ITessControlShader* CreateTessControlShader(sizei size, const void* binary, uint format, bool& success) override;
+	virtual ITessControlShader* CreateTessControlShaderAsync(sizei count, const char** source, bool& success) override;
 	virtual ITessControlShader* CreateTessControlShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) override;
 	virtual ITessControlShader* CreateTessControlShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) override;
 
 	virtual ITessEvaluationShader* CreateTessEvaluationShader(sizei count, const char** source, bool& success) override;
 	virtual ITessEvaluationShader* CreateTessEvaluationShader(sizei size, const void* binary, uint format, bool& success) override;
+	virtual ITessEvaluationShader* CreateTessEvaluationShaderAsync(sizei count, const char** source, bool& success) override;
 	virtual ITessEvaluationShader* CreateTessEvaluationShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) override;
 	virtual ITessEvaluationShader* CreateTessEvaluationShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) override;
 
 	virtual IGeometryShader* CreateGeometryShader(sizei count, const char** source, bool& success) override;
 	virtual IGeometryShader* CreateGeometryShader(sizei size, const void* binary, uint format, bool& success) override;
+	virtual IGeometryShader* CreateGeometryShaderAsync(sizei count, const char** source, bool& success) override;
 	virtual IGeometryShader* CreateGeometryShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) override;
 	virtual IGeometryShader* CreateGeometryShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) override;
 
 	virtual IFragmentShader* CreateFragmentShader(sizei count, const char** source, bool& success) override;
 	virtual IFragmentShader* CreateFragmentShader(sizei size, const void* binary, uint format, bool& success) override;
+	virtual IFragmentShader* CreateFragmentShaderAsync(sizei count, const char** source, bool& success) override;
 
 	virtual IComputeShader* CreateComputeShader(sizei count, const char** source, bool& success) override;
 	virtual IComputeShader* CreateComputeShader(sizei size, const void* binary, uint format, bool& success) override;
+	virtual IComputeShader* CreateComputeShaderAsync(sizei count, const char** source, bool& success) override;
 
 	virtual void DestroyShader(IShader* shader) override;
 
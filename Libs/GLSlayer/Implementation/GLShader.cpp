@@ -13,6 +13,11 @@ GLShader::GLShader()
 	_logInfo = 0;
 	_logInfoLength = 0;
 
+	_pendingShader = 0;
+	_buildPending = false;
+	_buildSuccess = false;
+	_queryCompletion = false;
+
 	_uniformBlockCount = 0;
 	_uniformBlockArraySize = 0;
 	_uniformBlockInfos = nullptr;
@@ -63,7 +68,8 @@ bool GLShader::Create(sizei count, const char** source)
 		RetrieveLog();
 	}
 
-	return (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	_buildSuccess = (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	return _buildSuccess;
 }
 
 bool GLShader::Create(sizei size, const void* binary, uint format)
@@ -80,7 +86,38 @@ bool GLShader::Create(sizei size, const void* binary, uint format)
 		RetrieveLog();
 	}
 
-	return (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	_buildSuccess = (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	return _buildSuccess;
+}
+
+bool GLShader::CreateAsync(sizei count, const char** source, bool query_completion)
+{
+	GLuint shader = glCreateShader(_target);
+	if (!shader)
+		return false;
+
+	glShaderSource(shader, count, source, 0);
+	glCompileShader(shader);
+
+	_id = glCreateProgram();
+	if (!_id)
+	{
+		glDeleteShader(shader);
+		return false;
+	}
+
+	glProgramParameteri(_id, GL_PROGRAM_SEPARABLE, GL_TRUE);
+	glProgramParameteri(_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glAttachShader(_id, shader);
+	glLinkProgram(_id);
+
+	// Compile and link status are not queried here so that the driver can build several programs
+	// in parallel. The status is resolved by the first call that needs it.
+	_pendingShader = shader;
+	_buildPending = true;
+	_queryCompletion = query_completion;
+
+	return (glGetError() == GL_NO_ERROR);
 }
 
 bool GLShader::CreateWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names)
@@ -113,7 +150,8 @@ bool GLShader::CreateWithTransformFeedback(sizei count, const char** source, siz
 		_id = program;
 	}
 
-	return (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	_buildSuccess = (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	return _buildSuccess;
 }
 
 bool GLShader::CreateWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names)
@@ -131,11 +169,19 @@ bool GLShader::CreateWithTransformFeedback(sizei size, const void* binary, uint
 		RetrieveLog();
 	}
 
-	return (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	_buildSuccess = (glGetError() == GL_NO_ERROR && linked == GL_TRUE);
+	return _buildSuccess;
 }
 
 void GLShader::Destroy()
 {
+	if (_pendingShader)
+	{
+		glDeleteShader(_pendingShader);
+		_pendingShader = 0;
+		_buildPending = false;
+	}
+
 	if (_id)
 	{
 		glDeleteProgram(_id);
@@ -151,16 +197,19 @@ ShaderType GLShader::GetShaderType()
 
 const char* GLShader::GetInfoLog()
 {
+	ResolveBuild();
 	return _logInfo;
 }
 
 int GLShader::GetInfoLogLength()
 {
+	ResolveBuild();
 	return _logInfoLength;
 }
 
 bool GLShader::Validate()
 {
+	ResolveBuild();
 	glValidateProgram(_id);
 
 	GLint status;
@@ -193,6 +242,8 @@ bool GLShader::GetBinary(uint& format, sizei buffer_size, void* buffer)
 	if(!result)
 		return false;*/
 
+	ResolveBuild();
+
 	GLsizei length;
 	GLenum gl_fmt;
 	glGetProgramBinary(_id, buffer_size, &length, &gl_fmt, buffer);
@@ -203,11 +254,53 @@ bool GLShader::GetBinary(uint& format, sizei buffer_size, void* buffer)
 
 int GLShader::GetBinarySize()
 {
+	ResolveBuild();
+
 	GLint size;
 	glGetProgramiv(_id, GL_PROGRAM_BINARY_LENGTH, &size);
 	return size;
 }
 
+bool GLShader::IsBuildComplete()
+{
+	if (!_buildPending)
+		return true;
+
+	// Without GL_KHR_parallel_shader_compile there is no way to poll, so report the build as complete
+	// and let the status query wait for it.
+	if (!_queryCompletion)
+		return true;
+
+	GLint completed = GL_FALSE;
+	glGetProgramiv(_id, GL_COMPLETION_STATUS_KHR, &completed);
+	return (completed == GL_TRUE);
+}
+
+bool GLShader::GetBuildStatus()
+{
+	ResolveBuild();
+	return _buildSuccess;
+}
+
+void GLShader::ResolveBuild()
+{
+	if (!_buildPending)
+		return;
+
+	GLint compiled = GL_FALSE;
+	GLint linked = GL_FALSE;
+	glGetShaderiv(_pendingShader, GL_COMPILE_STATUS, &compiled);
+	glGetProgramiv(_id, GL_LINK_STATUS, &linked);
+
+	RetrieveLog2(_id, _pendingShader);
+
+	glDetachShader(_id, _pendingShader);
+	glDeleteShader(_pendingShader);
+	_pendingShader = 0;
+	_buildPending = false;
+	_buildSuccess = (compiled == GL_TRUE && linked == GL_TRUE);
+}
+
 const ShaderBlockInfo* GLShader::GetUniformBlockInfo(const char* blockName)
 {
 	if (!_id || !blockName || !*blockName)
@@ -15,6 +15,8 @@
 	virtual uint GetSubroutineIndex(const char* name) override { return GLShader::GetSubroutineIndex(name); } \
 	virtual bool GetBinary(uint& format, sizei buffer_size, void* buffer) override { return GLShader::GetBinary(format, buffer_size, buffer); } \
 	virtual int GetBinarySize() override { return GLShader::GetBinarySize(); } \
+	virtual bool IsBuildComplete() override { return GLShader::IsBuildComplete(); } \
+	virtual bool GetBuildStatus() override { return GLShader::GetBuildStatus(); } \
 	virtual const ShaderBlockInfo* GetUniformBlockInfo(const char* blockName) override { return GLShader::GetUniformBlockInfo(blockName); } \
 	virtual const ShaderBlockInfo* GetStorageBlockInfo(const char* blockName) override { return GLShader::GetStorageBlockInfo(blockName); }
 
@@ -35,6 +37,7 @@ public:
 
 	bool Create(sizei count, const char** source);
 	bool Create(sizei size, const void* binary, uint format);
+	bool CreateAsync(sizei count, const char** source, bool query_completion);
 	bool CreateWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names);
 	bool CreateWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names);
 	void Destroy();
@@ -47,6 +50,9 @@ public:
 	uint GetSubroutineIndex(const char* name);
 	bool GetBinary(uint& format, sizei buffer_size, void* buffer);
 	int GetBinarySize();
+	bool IsBuildComplete();
+	bool GetBuildStatus();
+	void ResolveBuild();
 	const ShaderBlockInfo* GetUniformBlockInfo(const char* blockName);
 	const ShaderBlockInfo* GetStorageBlockInfo(const char* blockName);
 
@@ -60,6 +66,11 @@ private:
 	char* _logInfo;
 	int _logInfoLength;
 
+	GLuint _pendingShader;
+	bool _buildPending;
+	bool _buildSuccess;
+	bool _queryCompletion;
+
 	sizei _uniformBlockCount;
 	sizei _uniformBlockArraySize;
 	ShaderBlockInfo* _uniformBlockInfos;
@@ -10,6 +10,8 @@ const char* messageTable[] =
 	"Failed to create rendering context (version %u): %s.",
 	"The driver does not have an entry for function %s.",
 	"Extension %s is not supported.",
+	"Null rendering context destroyed with %u live objects.",
+	"%s called with an object not created by this context.",
 
 #if defined (_WIN32)
 	"Failed to create temporary rendering context: %s.",
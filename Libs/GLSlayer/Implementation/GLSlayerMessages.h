@@ -11,6 +11,8 @@ enum class ErrorMessageId : int
 	CreateContext,
 	ExtensionMissingEntries,
 	UnsupportedExtension,
+	NullContextLiveResources,
+	UnknownObject,
 
 #if defined (_WIN32)
 	CreateTemporaryContext,
@@ -0,0 +1,1440 @@
+#include "NullRenderContext.h"
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+
+
+gls::INullRenderContext* gls::CreateNullRenderContext(const gls::CreateNullContextInfo& info)
+{
+	gls::internals::NullRenderContext* render_context = new gls::internals::NullRenderContext(info.logger);
+	bool result = render_context->Create(info.version, info.width, info.height, info.commandLogger);
+	if(!result)
+	{
+		delete render_context;
+		render_context = 0;
+	}
+	return render_context;
+}
+
+void gls::DestroyNullRenderContext(gls::INullRenderContext* render_context)
+{
+	if(render_context)
+	{
+		static_cast<gls::internals::NullRenderContext*>(render_context)->Destroy();
+		delete render_context;
+	}
+}
+
+
+namespace gls::internals
+{
+
+NullRenderContext::NullRenderContext(IDebugLogger* logger) :
+	_logger(logger)
+{
+}
+
+NullRenderContext::~NullRenderContext()
+{
+	Destroy();
+}
+
+bool NullRenderContext::Create(uint version, int width, int height, ICommandLogger* command_logger)
+{
+	if (version < 330)
+	{
+		DebugMessage(DebugMessageSeverity::High, ErrorMessageId::UnsupportedVersion);
+		return false;
+	}
+
+	_state.commandLogger = command_logger;
+
+	// Report the requested version and limits generous enough for any renderer that runs on real hardware.
+	_info.renderer = "GLSlayer null renderer";
+	_info.vendor = "GLSlayer";
+	_info.versionString = "4.6 null";
+	_info.shadingLanguageVersion = "4.60";
+	_info.versionMajor = version / 100;
+	_info.versionMinor = (version / 10) % 10;
+	_info.maxTextureSize = 16384;
+	_info.max3DTextureSize = 2048;
+	_info.maxCubeMapSize = 16384;
+	_info.maxRectangleTextureSize = 16384;
+	_info.maxViewportWidth = 16384;
+	_info.maxViewportHeight = 16384;
+	_info.maxVertexAttribs = 16;
+	_info.maxCombinedTextureImageUnits = 192;
+	_info.maxTextureAnisotropy = 16.0f;
+	_info.maxDrawBuffers = 8;
+	_info.maxTextureBufferSize = 1 << 27;
+	_info.maxUniformBlockSize = 1 << 16;
+	_info.maxCombinedUniformBlocks = 84;
+	_info.uniformBufferOffsetAlignment = 256;
+	_info.maxSamples = 8;
+	_info.maxColorTextureSamples = 8;
+	_info.maxDepthTextureSamples = 8;
+	_info.maxIntegerSamples = 8;
+	_info.maxShaderStorageBufferBindings = 16;
+	_info.maxShaderStorageBlockSize = 1 << 27;
+	_info.shaderStorageBufferOffsetAlignment = 256;
+	_info.textureBufferOffsetAlignment = 256;
+	_info.maxComputeWorkGroupCountX = 65535;
+	_info.maxComputeWorkGroupCountY = 65535;
+	_info.maxComputeWorkGroupCountZ = 65535;
+	_info.maxComputeWorkGroupSizeX = 1024;
+	_info.maxComputeWorkGroupSizeY = 1024;
+	_info.maxComputeWorkGroupSizeZ = 64;
+	_info.maxComputeWorkGroupInvocations = 1024;
+	_info.maxFramebufferWidth = 16384;
+	_info.maxFramebufferHeight = 16384;
+	_info.maxFramebufferLayers = 2048;
+	_info.maxFramebufferSamples = 8;
+
+	_viewport[2] = width;
+	_viewport[3] = height;
+
+	return true;
+}
+
+void NullRenderContext::Destroy()
+{
+	if (!_objects.empty())
+		DebugMessage(DebugMessageSeverity::Medium, ErrorMessageId::NullContextLiveResources, static_cast<uint>(_objects.size()));
+
+	_objects.clear();
+	_state.stats.liveResources = 0;
+}
+
+const RenderStats& NullRenderContext::GetStats() const
+{
+	return _state.stats;
+}
+
+void NullRenderContext::ResetStats()
+{
+	uint64 liveResources = _state.stats.liveResources;
+	uint64 liveBufferBytes = _state.stats.liveBufferBytes;
+	_state.stats = {};
+	_state.stats.liveResources = liveResources;
+	_state.stats.liveBufferBytes = liveBufferBytes;
+}
+
+void NullRenderContext::SetCommandLogger(ICommandLogger* logger)
+{
+	_state.commandLogger = logger;
+}
+
+template <class T, class... Args>
+T* NullRenderContext::CreateObject(Args&&... args)
+{
+	std::unique_ptr<T> object = std::make_unique<T>(&_state, std::forward<Args>(args)...);
+	T* result = object.get();
+	_objects[dynamic_cast<const void*>(result)] = std::move(object);
+	_state.stats.liveResources++;
+	return result;
+}
+
+template <class T>
+void NullRenderContext::DestroyObject(T* object, const char* command)
+{
+	if (object == nullptr)
+		return;
+
+	auto it = _objects.find(dynamic_cast<const void*>(object));
+	if (it == _objects.end())
+	{
+		DebugMessage(DebugMessageSeverity::High, ErrorMessageId::UnknownObject, command);
+		return;
+	}
+
+	_objects.erase(it);
+	_state.stats.liveResources--;
+	LogCommand("%s", command);
+}
+
+void NullRenderContext::CountDraw(sizei count, sizei inst_count)
+{
+	_state.stats.drawCalls++;
+	_state.stats.instances += inst_count;
+	_state.stats.vertices += static_cast<uint64>(count) * inst_count;
+}
+
+void NullRenderContext::CountIndirectDraws(IBuffer* buffer, intptr offset, sizei count, sizei stride, bool indexed)
+{
+	// Buffers keep their contents, so draw parameters can be read back just like the GPU would.
+	NullBuffer* nullBuffer = static_cast<NullBuffer*>(buffer);
+	sizeiptr size = indexed ? sizeof(DrawIndexedIndirectData) : sizeof(DrawIndirectData);
+	if (stride == 0)
+		stride = static_cast<sizei>(size);
+
+	for (sizei i = 0; i < count; ++i)
+	{
+		intptr cmdOffset = offset + static_cast<intptr>(i) * stride;
+		if (nullBuffer == nullptr || cmdOffset < 0 || cmdOffset + size > nullBuffer->GetSize())
+		{
+			CountDraw(0, 1);
+			continue;
+		}
+
+		uint cmd[2];	// count and instanceCount come first in both structures
+		nullBuffer->GetBufferSubData(cmdOffset, sizeof(cmd), cmd);
+		CountDraw(static_cast<sizei>(cmd[0]), static_cast<sizei>(cmd[1]));
+	}
+}
+
+void NullRenderContext::DebugMessage(DebugMessageSeverity severity, ErrorMessageId message_id, ...)
+{
+	if (_logger)
+	{
+		const char* message = GetMessageString(message_id);
+		if (message)
+		{
+			va_list args;
+			va_start(args, message_id);
+
+			char buf[1024];
+			vsnprintf(buf, 1024, message, args);
+
+			va_end(args);
+
+			_logger->DebugMessage(DebugMessageSource::ThirdParty, DebugMessageType::Error, static_cast<uint>(message_id), severity, buf);
+		}
+	}
+}
+
+bool NullRenderContext::SetCurrentContext()
+{
+	return true;
+}
+
+void NullRenderContext::UnsetCurrentContext()
+{
+}
+
+const ContextInfo& NullRenderContext::GetInfo() const
+{
+	return _info;
+}
+
+void NullRenderContext::VertexSource(int stream, IBuffer* buffer, sizei stride, intptr offset, uint divisor)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("VertexSource");
+}
+
+void NullRenderContext::IndexSource(IBuffer* buffer, DataType index_type)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("IndexSource");
+}
+
+void NullRenderContext::ActiveVertexFormat(IVertexFormat* format)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("ActiveVertexFormat");
+}
+
+void NullRenderContext::EnablePrimitiveRestart(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnablePrimitiveRestart");
+}
+
+void NullRenderContext::EnablePrimitiveRestartFixedIndex(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnablePrimitiveRestartFixedIndex");
+}
+
+void NullRenderContext::PrimitiveRestartIndex(uint index)
+{
+	_state.stats.stateChanges++;
+	LogCommand("PrimitiveRestartIndex");
+}
+
+void NullRenderContext::ProvokingVertex(VertexConvention vertex_convention)
+{
+	_state.stats.stateChanges++;
+	LogCommand("ProvokingVertex");
+}
+
+void NullRenderContext::PatchVertexCount(int count)
+{
+	_state.stats.stateChanges++;
+	LogCommand("PatchVertexCount");
+}
+
+void NullRenderContext::PatchDefaultOuterLevels(const float values[4])
+{
+	_state.stats.stateChanges++;
+	LogCommand("PatchDefaultOuterLevels");
+}
+
+void NullRenderContext::PatchDefaultInnerLevels(const float values[2])
+{
+	_state.stats.stateChanges++;
+	LogCommand("PatchDefaultInnerLevels");
+}
+
+void NullRenderContext::BeginConditionalRender(IQuery* query, ConditionalRenderQueryMode mode)
+{
+	LogCommand("BeginConditionalRender");
+}
+
+void NullRenderContext::EndConditionalRender()
+{
+	LogCommand("EndConditionalRender");
+}
+
+void NullRenderContext::BeginTransformFeedback(PrimitiveType primitive, ITransformFeedback* transform_feedback)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("BeginTransformFeedback");
+}
+
+void NullRenderContext::EndTransformFeedback()
+{
+	LogCommand("EndTransformFeedback");
+}
+
+void NullRenderContext::PauseTransformFeedback()
+{
+	LogCommand("PauseTransformFeedback");
+}
+
+void NullRenderContext::ResumeTransformFeedback()
+{
+	LogCommand("ResumeTransformFeedback");
+}
+
+void NullRenderContext::Viewport(int x, int y, int width, int height)
+{
+	_viewport[0] = x;
+	_viewport[1] = y;
+	_viewport[2] = width;
+	_viewport[3] = height;
+	_state.stats.stateChanges++;
+	LogCommand("Viewport %d %d %d %d", x, y, width, height);
+}
+
+void NullRenderContext::ViewportIndexed(uint index, float x, float y, float width, float height)
+{
+	_state.stats.stateChanges++;
+	LogCommand("ViewportIndexed");
+}
+
+void NullRenderContext::ClipControl(ClipOrigin origin, ClipDepth depth)
+{
+	_state.stats.stateChanges++;
+	LogCommand("ClipControl");
+}
+
+void NullRenderContext::EnableFaceCulling(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableFaceCulling");
+}
+
+void NullRenderContext::CullFace(PolygonFace face)
+{
+	_state.stats.stateChanges++;
+	LogCommand("CullFace");
+}
+
+void NullRenderContext::FrontFace(VertexWinding orient)
+{
+	_state.stats.stateChanges++;
+	LogCommand("FrontFace");
+}
+
+void NullRenderContext::RasterizationMode(RasterMode mode)
+{
+	_state.stats.stateChanges++;
+	LogCommand("RasterizationMode");
+}
+
+void NullRenderContext::EnableRasterizerDiscard(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableRasterizerDiscard");
+}
+
+void NullRenderContext::LineWidth(float width)
+{
+	_state.stats.stateChanges++;
+	LogCommand("LineWidth");
+}
+
+void NullRenderContext::EnableLineAntialiasing(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableLineAntialiasing");
+}
+
+void NullRenderContext::EnableMultisampling(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableMultisampling");
+}
+
+void NullRenderContext::EnableSampleAlphaToCoverage(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableSampleAlphaToCoverage");
+}
+
+void NullRenderContext::EnableSampleAlphaToOne(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableSampleAlphaToOne");
+}
+
+void NullRenderContext::EnableSampleCoverage(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableSampleCoverage");
+}
+
+void NullRenderContext::EnableSampleShading(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableSampleShading");
+}
+
+void NullRenderContext::SampleCoverage(float value, bool invert)
+{
+	_state.stats.stateChanges++;
+	LogCommand("SampleCoverage");
+}
+
+void NullRenderContext::SampleMask(uint index, uint mask)
+{
+	_state.stats.stateChanges++;
+	LogCommand("SampleMask");
+}
+
+void NullRenderContext::GetSamplePosition(uint index, float position[2])
+{
+	position[0] = position[1] = 0.5f;
+}
+
+void NullRenderContext::MinSampleShading(float value)
+{
+	_state.stats.stateChanges++;
+	LogCommand("MinSampleShading");
+}
+
+void NullRenderContext::EnableScissorTest(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableScissorTest");
+}
+
+void NullRenderContext::EnableScissorTestIndexed(uint index, bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableScissorTestIndexed");
+}
+
+void NullRenderContext::Scissor(int x, int y, int width, int height)
+{
+	_state.stats.stateChanges++;
+	LogCommand("Scissor");
+}
+
+void NullRenderContext::ScissorIndexed(uint index, int x, int y, int width, int height)
+{
+	_state.stats.stateChanges++;
+	LogCommand("ScissorIndexed");
+}
+
+void NullRenderContext::EnableDepthTest(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableDepthTest");
+}
+
+void NullRenderContext::DepthTestFunc(CompareFunc func)
+{
+	_state.stats.stateChanges++;
+	LogCommand("DepthTestFunc");
+}
+
+void NullRenderContext::DepthRange(float dnear, float dfar)
+{
+	_state.stats.stateChanges++;
+	LogCommand("DepthRange");
+}
+
+void NullRenderContext::DepthRangeIndexed(uint index, float dnear, float dfar)
+{
+	_state.stats.stateChanges++;
+	LogCommand("DepthRangeIndexed");
+}
+
+void NullRenderContext::DepthOffset(float factor, float units)
+{
+	_state.stats.stateChanges++;
+	LogCommand("DepthOffset");
+}
+
+void NullRenderContext::EnableDepthClamp(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableDepthClamp");
+}
+
+void NullRenderContext::EnableStencilTest(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableStencilTest");
+}
+
+void NullRenderContext::StencilTestFunc(PolygonFace face, CompareFunc func, int ref, uint mask)
+{
+	_state.stats.stateChanges++;
+	LogCommand("StencilTestFunc");
+}
+
+void NullRenderContext::StencilOperation(PolygonFace face, StencilOp stencil_fail, StencilOp depth_fail, StencilOp depth_pass)
+{
+	_state.stats.stateChanges++;
+	LogCommand("StencilOperation");
+}
+
+void NullRenderContext::EnableBlending(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableBlending");
+}
+
+void NullRenderContext::EnableBlending(uint buffer, bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableBlending");
+}
+
+void NullRenderContext::BlendingColor(const float color[4])
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingColor");
+}
+
+void NullRenderContext::BlendingFunc(BlendFunc src_factor, BlendFunc dest_factor)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingFunc");
+}
+
+void NullRenderContext::BlendingFunc(BlendFunc src_rgb_factor, BlendFunc dest_rgb_factor, BlendFunc src_alpha_factor, BlendFunc dest_alpha_factor)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingFunc");
+}
+
+void NullRenderContext::BlendingFunc(uint buffer, BlendFunc src_factor, BlendFunc dest_factor)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingFunc");
+}
+
+void NullRenderContext::BlendingFunc(uint buffer, BlendFunc src_rgb_factor, BlendFunc dest_rgb_factor, BlendFunc src_alpha_factor, BlendFunc dest_alpha_factor)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingFunc");
+}
+
+void NullRenderContext::BlendingOperation(BlendOp op)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingOperation");
+}
+
+void NullRenderContext::BlendingOperation(BlendOp op_rgb, BlendOp op_alpha)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingOperation");
+}
+
+void NullRenderContext::BlendingOperation(uint buffer, BlendOp op)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingOperation");
+}
+
+void NullRenderContext::BlendingOperation(uint buffer, BlendOp op_rgb, BlendOp op_alpha)
+{
+	_state.stats.stateChanges++;
+	LogCommand("BlendingOperation");
+}
+
+void NullRenderContext::EnableLogicOperation(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableLogicOperation");
+}
+
+void NullRenderContext::LogicOperation(LogicOp op)
+{
+	_state.stats.stateChanges++;
+	LogCommand("LogicOperation");
+}
+
+void NullRenderContext::SetFramebuffer(IFramebuffer* fbuf)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetFramebuffer");
+}
+
+void NullRenderContext::ActiveColorBuffers(IFramebuffer* fbuf, const ColorBuffer* buffers, sizei count)
+{
+	_state.stats.stateChanges++;
+	LogCommand("ActiveColorBuffers");
+}
+
+void NullRenderContext::EnableFramebufferSRGB(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableFramebufferSRGB");
+}
+
+void NullRenderContext::EnableColorWrite(bool r, bool g, bool b, bool a)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableColorWrite");
+}
+
+void NullRenderContext::EnableColorWrite(uint buffer, bool r, bool g, bool b, bool a)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableColorWrite");
+}
+
+void NullRenderContext::EnableDepthWrite(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableDepthWrite");
+}
+
+void NullRenderContext::EnableStencilWrite(PolygonFace face, uint mask)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableStencilWrite");
+}
+
+void NullRenderContext::ClearColorBuffer(IFramebuffer* fbuf, uint buffer, const float color[4])
+{
+	_state.stats.clears++;
+	LogCommand("ClearColorBuffer");
+}
+
+void NullRenderContext::ClearColorBuffer(IFramebuffer* fbuf, uint buffer, const int color[4])
+{
+	_state.stats.clears++;
+	LogCommand("ClearColorBuffer");
+}
+
+void NullRenderContext::ClearColorBuffer(IFramebuffer* fbuf, uint buffer, const uint color[4])
+{
+	_state.stats.clears++;
+	LogCommand("ClearColorBuffer");
+}
+
+void NullRenderContext::ClearDepthBuffer(IFramebuffer* fbuf, float depth)
+{
+	_state.stats.clears++;
+	LogCommand("ClearDepthBuffer");
+}
+
+void NullRenderContext::ClearStencilBuffer(IFramebuffer* fbuf, int stencil)
+{
+	_state.stats.clears++;
+	LogCommand("ClearStencilBuffer");
+}
+
+void NullRenderContext::ClearDepthStencilBuffer(IFramebuffer* fbuf, float depth, int stencil)
+{
+	_state.stats.clears++;
+	LogCommand("ClearDepthStencilBuffer");
+}
+
+void NullRenderContext::ReadPixels(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, ColorReadClamp color_clamp, int x, int y, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, void* buffer)
+{
+	LogCommand("ReadPixels");
+}
+
+void NullRenderContext::ReadPixels(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, ColorReadClamp color_clamp, int x, int y, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset)
+{
+	LogCommand("ReadPixels");
+}
+
+void NullRenderContext::BlitFramebuffer(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int src_x0, int src_y0, int src_x1, int src_y1, IFramebuffer* dest_fbuf, int dest_x0, int dest_y0, int dest_x1, int dest_y1, uint buffers, TexFilter filter)
+{
+	LogCommand("BlitFramebuffer");
+}
+
+void NullRenderContext::SwapBuffers()
+{
+	_state.stats.frames++;
+	LogCommand("SwapBuffers");
+}
+
+void NullRenderContext::SwapInterval(int interval)
+{
+	_state.stats.stateChanges++;
+	LogCommand("SwapInterval");
+}
+
+void NullRenderContext::SetVertexShader(IVertexShader* shader)
+{
+	_state.stats.shaderChanges++;
+	LogCommand("SetVertexShader");
+}
+
+void NullRenderContext::SetTessControlShader(ITessControlShader* shader)
+{
+	_state.stats.shaderChanges++;
+	LogCommand("SetTessControlShader");
+}
+
+void NullRenderContext::SetTessEvaluationShader(ITessEvaluationShader* shader)
+{
+	_state.stats.shaderChanges++;
+	LogCommand("SetTessEvaluationShader");
+}
+
+void NullRenderContext::SetGeometryShader(IGeometryShader* shader)
+{
+	_state.stats.shaderChanges++;
+	LogCommand("SetGeometryShader");
+}
+
+void NullRenderContext::SetFragmentShader(IFragmentShader* shader)
+{
+	_state.stats.shaderChanges++;
+	LogCommand("SetFragmentShader");
+}
+
+void NullRenderContext::SetComputeShader(IComputeShader* shader)
+{
+	_state.stats.shaderChanges++;
+	LogCommand("SetComputeShader");
+}
+
+void NullRenderContext::SetUniformBuffer(uint index, IBuffer* buffer)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetUniformBuffer");
+}
+
+void NullRenderContext::SetUniformBuffer(uint index, IBuffer* buffer, intptr offset, sizeiptr size)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetUniformBuffer");
+}
+
+void NullRenderContext::SetAtomicCounterBuffer(uint index, IBuffer* buffer)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetAtomicCounterBuffer");
+}
+
+void NullRenderContext::SetAtomicCounterBuffer(uint index, IBuffer* buffer, intptr offset, sizeiptr size)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetAtomicCounterBuffer");
+}
+
+void NullRenderContext::SetStorageBuffer(uint index, IBuffer* buffer)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetStorageBuffer");
+}
+
+void NullRenderContext::SetStorageBuffer(uint index, IBuffer* buffer, intptr offset, sizeiptr size)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetStorageBuffer");
+}
+
+void NullRenderContext::UniformSubroutine(ShaderType shader_type, sizei count, const uint* indices)
+{
+	LogCommand("UniformSubroutine");
+}
+
+void NullRenderContext::SetImageTexture(uint image_unit, ITexture* texture, int level, bool layered, int layer, BufferAccess access, PixelFormat format)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetImageTexture");
+}
+
+bool NullRenderContext::ValidateShaderPipeline()
+{
+	return true;
+}
+
+void NullRenderContext::SetSamplerTexture(int sampler, ITexture* texture)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetSamplerTexture");
+}
+
+void NullRenderContext::SetSamplerState(int sampler, ISamplerState* state)
+{
+	_state.stats.resourceBindings++;
+	LogCommand("SetSamplerState");
+}
+
+void NullRenderContext::EnableSeamlessCubeMap(bool enable)
+{
+	_state.stats.stateChanges++;
+	LogCommand("EnableSeamlessCubeMap");
+}
+
+void NullRenderContext::Draw(PrimitiveType prim, int first, sizei count)
+{
+	CountDraw(count, 1);
+	LogCommand("Draw %d", count);
+}
+
+void NullRenderContext::DrawInstanced(PrimitiveType prim, int first, sizei count, uint base_inst, sizei inst_count)
+{
+	CountDraw(count, inst_count);
+	LogCommand("DrawInstanced %d x%d", count, inst_count);
+}
+
+void NullRenderContext::DrawIndirect(PrimitiveType prim, IBuffer* buffer, intptr offset)
+{
+	CountIndirectDraws(buffer, offset, 1, 0, false);
+	LogCommand("DrawIndirect");
+}
+
+void NullRenderContext::MultiDrawIndirect(PrimitiveType prim, IBuffer* buffer, intptr offset, sizei count, sizei stride)
+{
+	CountIndirectDraws(buffer, offset, count, stride, false);
+	LogCommand("MultiDrawIndirect %d", count);
+}
+
+void NullRenderContext::DrawIndexed(PrimitiveType prim, intptr index_start, int base_vertex, sizei count)
+{
+	CountDraw(count, 1);
+	LogCommand("DrawIndexed %d", count);
+}
+
+void NullRenderContext::DrawIndexed(PrimitiveType prim, uint start, uint end, intptr index_start, int base_vertex, sizei count)
+{
+	CountDraw(count, 1);
+	LogCommand("DrawIndexed %d", count);
+}
+
+void NullRenderContext::DrawIndexedInstanced(PrimitiveType prim, intptr index_start, int base_vertex, sizei count, uint base_inst, sizei inst_count)
+{
+	CountDraw(count, inst_count);
+	LogCommand("DrawIndexedInstanced %d x%d", count, inst_count);
+}
+
+void NullRenderContext::DrawIndexedIndirect(PrimitiveType prim, IBuffer* buffer, intptr offset)
+{
+	CountIndirectDraws(buffer, offset, 1, 0, true);
+	LogCommand("DrawIndexedIndirect");
+}
+
+void NullRenderContext::MultiDrawIndexedIndirect(PrimitiveType prim, IBuffer* buffer, intptr offset, sizei count, sizei stride)
+{
+	CountIndirectDraws(buffer, offset, count, stride, true);
+	LogCommand("MultiDrawIndexedIndirect %d", count);
+}
+
+void NullRenderContext::DrawTransformFeedback(PrimitiveType prim, ITransformFeedback* transform_feedback, uint stream)
+{
+	CountDraw(0, 1);
+	LogCommand("DrawTransformFeedback");
+}
+
+void NullRenderContext::DrawTransformFeedbackInstanced(PrimitiveType prim, ITransformFeedback* transform_feedback, uint stream, sizei inst_count)
+{
+	CountDraw(0, inst_count);
+	LogCommand("DrawTransformFeedbackInstanced");
+}
+
+void NullRenderContext::DispatchCompute(uint num_groups_x, uint num_groups_y, uint num_groups_z)
+{
+	_state.stats.dispatches++;
+	LogCommand("DispatchCompute");
+}
+
+void NullRenderContext::DispatchComputeIndirect(IBuffer* buffer, intptr offset)
+{
+	_state.stats.dispatches++;
+	LogCommand("DispatchComputeIndirect");
+}
+
+void NullRenderContext::Flush()
+{
+	LogCommand("Flush");
+}
+
+void NullRenderContext::Finish()
+{
+	LogCommand("Finish");
+}
+
+SyncObject NullRenderContext::InsertFenceSync(FenceSyncCondition condition, uint flags)
+{
+	// Commands complete immediately, so any non-null handle works as an already signaled fence.
+	LogCommand("InsertFenceSync");
+	return reinterpret_cast<SyncObject>(++_lastSync);
+}
+
+void NullRenderContext::DeleteSync(SyncObject sync)
+{
+	LogCommand("DeleteSync");
+}
+
+SyncWaitStatus NullRenderContext::ClientWaitSync(SyncObject sync, uint flags, uint64 timeout)
+{
+	return SyncWaitStatus::AlreadySignaled;
+}
+
+void NullRenderContext::Wait(SyncObject sync, uint flags, uint64 timeout)
+{
+	LogCommand("Wait");
+}
+
+void NullRenderContext::MemoryBarrier(uint flags)
+{
+	LogCommand("MemoryBarrier");
+}
+
+void NullRenderContext::MemoryBarrierByRegion(uint flags)
+{
+	LogCommand("MemoryBarrierByRegion");
+}
+
+void NullRenderContext::TextureBarrier()
+{
+	LogCommand("TextureBarrier");
+}
+
+void NullRenderContext::CopyBufferData(IBuffer* source, intptr source_offset, IBuffer* dest, intptr dest_offset, sizeiptr size)
+{
+	LogCommand("CopyBufferData");
+}
+
+void NullRenderContext::CopyTextureData(ITexture* source, int source_level, int source_x, int source_y, int source_z, int width, int height, int depth, ITexture* dest, int dest_level, int dest_x, int dest_y, int dest_z)
+{
+	LogCommand("CopyTextureData");
+}
+
+void NullRenderContext::CopyRenderbufferData(IRenderbuffer* source, int source_x, int source_y, int width, int height, IRenderbuffer* dest, int dest_x, int dest_y)
+{
+	LogCommand("CopyRenderbufferData");
+}
+
+void NullRenderContext::GetViewport(int viewport[4])
+{
+	for (int i = 0; i < 4; ++i)
+		viewport[i] = _viewport[i];
+}
+
+void NullRenderContext::GetViewport(float viewport[4])
+{
+	for (int i = 0; i < 4; ++i)
+		viewport[i] = static_cast<float>(_viewport[i]);
+}
+
+void NullRenderContext::GetViewportIndexed(uint index, float viewport[4])
+{
+	GetViewport(viewport);
+}
+
+int64 NullRenderContext::GetGPUTimestamp()
+{
+	return 0;
+}
+
+bool NullRenderContext::GetTextureInternalFormatInfo(TextureType type, PixelFormat internal_format, InternalFormatInfo& info)
+{
+	return false;
+}
+
+bool NullRenderContext::GetRenderbufferInternalFormatInfo(PixelFormat internal_format, InternalFormatInfo& info)
+{
+	return false;
+}
+
+ErrorCode NullRenderContext::GetLastError()
+{
+	return ErrorCode::None;
+}
+
+IVertexFormat* NullRenderContext::CreateVertexFormat(const VertexAttribDesc* descriptors, int count)
+{
+	return CreateObject<NullVertexFormat>();
+}
+
+void NullRenderContext::DestroyVertexFormat(IVertexFormat* vert_fmt)
+{
+	DestroyObject(vert_fmt, "DestroyVertexFormat");
+}
+
+ISamplerState* NullRenderContext::CreateSamplerState(const SamplerStateDesc& descriptor)
+{
+	return CreateObject<NullSamplerState>();
+}
+
+void NullRenderContext::DestroySamplerState(ISamplerState* samp_state)
+{
+	DestroyObject(samp_state, "DestroySamplerState");
+}
+
+ITexture1D* NullRenderContext::CreateTexture1D(sizei levels, PixelFormat internal_format, int width)
+{
+	return CreateObject<NullTexture1D>(levels, internal_format, width, 1, 1);
+}
+
+ITexture1D* NullRenderContext::CreateTexture1DView(ITexture1D* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture1D>(num_levels, internal_format, orig_tex->GetWidth(), 1, 1);
+}
+
+ITexture1D* NullRenderContext::CreateTexture1DView(ITexture1DArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint layer)
+{
+	return CreateObject<NullTexture1D>(num_levels, internal_format, orig_tex->GetWidth(), 1, 1);
+}
+
+ITexture1DArray* NullRenderContext::CreateTexture1DArray(sizei levels, PixelFormat internal_format, int width, int height)
+{
+	return CreateObject<NullTexture1DArray>(levels, internal_format, width, height, 1);
+}
+
+ITexture1DArray* NullRenderContext::CreateTexture1DArrayView(ITexture1D* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture1DArray>(num_levels, internal_format, orig_tex->GetWidth(), 1, 1);
+}
+
+ITexture1DArray* NullRenderContext::CreateTexture1DArrayView(ITexture1DArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTexture1DArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), static_cast<int>(num_layers));
+}
+
+ITexture2D* NullRenderContext::CreateTexture2D(sizei levels, PixelFormat internal_format, int width, int height)
+{
+	return CreateObject<NullTexture2D>(levels, internal_format, width, height, 1);
+}
+
+ITexture2D* NullRenderContext::CreateTexture2DView(ITexture2D* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture2D>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 1);
+}
+
+ITexture2D* NullRenderContext::CreateTexture2DView(ITexture2DArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint layer)
+{
+	return CreateObject<NullTexture2D>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 1);
+}
+
+ITexture2D* NullRenderContext::CreateTexture2DView(ITextureCube* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint layer)
+{
+	return CreateObject<NullTexture2D>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), 1);
+}
+
+ITexture2D* NullRenderContext::CreateTexture2DView(ITextureCubeArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint layer)
+{
+	return CreateObject<NullTexture2D>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), 1);
+}
+
+ITexture2DArray* NullRenderContext::CreateTexture2DArray(sizei levels, PixelFormat internal_format, int width, int height, int depth)
+{
+	return CreateObject<NullTexture2DArray>(levels, internal_format, width, height, depth);
+}
+
+ITexture2DArray* NullRenderContext::CreateTexture2DArrayView(ITexture2D* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture2DArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 1);
+}
+
+ITexture2DArray* NullRenderContext::CreateTexture2DArrayView(ITexture2DArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTexture2DArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), static_cast<int>(num_layers));
+}
+
+ITexture2DArray* NullRenderContext::CreateTexture2DArrayView(ITextureCube* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTexture2DArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), static_cast<int>(num_layers));
+}
+
+ITexture2DArray* NullRenderContext::CreateTexture2DArrayView(ITextureCubeArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTexture2DArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), static_cast<int>(num_layers));
+}
+
+ITexture2DMultisample* NullRenderContext::CreateTexture2DMultisample(int samples, PixelFormat internal_format, int width, int height, bool fixed_sample_locations)
+{
+	return CreateObject<NullTexture2DMultisample>(1, internal_format, width, height, 1);
+}
+
+ITexture2DMultisample* NullRenderContext::CreateTexture2DMultisampleView(ITexture2DMultisample* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture2DMultisample>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 1);
+}
+
+ITexture2DMultisample* NullRenderContext::CreateTexture2DMultisampleView(ITexture2DMultisampleArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture2DMultisample>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 1);
+}
+
+ITexture2DMultisampleArray* NullRenderContext::CreateTexture2DMultisampleArray(int samples, PixelFormat internal_format, int width, int height, int depth, bool fixed_sample_locations)
+{
+	return CreateObject<NullTexture2DMultisampleArray>(1, internal_format, width, height, depth);
+}
+
+ITexture2DMultisampleArray* NullRenderContext::CreateTexture2DMultisampleArrayView(ITexture2DMultisample* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture2DMultisampleArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 1);
+}
+
+ITexture2DMultisampleArray* NullRenderContext::CreateTexture2DMultisampleArrayView(ITexture2DMultisampleArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTexture2DMultisampleArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), static_cast<int>(num_layers));
+}
+
+ITexture3D* NullRenderContext::CreateTexture3D(sizei levels, PixelFormat internal_format, int width, int height, int depth)
+{
+	return CreateObject<NullTexture3D>(levels, internal_format, width, height, depth);
+}
+
+ITexture3D* NullRenderContext::CreateTexture3DView(ITexture3D* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTexture3D>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), orig_tex->GetDepth());
+}
+
+ITextureCube* NullRenderContext::CreateTextureCube(sizei levels, PixelFormat internal_format, int width)
+{
+	return CreateObject<NullTextureCube>(levels, internal_format, width, width, 6);
+}
+
+ITextureCube* NullRenderContext::CreateTextureCubeView(ITextureCube* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTextureCube>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), 6);
+}
+
+ITextureCube* NullRenderContext::CreateTextureCubeView(ITextureCubeArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTextureCube>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), 6);
+}
+
+ITextureCube* NullRenderContext::CreateTextureCubeView(ITexture2DArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTextureCube>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 6);
+}
+
+ITextureCubeArray* NullRenderContext::CreateTextureCubeArray(sizei levels, PixelFormat internal_format, int width, int depth)
+{
+	return CreateObject<NullTextureCubeArray>(levels, internal_format, width, width, depth);
+}
+
+ITextureCubeArray* NullRenderContext::CreateTextureCubeArrayView(ITextureCube* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTextureCubeArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), static_cast<int>(num_layers));
+}
+
+ITextureCubeArray* NullRenderContext::CreateTextureCubeArrayView(ITextureCubeArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTextureCubeArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetWidth(), static_cast<int>(num_layers));
+}
+
+ITextureCubeArray* NullRenderContext::CreateTextureCubeArrayView(ITexture2DArray* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels, uint min_layer, uint num_layers)
+{
+	return CreateObject<NullTextureCubeArray>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), static_cast<int>(num_layers));
+}
+
+ITextureBuffer* NullRenderContext::CreateTextureBuffer()
+{
+	return CreateObject<NullTextureBuffer>(1, PixelFormat::None, 0, 1, 1);
+}
+
+ITextureRectangle* NullRenderContext::CreateTextureRectangle(sizei levels, PixelFormat internal_format, int width, int height)
+{
+	return CreateObject<NullTextureRectangle>(levels, internal_format, width, height, 1);
+}
+
+ITextureRectangle* NullRenderContext::CreateTextureRectangleView(ITextureRectangle* orig_tex, PixelFormat internal_format, uint min_level, uint num_levels)
+{
+	return CreateObject<NullTextureRectangle>(num_levels, internal_format, orig_tex->GetWidth(), orig_tex->GetHeight(), 1);
+}
+
+void NullRenderContext::DestroyTexture(ITexture* texture)
+{
+	DestroyObject(texture, "DestroyTexture");
+}
+
+IBuffer* NullRenderContext::CreateBuffer(sizeiptr size, const void* data, uint flags)
+{
+	return CreateObject<NullBuffer>(size, data);
+}
+
+void NullRenderContext::DestroyBuffer(IBuffer* buffer)
+{
+	DestroyObject(buffer, "DestroyBuffer");
+}
+
+IFramebuffer* NullRenderContext::CreateFramebuffer()
+{
+	return CreateObject<NullFramebuffer>();
+}
+
+IFramebuffer* NullRenderContext::CreateFramebufferWithoutAttachments(const FramebufferParams& params)
+{
+	return CreateObject<NullFramebuffer>();
+}
+
+void NullRenderContext::DestroyFramebuffer(IFramebuffer* framebuffer)
+{
+	DestroyObject(framebuffer, "DestroyFramebuffer");
+}
+
+IRenderbuffer* NullRenderContext::CreateRenderbuffer(sizei samples, gls::PixelFormat internal_format, sizei width, sizei height)
+{
+	return CreateObject<NullRenderbuffer>();
+}
+
+void NullRenderContext::DestroyRenderbuffer(IRenderbuffer* renderbuffer)
+{
+	DestroyObject(renderbuffer, "DestroyRenderbuffer");
+}
+
+IQuery* NullRenderContext::CreateQuery()
+{
+	return CreateObject<NullQuery>();
+}
+
+void NullRenderContext::DestroyQuery(IQuery* query)
+{
+	DestroyObject(query, "DestroyQuery");
+}
+
+IVertexShader* NullRenderContext::CreateVertexShader(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullVertexShader>();
+}
+
+IVertexShader* NullRenderContext::CreateVertexShader(sizei size, const void* binary, uint format, bool& success)
+{
+	success = true;
+	return CreateObject<NullVertexShader>();
+}
+
+IVertexShader* NullRenderContext::CreateVertexShaderAsync(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullVertexShader>();
+}
+
+IVertexShader* NullRenderContext::CreateVertexShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullVertexShader>();
+}
+
+IVertexShader* NullRenderContext::CreateVertexShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullVertexShader>();
+}
+
+ITessControlShader* NullRenderContext::CreateTessControlShader(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessControlShader>();
+}
+
+ITessControlShader* NullRenderContext::CreateTessControlShader(sizei size, const void* binary, uint format, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessControlShader>();
+}
+
+ITessControlShader* NullRenderContext::CreateTessControlShaderAsync(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessControlShader>();
+}
+
+ITessControlShader* NullRenderContext::CreateTessControlShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessControlShader>();
+}
+
+ITessControlShader* NullRenderContext::CreateTessControlShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessControlShader>();
+}
+
+ITessEvaluationShader* NullRenderContext::CreateTessEvaluationShader(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessEvaluationShader>();
+}
+
+ITessEvaluationShader* NullRenderContext::CreateTessEvaluationShader(sizei size, const void* binary, uint format, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessEvaluationShader>();
+}
+
+ITessEvaluationShader* NullRenderContext::CreateTessEvaluationShaderAsync(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessEvaluationShader>();
+}
+
+ITessEvaluationShader* NullRenderContext::CreateTessEvaluationShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessEvaluationShader>();
+}
+
+ITessEvaluationShader* NullRenderContext::CreateTessEvaluationShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullTessEvaluationShader>();
+}
+
+IGeometryShader* NullRenderContext::CreateGeometryShader(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullGeometryShader>();
+}
+
+IGeometryShader* NullRenderContext::CreateGeometryShader(sizei size, const void* binary, uint format, bool& success)
+{
+	success = true;
+	return CreateObject<NullGeometryShader>();
+}
+
+IGeometryShader* NullRenderContext::CreateGeometryShaderAsync(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullGeometryShader>();
+}
+
+IGeometryShader* NullRenderContext::CreateGeometryShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullGeometryShader>();
+}
+
+IGeometryShader* NullRenderContext::CreateGeometryShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success)
+{
+	success = true;
+	return CreateObject<NullGeometryShader>();
+}
+
+IFragmentShader* NullRenderContext::CreateFragmentShader(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullFragmentShader>();
+}
+
+IFragmentShader* NullRenderContext::CreateFragmentShader(sizei size, const void* binary, uint format, bool& success)
+{
+	success = true;
+	return CreateObject<NullFragmentShader>();
+}
+
+IFragmentShader* NullRenderContext::CreateFragmentShaderAsync(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullFragmentShader>();
+}
+
+IComputeShader* NullRenderContext::CreateComputeShader(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullComputeShader>();
+}
+
+IComputeShader* NullRenderContext::CreateComputeShader(sizei size, const void* binary, uint format, bool& success)
+{
+	success = true;
+	return CreateObject<NullComputeShader>();
+}
+
+IComputeShader* NullRenderContext::CreateComputeShaderAsync(sizei count, const char** source, bool& success)
+{
+	success = true;
+	return CreateObject<NullComputeShader>();
+}
+
+void NullRenderContext::DestroyShader(IShader* shader)
+{
+	DestroyObject(shader, "DestroyShader");
+}
+
+ITransformFeedback* NullRenderContext::CreateTransformFeedback()
+{
+	return CreateObject<NullTransformFeedback>();
+}
+
+void NullRenderContext::DestroyTransformFeedback(ITransformFeedback* transform_feedback)
+{
+	DestroyObject(transform_feedback, "DestroyTransformFeedback");
+}
+
+void NullRenderContext::EnableDebugOutput(bool enable, bool synchronous)
+{
+	LogCommand("EnableDebugOutput");
+}
+
+void NullRenderContext::EnableDebugMessages(DebugMessageSource source, DebugMessageType type, DebugMessageSeverity severity, bool enable)
+{
+	LogCommand("EnableDebugMessages");
+}
+
+void NullRenderContext::EnableDebugMessages(DebugMessageSource source, DebugMessageType type, uint id_count, uint* ids, bool enable)
+{
+	LogCommand("EnableDebugMessages");
+}
+
+void NullRenderContext::EnableDebugMessage(DebugMessageSource source, DebugMessageType type, uint id, bool enable)
+{
+	LogCommand("EnableDebugMessage");
+}
+
+void NullRenderContext::InsertDebugMessage(DebugMessageSource source, DebugMessageType type, uint id, DebugMessageSeverity severity, const char* message)
+{
+	LogCommand("InsertDebugMessage");
+}
+
+void NullRenderContext::PushDebugGroup(DebugMessageSource source, uint id, const char* message)
+{
+	_debugGroupDepth++;
+	LogCommand("PushDebugGroup %s", message);
+}
+
+void NullRenderContext::PopDebugGroup()
+{
+	if (_debugGroupDepth > 0)
+		_debugGroupDepth--;
+	LogCommand("PopDebugGroup");
+}
+
+int NullRenderContext::GetDebugGroupStackDepth()
+{
+	return _debugGroupDepth;
+}
+
+void NullRenderContext::ResourceDebugLabel(IResource* resource, const char* label)
+{
+	LogCommand("ResourceDebugLabel");
+}
+
+void NullRenderContext::SyncObjectDebugLabel(SyncObject sync_object, const char* label)
+{
+	LogCommand("SyncObjectDebugLabel");
+}
+
+} // namespace gls::internals
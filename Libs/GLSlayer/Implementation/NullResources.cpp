@@ -0,0 +1,189 @@
+#include "NullResources.h"
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+
+
+namespace gls::internals
+{
+
+void NullState::LogCommand(const char* format, ...)
+{
+	if (commandLogger)
+	{
+		va_list args;
+		va_start(args, format);
+
+		char buf[256];
+		vsnprintf(buf, sizeof(buf), format, args);
+
+		va_end(args);
+
+		commandLogger->LogCommand(buf);
+	}
+}
+
+uint64 GetImageDataSize(ImageFormat format, DataType type, int width, int height, int depth)
+{
+	int numComponents;
+	switch (format)
+	{
+	case ImageFormat::Depth:
+	case ImageFormat::Stencil:
+	case ImageFormat::Red:
+	case ImageFormat::Green:
+	case ImageFormat::Blue:
+	case ImageFormat::RedInteger:
+	case ImageFormat::GreenInteger:
+	case ImageFormat::BlueInteger:
+		numComponents = 1;
+		break;
+	case ImageFormat::DepthStencil:
+	case ImageFormat::RG:
+	case ImageFormat::RG_Integer:
+		numComponents = 2;
+		break;
+	case ImageFormat::RGB:
+	case ImageFormat::BGR:
+	case ImageFormat::RGB_Integer:
+	case ImageFormat::BGR_Integer:
+		numComponents = 3;
+		break;
+	case ImageFormat::RGBA:
+	case ImageFormat::BGRA:
+	case ImageFormat::RGBA_Integer:
+	case ImageFormat::BGRA_Integer:
+		numComponents = 4;
+		break;
+	default:
+		numComponents = 0;
+	}
+
+	// Packed types hold the whole pixel, the others a single component.
+	int pixelSize;
+	switch (type)
+	{
+	case DataType::UnsignedByte:
+	case DataType::Byte:
+		pixelSize = numComponents;
+		break;
+	case DataType::UnsignedShort:
+	case DataType::Short:
+	case DataType::HalfFloat:
+		pixelSize = numComponents * 2;
+		break;
+	case DataType::UnsignedInt:
+	case DataType::Int:
+	case DataType::Float:
+	case DataType::Fixed:
+		pixelSize = numComponents * 4;
+		break;
+	case DataType::Double:
+		pixelSize = numComponents * 8;
+		break;
+	case DataType::UnsignedByte_3_3_2:
+	case DataType::UnsignedByte_2_3_2_Rev:
+		pixelSize = 1;
+		break;
+	case DataType::UnsignedShort_5_6_5:
+	case DataType::UnsignedShort_5_6_5_Rev:
+	case DataType::UnsignedShort_4_4_4_4:
+	case DataType::UnsignedShort_4_4_4_4_Rev:
+	case DataType::UnsignedShort_5_5_5_1:
+	case DataType::UnsignedShort_1_5_5_5_Rev:
+		pixelSize = 2;
+		break;
+	case DataType::Float_32_UnsignedInt_24_8_Rev:
+		pixelSize = 8;
+		break;
+	case DataType::None:
+		pixelSize = 0;
+		break;
+	default:
+		pixelSize = 4;
+	}
+
+	return static_cast<uint64>(width) * height * depth * pixelSize;
+}
+
+
+NullBuffer::NullBuffer(NullState* state, sizeiptr size, const void* data) :
+	NullResource(state),
+	_data(size)
+{
+	if (data)
+		memcpy(_data.data(), data, size);
+	_state->stats.liveBufferBytes += size;
+}
+
+NullBuffer::~NullBuffer()
+{
+	_state->stats.liveBufferBytes -= _data.size();
+}
+
+void NullBuffer::BufferSubData(intptr offset, sizeiptr size, const void* data)
+{
+	if (offset >= 0 && size >= 0 && offset + size <= GetSize() && data)
+		memcpy(_data.data() + offset, data, size);
+	_state->stats.bufferBytesUploaded += size;
+	_state->LogCommand("BufferSubData %td %td", offset, size);
+}
+
+void NullBuffer::GetBufferSubData(intptr offset, sizeiptr size, void* data)
+{
+	if (offset >= 0 && size >= 0 && offset + size <= GetSize() && data)
+		memcpy(data, _data.data() + offset, size);
+	_state->LogCommand("GetBufferSubData %td %td", offset, size);
+}
+
+void* NullBuffer::Map(uint map_flags)
+{
+	return MapRange(0, GetSize(), map_flags);
+}
+
+void* NullBuffer::MapRange(intptr offset, sizeiptr length, uint map_flags)
+{
+	if (offset < 0 || length < 0 || offset + length > GetSize())
+		return nullptr;
+
+	// Bytes written through a mapping can't be observed, so the whole range counts as uploaded.
+	if (map_flags & MAP_WRITE_BIT)
+		_state->stats.bufferBytesUploaded += length;
+	_state->LogCommand("MapRange %td %td", offset, length);
+	return _data.data() + offset;
+}
+
+void NullBuffer::FlushMappedRange(intptr offset, sizeiptr length)
+{
+	_state->LogCommand("FlushMappedRange %td %td", offset, length);
+}
+
+bool NullBuffer::Unmap()
+{
+	_state->LogCommand("Unmap");
+	return true;
+}
+
+void NullBuffer::ClearData(PixelFormat internal_format, ImageFormat format, DataType type, const void* data)
+{
+	_state->stats.bufferBytesUploaded += GetSize();
+	_state->LogCommand("ClearData");
+}
+
+void NullBuffer::ClearSubData(PixelFormat internal_format, ImageFormat format, DataType type, intptr offset, sizeiptr size, const void* data)
+{
+	_state->stats.bufferBytesUploaded += size;
+	_state->LogCommand("ClearSubData %td %td", offset, size);
+}
+
+void NullBuffer::InvalidateData()
+{
+	_state->LogCommand("InvalidateData");
+}
+
+void NullBuffer::InvalidateSubData(intptr offset, sizeiptr size)
+{
+	_state->LogCommand("InvalidateSubData %td %td", offset, size);
+}
+
+} // namespace gls::internals
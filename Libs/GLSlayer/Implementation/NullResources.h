@@ -0,0 +1,648 @@
+#ifndef _NULL_RESOURCES_H_
+#define _NULL_RESOURCES_H_
+
+#include <vector>
+#include "GLCommon.h"
+#include "GLSlayer/NullRenderContext.h"
+
+
+namespace gls::internals
+{
+
+// State shared by the null render context and the resources it creates.
+struct NullState
+{
+	RenderStats stats = {};
+	ICommandLogger* commandLogger = nullptr;
+
+	void LogCommand(const char* format, ...);
+};
+
+uint64 GetImageDataSize(ImageFormat format, DataType type, int width, int height, int depth);
+
+
+// Common base of all objects created by the null render context, so they can be tracked and deleted uniformly.
+class NullObject
+{
+public:
+	NullObject(NullState* state) : _state(state) { }
+	virtual ~NullObject() = default;
+
+	NullObject(const NullObject&) = delete;
+	NullObject& operator = (const NullObject&) = delete;
+
+protected:
+	NullState* _state;
+};
+
+template <class Interface, ResourceType ResType, int TypeID>
+class NullResource : public Interface, public NullObject
+{
+public:
+	using NullObject::NullObject;
+
+	virtual void* DynamicCast(int type_id) override { return (type_id == TypeID || type_id == TYPE_ID_RESOURCE) ? this : nullptr; }
+	virtual ResourceType GetType() const override { return ResType; }
+};
+
+
+class NullBuffer : public NullResource<IBuffer, ResourceType::Buffer, TYPE_ID_BUFFER>
+{
+public:
+	NullBuffer(NullState* state, sizeiptr size, const void* data);
+	~NullBuffer();
+
+	virtual void BufferSubData(intptr offset, sizeiptr size, const void* data) override;
+	virtual void GetBufferSubData(intptr offset, sizeiptr size, void* data) override;
+	virtual void* Map(uint map_flags) override;
+	virtual void* MapRange(intptr offset, sizeiptr length, uint map_flags) override;
+	virtual void FlushMappedRange(intptr offset, sizeiptr length) override;
+	virtual bool Unmap() override;
+	virtual void ClearData(PixelFormat internal_format, ImageFormat format, DataType type, const void* data) override;
+	virtual void ClearSubData(PixelFormat internal_format, ImageFormat format, DataType type, intptr offset, sizeiptr size, const void* data) override;
+	virtual void InvalidateData() override;
+	virtual void InvalidateSubData(intptr offset, sizeiptr size) override;
+
+	sizeiptr GetSize() const { return static_cast<sizeiptr>(_data.size()); }
+
+private:
+	std::vector<char> _data;	// Kept so that mapped pointers are valid and reads return what was written.
+};
+
+
+template <class Interface, int TypeID, TextureType TexType>
+class NullTexture : public NullResource<Interface, ResourceType::Texture, TypeID>
+{
+public:
+	NullTexture(NullState* state, sizei levels, PixelFormat format, int width, int height, int depth) :
+		NullResource<Interface, ResourceType::Texture, TypeID>(state),
+		_format(format), _width(width), _height(height), _depth(depth), _maxLevel(levels > 0 ? levels - 1 : 0) { }
+
+	virtual TextureType GetTextureType() override { return TexType; }
+	virtual void GenerateMipmap() override { this->_state->LogCommand("GenerateMipmap"); }
+	virtual PixelFormat GetFormat() const override { return _format; }
+	virtual void SetBaseLevel(int base_level) override { _baseLevel = base_level; }
+	virtual int GetBaseLevel() const override { return _baseLevel; }
+	virtual void SetMaxLevel(int max_level) override { _maxLevel = max_level; }
+	virtual int GetMaxLevel() const override { return _maxLevel; }
+	virtual bool IsCompressed() const override { return false; }
+	virtual int GetCompressedSize(int level) const override { return 0; }
+	virtual void ComponentSwizzle(TexSwizzleDest dest, TexSwizzleSource source) override { this->_state->LogCommand("ComponentSwizzle"); }
+	virtual void ComponentSwizzle(TexSwizzleSource source_red, TexSwizzleSource source_green, TexSwizzleSource source_blue, TexSwizzleSource source_alpha) override { this->_state->LogCommand("ComponentSwizzle"); }
+	virtual void DepthStencilMode(DepthStencilTexMode mode) override { this->_state->LogCommand("DepthStencilMode"); }
+
+protected:
+	using NullObject::_state;
+
+	void Upload(const char* command, ImageFormat format, DataType type, int width, int height, int depth, const void* pixels)
+	{
+		if (pixels)
+			_state->stats.textureBytesUploaded += GetImageDataSize(format, type, width, height, depth);
+		_state->LogCommand("%s %dx%dx%d", command, width, height, depth);
+	}
+
+	void UploadCompressed(sizei size, const void* pixels)
+	{
+		if (pixels)
+			_state->stats.textureBytesUploaded += size;
+		_state->LogCommand("CompressedTexSubImage %d", size);
+	}
+
+	PixelFormat _format;
+	int _width;
+	int _height;
+	int _depth;
+	int _baseLevel = 0;
+	int _maxLevel;
+	sizeiptr _bufferSize = 0;
+};
+
+class NullTexture1D : public NullTexture<ITexture1D, TYPE_ID_TEXTURE_1D, TextureType::Tex1D>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(int level, int xoffset, int width, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, 1, 1, pixels); }
+	virtual void TexSubImage(int level, int xoffset, int width, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CompressedTexSubImage(int level, int xoffset, int width, ImageFormat format, sizei size, const void* pixels) override
+		{ UploadCompressed(size, pixels); }
+	virtual void CopyTexImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, PixelFormat internal_format, int x, int y, int width) override
+		{ _state->LogCommand("CopyTexImage"); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, int xoffset, int x, int y, int width) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage(int level) override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int level, int xoffset, int width) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int width, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int width, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int width, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetCompressedTexImage(int level, void* pixels) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexImage(int level, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int width, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int width, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+};
+
+class NullTexture1DArray : public NullTexture<ITexture1DArray, TYPE_ID_TEXTURE_1D_ARRAY, TextureType::Tex1DArray>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, height, 1, pixels); }
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CompressedTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, sizei size, const void* pixels) override
+		{ UploadCompressed(size, pixels); }
+	virtual void CopyTexImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, PixelFormat internal_format, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexImage"); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, int xoffset, int yoffset, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage(int level) override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int level, int xoffset, int yoffset, int width, int height) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetCompressedTexImage(int level, void* pixels) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexImage(int level, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int width, int height, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int width, int height, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetHeight() const override
+		{ return _height; }
+};
+
+class NullTexture2D : public NullTexture<ITexture2D, TYPE_ID_TEXTURE_2D, TextureType::Tex2D>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, height, 1, pixels); }
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CompressedTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, sizei size, const void* pixels) override
+		{ UploadCompressed(size, pixels); }
+	virtual void CopyTexImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, PixelFormat internal_format, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexImage"); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, int xoffset, int yoffset, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage(int level) override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int level, int xoffset, int yoffset, int width, int height) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetCompressedTexImage(int level, void* pixels) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexImage(int level, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int width, int height, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int width, int height, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetHeight() const override
+		{ return _height; }
+};
+
+class NullTexture2DArray : public NullTexture<ITexture2DArray, TYPE_ID_TEXTURE_2D_ARRAY, TextureType::Tex2DArray>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, height, depth, pixels); }
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CompressedTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, sizei size, const void* pixels) override
+		{ UploadCompressed(size, pixels); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, int xoffset, int yoffset, int zoffset, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage(int level) override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetCompressedTexImage(int level, void* pixels) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexImage(int level, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetHeight() const override
+		{ return _height; }
+	virtual int GetDepth() const override
+		{ return _depth; }
+};
+
+class NullTexture2DMultisample : public NullTexture<ITexture2DMultisample, TYPE_ID_TEXTURE_2D_MULTISAMPLE, TextureType::Tex2DMultisample>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void InvalidateTexImage() override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int xoffset, int yoffset, int width, int height) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetHeight() const override
+		{ return _height; }
+};
+
+class NullTexture2DMultisampleArray : public NullTexture<ITexture2DMultisampleArray, TYPE_ID_TEXTURE_2D_MULTISAMPLE_ARRAY, TextureType::Tex2DMultisampleArray>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void InvalidateTexImage() override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int xoffset, int yoffset, int zoffset, int width, int height, int depth) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetHeight() const override
+		{ return _height; }
+	virtual int GetDepth() const override
+		{ return _depth; }
+};
+
+class NullTexture3D : public NullTexture<ITexture3D, TYPE_ID_TEXTURE_3D, TextureType::Tex3D>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, height, depth, pixels); }
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CompressedTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, sizei size, const void* pixels) override
+		{ UploadCompressed(size, pixels); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, int xoffset, int yoffset, int zoffset, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage(int level) override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetCompressedTexImage(int level, void* pixels) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexImage(int level, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual void GetCompressedTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetHeight() const override
+		{ return _height; }
+	virtual int GetDepth() const override
+		{ return _depth; }
+};
+
+class NullTextureCube : public NullTexture<ITextureCube, TYPE_ID_TEXTURE_CUBE, TextureType::TexCube>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(CubeFace face, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, height, 1, pixels); }
+	virtual void TexSubImage(CubeFace face, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CompressedTexSubImage(CubeFace face, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, sizei size, const void* pixels) override
+		{ UploadCompressed(size, pixels); }
+	virtual void CopyTexImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, CubeFace face, int level, PixelFormat internal_format, int x, int y, int width) override
+		{ _state->LogCommand("CopyTexImage"); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, CubeFace face, int level, int xoffset, int yoffset, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage(int level) override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(CubeFace face, int level, int xoffset, int yoffset, int width, int height) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(CubeFace face, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(CubeFace face, int level, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(CubeFace face, int level, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(CubeFace face, int numFaces, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(CubeFace face, int numFaces, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetCompressedTexImage(CubeFace face, int level, void* pixels) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexImage(CubeFace face, int level, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetCompressedTexImage"); }
+	virtual void GetCompressedTexSubImage(CubeFace face, int numFaces, int level, int xoffset, int yoffset, int width, int height, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual void GetCompressedTexSubImage(CubeFace face, int numFaces, int level, int xoffset, int yoffset, int width, int height, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetCompressedTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+};
+
+class NullTextureCubeArray : public NullTexture<ITextureCubeArray, TYPE_ID_TEXTURE_CUBE_ARRAY, TextureType::TexCubeArray>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, height, depth, pixels); }
+	virtual void TexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CompressedTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, sizei size, const void* pixels) override
+		{ UploadCompressed(size, pixels); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int level, int xoffset, int yoffset, int zoffset, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage(int level) override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(int level, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(int layerFace, int numLayerFaces, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(int layerFace, int numLayerFaces, int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetDepth() const override
+		{ return _depth; }
+};
+
+class NullTextureBuffer : public NullTexture<ITextureBuffer, TYPE_ID_TEXTURE_BUFFER, TextureType::TexBuffer>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexBuffer(PixelFormat internal_format, IBuffer* buffer) override
+		{ _format = internal_format; _bufferSize = buffer ? static_cast<NullBuffer*>(buffer)->GetSize() : 0; _state->LogCommand("TexBuffer"); }
+	virtual void TexBufferRange(PixelFormat internal_format, IBuffer* buffer, intptr offset, sizeiptr size) override
+		{ _format = internal_format; _bufferSize = size; _state->LogCommand("TexBufferRange"); }
+	virtual void InvalidateTexImage() override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int xoffset, int yoffset, int width, int height) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual sizeiptr GetSize() const override
+		{ return _bufferSize; }
+};
+
+class NullTextureRectangle : public NullTexture<ITextureRectangle, TYPE_ID_TEXTURE_RECTANGLE, TextureType::TexRectangle>
+{
+public:
+	using NullTexture::NullTexture;
+
+	virtual void TexSubImage(int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, const void* pixels) override
+		{ Upload("TexSubImage", format, type, width, height, 1, pixels); }
+	virtual void TexSubImage(int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) override
+		{ _state->LogCommand("TexSubImage"); }
+	virtual void CopyTexImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, PixelFormat internal_format, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexImage"); }
+	virtual void CopyTexSubImage(IFramebuffer* source_fbuf, ColorBuffer source_color_buf, int xoffset, int yoffset, int x, int y, int width, int height) override
+		{ _state->LogCommand("CopyTexSubImage"); }
+	virtual void InvalidateTexImage() override
+		{ _state->LogCommand("InvalidateTexImage"); }
+	virtual void InvalidateTexSubImage(int xoffset, int yoffset, int width, int height) override
+		{ _state->LogCommand("InvalidateTexSubImage"); }
+	virtual void ClearTexImage(int level, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexImage"); }
+	virtual void ClearTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const void* data) override
+		{ _state->LogCommand("ClearTexSubImage"); }
+	virtual void GetTexImage(ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexImage(ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset) const override
+		{ _state->LogCommand("GetTexImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, void* pixels, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual void GetTexSubImage(int level, int xoffset, int yoffset, int width, int height, ImageFormat format, DataType type, const PixelStore* pixel_store, IBuffer* buffer, intptr buffer_offset, sizei bufferSize) const override
+		{ _state->LogCommand("GetTexSubImage"); }
+	virtual int GetWidth() const override
+		{ return _width; }
+	virtual int GetHeight() const override
+		{ return _height; }
+};
+
+
+template <class Interface, int TypeID, ShaderType ShType>
+class NullShader : public NullResource<Interface, ResourceType::Shader, TypeID>
+{
+public:
+	using NullResource<Interface, ResourceType::Shader, TypeID>::NullResource;
+
+	virtual ShaderType GetShaderType() override { return ShType; }
+	virtual const char* GetInfoLog() override { return ""; }
+	virtual int GetInfoLogLength() override { return 0; }
+	virtual bool Validate() override { return true; }
+	virtual uint GetSubroutineIndex(const char* name) override { return 0; }
+	virtual bool GetBinary(uint& format, sizei buffer_size, void* buffer) override { return false; }
+	virtual int GetBinarySize() override { return 0; }
+	virtual bool IsBuildComplete() override { return true; }
+	virtual bool GetBuildStatus() override { return true; }
+	virtual const ShaderBlockInfo* GetUniformBlockInfo(const char* blockName) override { return nullptr; }
+	virtual const ShaderBlockInfo* GetStorageBlockInfo(const char* blockName) override { return nullptr; }
+};
+
+class NullVertexShader : public NullShader<IVertexShader, TYPE_ID_VERTEX_SHADER, ShaderType::Vertex>
+{
+public:
+	using NullShader::NullShader;
+
+	virtual void TransformFeedbackVaryings(sizei count, const char** varyings, TransformFeedbackBufferMode mode) override { }
+};
+
+class NullTessControlShader : public NullShader<ITessControlShader, TYPE_ID_TESS_CONTROL_SHADER, ShaderType::TessControl>
+{
+public:
+	using NullShader::NullShader;
+
+	virtual int GetOutputVertexCount() override { return 0; }
+};
+
+class NullTessEvaluationShader : public NullShader<ITessEvaluationShader, TYPE_ID_TESS_EVAL_SHADER, ShaderType::TessEvaluation>
+{
+public:
+	using NullShader::NullShader;
+
+	virtual TessGenPrimitiveType GetMode() override { return TessGenPrimitiveType::Triangles; }
+	virtual TessGenSpacing GetSpacing() override { return TessGenSpacing::Equal; }
+	virtual VertexWinding GetVertexOrder() override { return VertexWinding::Counterclockwise; }
+	virtual bool GetPointMode() override { return false; }
+};
+
+class NullGeometryShader : public NullShader<IGeometryShader, TYPE_ID_GEOMETRY_SHADER, ShaderType::Geometry>
+{
+public:
+	using NullShader::NullShader;
+
+	virtual int GetInvocations() override { return 1; }
+	virtual void TransformFeedbackVaryings(sizei count, const char** varyings, TransformFeedbackBufferMode mode) override { }
+};
+
+class NullFragmentShader : public NullShader<IFragmentShader, TYPE_ID_FRAGMENT_SHADER, ShaderType::Fragment>
+{
+public:
+	using NullShader::NullShader;
+};
+
+class NullComputeShader : public NullShader<IComputeShader, TYPE_ID_COMPUTE_SHADER, ShaderType::Compute>
+{
+public:
+	using NullShader::NullShader;
+
+	virtual void GetWorkGroupSize(int work_group_size[3]) override { work_group_size[0] = work_group_size[1] = work_group_size[2] = 1; }
+};
+
+
+class NullFramebuffer : public NullResource<IFramebuffer, ResourceType::Framebuffer, TYPE_ID_FRAMEBUFFER>
+{
+public:
+	using NullResource::NullResource;
+
+	virtual void AttachTexture(AttachmentBuffer attachment, ITexture* texture, int level) override { _state->LogCommand("AttachTexture"); }
+	virtual void AttachTextureLayer(AttachmentBuffer attachment, ITexture* texture, int level, int layer) override { _state->LogCommand("AttachTextureLayer"); }
+	virtual void AttachTextureFace(AttachmentBuffer attachment, ITexture* texture, int level, CubeFace face) override { _state->LogCommand("AttachTextureFace"); }
+	virtual void AttachRenderbuffer(AttachmentBuffer attachment, IRenderbuffer* renderbuffer) override { _state->LogCommand("AttachRenderbuffer"); }
+	virtual FramebufferStatus CheckStatus() override { return FramebufferStatus::Complete; }
+	virtual void InvalidateFramebuffer(int num_attachments, const AttachmentBuffer* attachments) override { _state->LogCommand("InvalidateFramebuffer"); }
+	virtual void InvalidateSubFramebuffer(int num_attachments, const AttachmentBuffer* attachments, int x, int y, int width, int height) override { _state->LogCommand("InvalidateSubFramebuffer"); }
+};
+
+class NullRenderbuffer : public NullResource<IRenderbuffer, ResourceType::Renderbuffer, TYPE_ID_RENDERBUFFER>
+{
+public:
+	using NullResource::NullResource;
+};
+
+class NullSamplerState : public NullResource<ISamplerState, ResourceType::SamplerState, TYPE_ID_SAMPLER_STATE>
+{
+public:
+	using NullResource::NullResource;
+};
+
+class NullTransformFeedback : public NullResource<ITransformFeedback, ResourceType::TransformFeedback, TYPE_ID_TRANSFORM_FEEDBACK>
+{
+public:
+	using NullResource::NullResource;
+
+	virtual void BindBuffer(uint index, IBuffer* buffer) override { _state->LogCommand("BindBuffer %u", index); }
+	virtual void BindBuffer(uint index, IBuffer* buffer, intptr offset, sizeiptr size) override { _state->LogCommand("BindBuffer %u", index); }
+};
+
+class NullVertexFormat : public IVertexFormat, public NullObject
+{
+public:
+	using NullObject::NullObject;
+};
+
+// Queries complete immediately and return zero.
+class NullQuery : public IQuery, public NullObject
+{
+public:
+	using NullObject::NullObject;
+
+	virtual void BeginQuery(QueryType type) override { _type = type; _state->LogCommand("BeginQuery"); }
+	virtual void BeginQueryIndexed(QueryType type, uint index) override { _type = type; _state->LogCommand("BeginQueryIndexed"); }
+	virtual void EndQuery() override { _state->LogCommand("EndQuery"); }
+	virtual void QueryCounter(QueryType type) override { _type = type; _state->LogCommand("QueryCounter"); }
+	virtual bool ResultAvailable() override { return true; }
+	virtual uint GetResultUI() override { return 0; }
+	virtual uint GetResultNoWaitUI() override { return 0; }
+	virtual uint64 GetResultUI64() override { return 0; }
+	virtual uint64 GetResultNoWaitUI64() override { return 0; }
+	virtual QueryType GetQueryType() override { return _type; }
+
+private:
+	QueryType _type = QueryType::Undefined;
+};
+
+} // namespace gls::internals
+
+#endif // _NULL_RESOURCES_H_
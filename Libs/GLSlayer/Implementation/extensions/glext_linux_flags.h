@@ -117,4 +117,5 @@ struct FeaturesGL
 	bool EXT_texture_filter_anisotropic : 1;
 	bool EXT_texture_sRGB : 1;
 	bool EXT_texture_snorm : 1;
+	bool KHR_parallel_shader_compile : 1;
 };
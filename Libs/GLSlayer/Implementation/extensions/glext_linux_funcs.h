@@ -2394,3 +2394,15 @@ inline void glTextureBarrier()
 	assert((error = glGetError()) == GL_NO_ERROR);
 #endif
 }
+
+// GL_KHR_parallel_shader_compile
+
+inline void glMaxShaderCompilerThreadsKHR(GLuint count)
+{
+	assert(ptr_glMaxShaderCompilerThreadsKHR);
+	ptr_glMaxShaderCompilerThreadsKHR(count);
+#if defined(DEBUG_GL_CHECK_FOR_ERROR)
+	GLenum error;
+	assert((error = glGetError()) == GL_NO_ERROR);
+#endif
+}
@@ -114,3 +114,4 @@ bool glextLoad_GL_KHR_context_flush_control();
 bool glextLoad_GL_EXT_texture_filter_anisotropic();
 bool glextLoad_GL_EXT_texture_sRGB();
 bool glextLoad_GL_EXT_texture_snorm();
+bool glextLoad_GL_KHR_parallel_shader_compile();
@@ -571,3 +571,7 @@ EXTPTR PFNGLTEXTUREBARRIERPROC ptr_glTextureBarrier;
 
 // GL_EXT_texture_snorm
 
+
+// GL_KHR_parallel_shader_compile
+
+EXTPTR PFNGLMAXSHADERCOMPILERTHREADSKHRPROC ptr_glMaxShaderCompilerThreadsKHR;
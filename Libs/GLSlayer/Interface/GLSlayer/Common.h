@@ -388,6 +388,8 @@ namespace gls
 		MAP_INVALIDATE_BUFFER_BIT = 0x0008,	// cannot be used with MAP_READ_BIT
 		MAP_FLUSH_EXPLICIT_BIT = 0x0010,	// MAP_WRITE_BIT must be set
 		MAP_UNSYNCHRONIZED_BIT = 0x0020,	// cannot be used with MAP_READ_BIT
+		MAP_PERSISTENT_BIT = 0x0040,		// buffer must be created with BUFFER_MAP_PERSISTENT_BIT
+		MAP_COHERENT_BIT = 0x0080,			// buffer must be created with BUFFER_MAP_COHERENT_BIT
 	};
 
 	enum class ColorBuffer
@@ -0,0 +1,66 @@
+#ifndef _GLSLAYER_NULL_RENDER_CONTEXT_H_
+#define _GLSLAYER_NULL_RENDER_CONTEXT_H_
+
+#include "RenderContext.h"
+
+
+namespace gls
+{
+
+	// Counters accumulated by the null render context since creation or the last ResetStats call.
+	struct RenderStats
+	{
+		uint64 frames;					// Number of SwapBuffers calls.
+		uint64 drawCalls;
+		uint64 instances;				// Instances submitted by all draw calls.
+		uint64 vertices;				// Vertices or indices submitted by all draw calls, summed over instances.
+		uint64 dispatches;
+		uint64 shaderChanges;
+		uint64 resourceBindings;		// Buffers, textures, samplers, vertex formats and framebuffers bound.
+		uint64 stateChanges;			// All other pipeline state changes.
+		uint64 clears;
+		uint64 bufferBytesUploaded;		// Bytes written through BufferSubData, ClearData and write mappings.
+		uint64 textureBytesUploaded;	// Bytes written through TexSubImage and CompressedTexSubImage.
+		uint64 liveResources;			// Resources created and not yet destroyed. Not reset by ResetStats.
+		uint64 liveBufferBytes;			// Storage size of live buffers. Not reset by ResetStats.
+	};
+
+	// Receives one line of text for every command executed by the null render context.
+	class ICommandLogger
+	{
+	public:
+		virtual ~ICommandLogger() = default;
+		virtual void LogCommand(const char* command) = 0;
+	};
+
+	// Render context which accepts all calls without a GPU or a window. Resources it creates hold only
+	// the state needed to answer queries; buffers keep their storage so that they can be mapped.
+	class INullRenderContext : public IRenderContext
+	{
+	public:
+		virtual const RenderStats& GetStats() const = 0;
+		virtual void ResetStats() = 0;
+		virtual void SetCommandLogger(ICommandLogger* logger) = 0;
+	};
+
+	struct CreateNullContextInfo
+	{
+		uint version;
+		int width;
+		int height;
+		IDebugLogger* logger;
+		ICommandLogger* commandLogger;
+	};
+
+	extern "C"
+	{
+		GLSLAYER_API INullRenderContext* CreateNullRenderContext(const CreateNullContextInfo& info);
+		GLSLAYER_API void DestroyNullRenderContext(INullRenderContext* render_context);
+	}
+
+	typedef INullRenderContext* (*CreateNullRenderContextFuncPtr)(const CreateNullContextInfo& info);
+	typedef void (*DestroyNullRenderContextFuncPtr)(INullRenderContext* render_context);
+}
+
+
+#endif // _GLSLAYER_NULL_RENDER_CONTEXT_H_
@@ -496,29 +496,35 @@ namespace gls
 
 		virtual IVertexShader* CreateVertexShader(sizei count, const char** source, bool& success) = 0;
 		virtual IVertexShader* CreateVertexShader(sizei size, const void* binary, uint format, bool& success) = 0;
+		virtual IVertexShader* CreateVertexShaderAsync(sizei count, const char** source, bool& success) = 0;
 		virtual IVertexShader* CreateVertexShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 		virtual IVertexShader* CreateVertexShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 
 		virtual ITessControlShader* CreateTessControlShader(sizei count, const char** source, bool& success) = 0;
 		virtual ITessControlShader* CreateTessControlShader(sizei size, const void* binary, uint format, bool& success) = 0;
+		virtual ITessControlShader* CreateTessControlShaderAsync(sizei count, const char** source, bool& success) = 0;
 		virtual ITessControlShader* CreateTessControlShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 		virtual ITessControlShader* CreateTessControlShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 
 		virtual ITessEvaluationShader* CreateTessEvaluationShader(sizei count, const char** source, bool& success) = 0;
 		virtual ITessEvaluationShader* CreateTessEvaluationShader(sizei size, const void* binary, uint format, bool& success) = 0;
+		virtual ITessEvaluationShader* CreateTessEvaluationShaderAsync(sizei count, const char** source, bool& success) = 0;
 		virtual ITessEvaluationShader* CreateTessEvaluationShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 		virtual ITessEvaluationShader* CreateTessEvaluationShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 
 		virtual IGeometryShader* CreateGeometryShader(sizei count, const char** source, bool& success) = 0;
 		virtual IGeometryShader* CreateGeometryShader(sizei size, const void* binary, uint format, bool& success) = 0;
+		virtual IGeometryShader* CreateGeometryShaderAsync(sizei count, const char** source, bool& success) = 0;
 		virtual IGeometryShader* CreateGeometryShaderWithTransformFeedback(sizei count, const char** source, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 		virtual IGeometryShader* CreateGeometryShaderWithTransformFeedback(sizei size, const void* binary, uint format, sizei attrib_count, const char** attrib_names, bool& success) = 0;
 
 		virtual IFragmentShader* CreateFragmentShader(sizei count, const char** source, bool& success) = 0;
 		virtual IFragmentShader* CreateFragmentShader(sizei size, const void* binary, uint format, bool& success) = 0;
+		virtual IFragmentShader* CreateFragmentShaderAsync(sizei count, const char** source, bool& success) = 0;
 
 		virtual IComputeShader* CreateComputeShader(sizei count, const char** source, bool& success) = 0;
 		virtual IComputeShader* CreateComputeShader(sizei size, const void* binary, uint format, bool& success) = 0;
+		virtual IComputeShader* CreateComputeShaderAsync(sizei count, const char** source, bool& success) = 0;
 
 		virtual void DestroyShader(IShader* shader) = 0;
 
@@ -46,6 +46,8 @@ namespace gls
 		virtual uint GetSubroutineIndex(const char* name) = 0;
 		virtual bool GetBinary(uint& format, sizei buffer_size, void* buffer) = 0;
 		virtual int GetBinarySize() = 0;
+		virtual bool IsBuildComplete() = 0;		// Non-blocking; always true for shaders not created with Create*ShaderAsync.
+		virtual bool GetBuildStatus() = 0;		// Waits for an asynchronous build to finish and returns whether it succeeded.
 		virtual const ShaderBlockInfo* GetUniformBlockInfo(const char* blockName) = 0;
 		virtual const ShaderBlockInfo* GetStorageBlockInfo(const char* blockName) = 0;
 	};
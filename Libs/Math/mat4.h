@@ -14,6 +14,7 @@
 #include <type_traits>
 #include <utility>
 #include "vec3.h"
+#include "simd.h"
 
 /*
 
@@ -1335,6 +1336,50 @@ void mul(mat4<_ST>& r, const mat4<_ST>& a, const mat4<_ST>& b)
 	r(15) = a(12) * b(3) + a(13) * b(7) + a(14) * b(11) + a(15) * b(15);
 }
 
+#ifdef MATH3D_SSE2
+
+// Each row of the product is the sum of b's rows scaled by the elements of the same row of a.
+template <>
+inline
+void mul(mat4<float>& r, const mat4<float>& a, const mat4<float>& b)
+{
+	const float* pa = a;
+	const float* pb = b;
+	float* pr = r;
+
+#ifdef MATH3D_AVX
+	// Two rows at a time, with b's rows repeated in both halves of the vectors.
+	__m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pb));
+	__m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pb + 4));
+	__m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pb + 8));
+	__m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pb + 12));
+
+	auto mulRows = [&](__m256 rows)
+	{
+		__m256 res = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x00), b0);
+		res = simd::madd(_mm256_shuffle_ps(rows, rows, 0x55), b1, res);
+		res = simd::madd(_mm256_shuffle_ps(rows, rows, 0xaa), b2, res);
+		return simd::madd(_mm256_shuffle_ps(rows, rows, 0xff), b3, res);
+	};
+
+	__m256 r01 = mulRows(_mm256_loadu_ps(pa));
+	__m256 r23 = mulRows(_mm256_loadu_ps(pa + 8));
+	_mm256_storeu_ps(pr, r01);
+	_mm256_storeu_ps(pr + 8, r23);
+#else
+	__m128 r0 = simd::combine_rows(pa[0], pa[1], pa[2], pa[3], pb);
+	__m128 r1 = simd::combine_rows(pa[4], pa[5], pa[6], pa[7], pb);
+	__m128 r2 = simd::combine_rows(pa[8], pa[9], pa[10], pa[11], pb);
+	__m128 r3 = simd::combine_rows(pa[12], pa[13], pa[14], pa[15], pb);
+	_mm_storeu_ps(pr, r0);
+	_mm_storeu_ps(pr + 4, r1);
+	_mm_storeu_ps(pr + 8, r2);
+	_mm_storeu_ps(pr + 12, r3);
+#endif
+}
+
+#endif // MATH3D_SSE2
+
 template <class _ST>
 inline
 mat4<_ST> operator * (const mat4<_ST>& a, const mat4<_ST>& b)
@@ -433,7 +433,7 @@ template <class _ST>
 constexpr
 _ST dot(const quat<_ST>& a, const quat<_ST>& b)
 {
-	return a.x * b.x + a.y * b.y + a.z * b.z;
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 }
 
 template <class _ST>
@@ -448,11 +448,29 @@ quat<_ST> operator * (const quat<_ST>& a, const quat<_ST>& b)
 	};
 }
 
+template <class _ST>
+quat<_ST> nlerp(const quat<_ST>& a, const quat<_ST>& b, _ST t)
+{
+	// Interpolate along the shorter arc.
+	_ST sign = (dot(a, b) < _ST(0)) ? _ST(-1) : _ST(1);
+	quat<_ST> result(
+		a.x + (sign * b.x - a.x) * t,
+		a.y + (sign * b.y - a.y) * t,
+		a.z + (sign * b.z - a.z) * t,
+		a.w + (sign * b.w - a.w) * t);
+	result.normalize();
+	return result;
+}
+
 template <class _ST>
 quat<_ST> slerp(const quat<_ST>& a, const quat<_ST>& b, _ST t)
 {
+	_ST cos_theta = dot(a, b);
+	if (cos_theta > _ST(0.9995))
+		return nlerp(a, b, t);	// sin(theta) is too close to zero
+
 	quat<_ST> result;
-	_ST theta = acos(dot(a, b));
+	_ST theta = acos(cos_theta);
 	_ST inv_sin_theta = _ST(1) / sin(theta);
 	_ST f1 = sin(theta * (_ST(1) - t)) * inv_sin_theta;
 	_ST f2 = sin(theta * t) * inv_sin_theta;
@@ -487,6 +505,27 @@ quat<_ST> log(const quat<_ST>& q)
 	return result;
 }
 
+// Shortest rotation that takes unit vector 'from' to unit vector 'to'.
+template <class _ST>
+quat<_ST> rotation_arc(const vec3<_ST>& from, const vec3<_ST>& to)
+{
+	_ST d = dot(from, to);
+	if (d < _ST(-0.9999))
+	{
+		// Opposite vectors, rotate by 180 degrees around any perpendicular axis.
+		vec3<_ST> axis = cross(vec3<_ST>(_ST(1), _ST(0), _ST(0)), from);
+		if (axis.length_sq() < _ST(1.0e-6))
+			axis = cross(vec3<_ST>(_ST(0), _ST(1), _ST(0)), from);
+		axis.normalize();
+		return quat<_ST>(axis.x, axis.y, axis.z, _ST(0));
+	}
+
+	vec3<_ST> c = cross(from, to);
+	quat<_ST> result(c.x, c.y, c.z, _ST(1) + d);
+	result.normalize();
+	return result;
+}
+
 template <class _ST>
 quat<_ST> conjugate(const quat<_ST>& q)
 {
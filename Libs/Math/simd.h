@@ -0,0 +1,111 @@
+/* ----------------------------------------
+	File: simd.h
+	Purpose: SIMD helpers for float vector and matrix specializations
+   ---------------------------------------- */
+
+#ifndef _MATH3D_SIMD_H_
+#define _MATH3D_SIMD_H_
+
+/*
+	Instruction sets are selected at compile time from the compiler's target flags:
+
+	MATH3D_SSE2 - x86-64 baseline; float vec4 and mat4 transforms use 128 bit vectors
+	MATH3D_AVX  - mat4 products compute two rows at once with 256 bit vectors
+	MATH3D_FMA  - products are accumulated with fused multiply-add
+
+	Define MATH3D_NO_SIMD to use only the scalar templates. DeferredShadingBench --verify checks the specializations
+	against them.
+
+	Without FMA the vector code does the same operations in the same order as the scalar templates, so the
+	results are identical. With FMA the products aren't rounded before they are added and results can differ
+	in the last bit.
+*/
+
+#if !defined(MATH3D_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define MATH3D_SSE2
+	#if defined(__AVX__)
+		#define MATH3D_AVX
+	#endif
+	#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+		#define MATH3D_FMA
+	#endif
+#endif
+
+#if defined(MATH3D_AVX) || defined(MATH3D_FMA)
+	#include <immintrin.h>
+#elif defined(MATH3D_SSE2)
+	#include <emmintrin.h>
+#endif
+
+
+#ifdef MATH3D_SSE2
+
+namespace math3d
+{
+namespace simd
+{
+
+// a * b + c
+inline __m128 madd(__m128 a, __m128 b, __m128 c)
+{
+#ifdef MATH3D_FMA
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// Sum of the first three rows of the row-major 4x4 matrix m scaled by x, y and z.
+inline __m128 combine_rows(float x, float y, float z, const float* m)
+{
+	__m128 r = _mm_mul_ps(_mm_set1_ps(x), _mm_loadu_ps(m));
+	r = madd(_mm_set1_ps(y), _mm_loadu_ps(m + 4), r);
+	return madd(_mm_set1_ps(z), _mm_loadu_ps(m + 8), r);
+}
+
+// Sum of the rows of the row-major 4x4 matrix m scaled by x, y, z and w.
+inline __m128 combine_rows(float x, float y, float z, float w, const float* m)
+{
+	return madd(_mm_set1_ps(w), _mm_loadu_ps(m + 12), combine_rows(x, y, z, m));
+}
+
+// Transforms four points given by coordinate vectors with the row-major 4x4 matrix m, with w = 1 when
+// translate is true and w = 0 when it's false.
+inline void transform_xyz4(__m128& x, __m128& y, __m128& z, const float* m, bool translate)
+{
+	__m128 rx = madd(z, _mm_set1_ps(m[8]), madd(y, _mm_set1_ps(m[4]), _mm_mul_ps(x, _mm_set1_ps(m[0]))));
+	__m128 ry = madd(z, _mm_set1_ps(m[9]), madd(y, _mm_set1_ps(m[5]), _mm_mul_ps(x, _mm_set1_ps(m[1]))));
+	__m128 rz = madd(z, _mm_set1_ps(m[10]), madd(y, _mm_set1_ps(m[6]), _mm_mul_ps(x, _mm_set1_ps(m[2]))));
+
+	if (translate)
+	{
+		rx = _mm_add_ps(rx, _mm_set1_ps(m[12]));
+		ry = _mm_add_ps(ry, _mm_set1_ps(m[13]));
+		rz = _mm_add_ps(rz, _mm_set1_ps(m[14]));
+	}
+
+	x = rx;
+	y = ry;
+	z = rz;
+}
+
+#ifdef MATH3D_AVX
+
+inline __m256 madd(__m256 a, __m256 b, __m256 c)
+{
+#ifdef MATH3D_FMA
+	return _mm256_fmadd_ps(a, b, c);
+#else
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+#endif // MATH3D_AVX
+
+} // namespace simd
+} // namespace math3d
+
+#endif // MATH3D_SSE2
+
+
+#endif // _MATH3D_SIMD_H_
@@ -14,6 +14,7 @@
 #include "mat4.h"
 #include "quat.h"
 #include "mathutil.h"
+#include "simd.h"
 
 
 
@@ -98,12 +99,104 @@ vec3<_ST> transform_dir(const vec3<_ST>& v, const mat4<_ST>& m)
 	return r;
 }
 
+#ifdef MATH3D_SSE2
+
+// Transforms of float vec4s add up the matrix rows scaled by the vector's components, four columns at once.
+// vec3 transforms stay scalar: going through a vector register and back to three floats costs more than the
+// nine multiply-adds it saves.
+
+template <>
+inline
+vec4<float> operator * (const vec4<float>& v, const mat4<float>& m)
+{
+	vec4<float> r;
+	_mm_storeu_ps(&r.x, simd::combine_rows(v.x, v.y, v.z, v.w, m));
+	return r;
+}
+
+#endif // MATH3D_SSE2
+
+
+// ----------- array transforms ------------
+
+// Transforms count points with matrix m, as in[i] * m. in and out may be the same array.
+template <class _ST>
+void transform_points(const vec3<_ST>* in, vec3<_ST>* out, size_t count, const mat4<_ST>& m)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = in[i] * m;
+}
+
+// Transforms count direction vectors with the 3x3 sub-matrix of m, as transform_dir does.
+// in and out may be the same array.
+template <class _ST>
+void transform_dirs(const vec3<_ST>* in, vec3<_ST>* out, size_t count, const mat4<_ST>& m)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = transform_dir(in[i], m);
+}
+
+// Transforms count points given as separate arrays of coordinates. The input and output arrays may be the same.
+template <class _ST>
+void transform_points(
+	const _ST* inX, const _ST* inY, const _ST* inZ,
+	_ST* outX, _ST* outY, _ST* outZ,
+	size_t count, const mat4<_ST>& m)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		_ST x = inX[i], y = inY[i], z = inZ[i];
+		outX[i] = m(0) * x + m(4) * y + m(8) * z + m(12);
+		outY[i] = m(1) * x + m(5) * y + m(9) * z + m(13);
+		outZ[i] = m(2) * x + m(6) * y + m(10) * z + m(14);
+	}
+}
+
+#ifdef MATH3D_SSE2
+
+// Float coordinate arrays are transformed four points at a time. The remaining points go through the single
+// vector transform; results are the same either way. Arrays of vec3 stay scalar: transposing them to and from
+// one vector per coordinate costs more than the vector arithmetic saves.
+
+template <>
+inline
+void transform_points(
+	const float* inX, const float* inY, const float* inZ,
+	float* outX, float* outY, float* outZ,
+	size_t count, const mat4<float>& m)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(inX + i);
+		__m128 y = _mm_loadu_ps(inY + i);
+		__m128 z = _mm_loadu_ps(inZ + i);
+		simd::transform_xyz4(x, y, z, m, true);
+		_mm_storeu_ps(outX + i, x);
+		_mm_storeu_ps(outY + i, y);
+		_mm_storeu_ps(outZ + i, z);
+	}
+
+	for (; i < count; ++i)
+	{
+		vec3<float> r = vec3<float>(inX[i], inY[i], inZ[i]) * m;
+		outX[i] = r.x;
+		outY[i] = r.y;
+		outZ[i] = r.z;
+	}
+}
+
+#endif // MATH3D_SSE2
+
 
 // Vector transform by quaternion.
 template <class _ST>
 vec3<_ST> rotate(const vec3<_ST>& v, const quat<_ST>& q)
 {
-	return q * v * inverse(q);
+	// Expanded q * v * conjugate(q) for a unit quaternion.
+	vec3<_ST> u(q.x, q.y, q.z);
+	vec3<_ST> t = _ST(2) * cross(u, v);
+	return v + q.w * t + cross(u, t);
 }
 
 template <class _ST>
@@ -0,0 +1,115 @@
+#include "BenchmarkStats.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+static float Median(std::vector<float>& values)
+{
+	size_t mid = values.size() / 2;
+	std::nth_element(values.begin(), values.begin() + mid, values.end());
+	float median = values[mid];
+	if (values.size() % 2 == 0)
+		median = (median + *std::max_element(values.begin(), values.begin() + mid)) * 0.5f;
+	return median;
+}
+
+float Percentile(const std::vector<float>& sortedValues, float percent)
+{
+	if (sortedValues.empty())
+		return 0.0f;
+
+	// Linear interpolation between the closest ranks.
+	float rank = percent / 100.0f * (sortedValues.size() - 1);
+	size_t lower = static_cast<size_t>(rank);
+	size_t upper = std::min(lower + 1, sortedValues.size() - 1);
+	float frac = rank - lower;
+	return sortedValues[lower] + (sortedValues[upper] - sortedValues[lower]) * frac;
+}
+
+FrameTimeStats ComputeFrameTimeStats(const std::vector<float>& frameTimes)
+{
+	FrameTimeStats stats;
+	stats.count = frameTimes.size();
+	if (frameTimes.empty())
+		return stats;
+
+	std::vector<float> sorted(frameTimes);
+	std::sort(sorted.begin(), sorted.end());
+
+	double sum = 0.0;
+	for (float dt : frameTimes)
+		sum += dt;
+	double mean = sum / frameTimes.size();
+
+	double sqDiffSum = 0.0;
+	for (float dt : frameTimes)
+		sqDiffSum += (dt - mean) * (dt - mean);
+
+	stats.mean = static_cast<float>(mean);
+	stats.stdDev = frameTimes.size() > 1 ? static_cast<float>(std::sqrt(sqDiffSum / (frameTimes.size() - 1))) : 0.0f;
+	stats.min = sorted.front();
+	stats.max = sorted.back();
+	stats.median = Percentile(sorted, 50.0f);
+	stats.p90 = Percentile(sorted, 90.0f);
+	stats.p95 = Percentile(sorted, 95.0f);
+	stats.p99 = Percentile(sorted, 99.0f);
+	stats.p999 = Percentile(sorted, 99.9f);
+
+	// Bootstrap the median. The generator is seeded with a constant so that the same frame times
+	// always produce the same interval.
+	std::mt19937 rng(12345);
+	std::uniform_int_distribution<size_t> pick(0, frameTimes.size() - 1);
+	std::vector<float> resample(frameTimes.size());
+	std::vector<float> medians(BootstrapResamples);
+
+	for (float& median : medians)
+	{
+		for (float& value : resample)
+			value = frameTimes[pick(rng)];
+		median = Median(resample);
+	}
+
+	std::sort(medians.begin(), medians.end());
+	stats.medianCILow = Percentile(medians, 2.5f);
+	stats.medianCIHigh = Percentile(medians, 97.5f);
+
+	// Compare each frame to the median of its neighbourhood rather than to the global median,
+	// so that heavier parts of the demo are not reported as one long spike.
+	std::vector<float> window;
+	window.reserve(SpikeWindow);
+	int count = static_cast<int>(frameTimes.size());
+
+	for (int i = 0; i < count; ++i)
+	{
+		int first = std::max(0, i - SpikeWindow / 2);
+		int last = std::min(count, i + SpikeWindow / 2 + 1);
+		window.assign(frameTimes.begin() + first, frameTimes.begin() + last);
+
+		if (frameTimes[i] > SpikeFactor * Median(window))
+			stats.spikes.push_back(i);
+	}
+
+	return stats;
+}
+
+void WriteFrameTimeStatsJson(std::ostream& out, const FrameTimeStats& stats, const char* indent)
+{
+	out << "{\n";
+	out << indent << "\t\"count\": " << stats.count << ",\n";
+	out << indent << "\t\"mean\": " << stats.mean << ",\n";
+	out << indent << "\t\"stdDev\": " << stats.stdDev << ",\n";
+	out << indent << "\t\"min\": " << stats.min << ",\n";
+	out << indent << "\t\"max\": " << stats.max << ",\n";
+	out << indent << "\t\"median\": " << stats.median << ",\n";
+	out << indent << "\t\"p90\": " << stats.p90 << ",\n";
+	out << indent << "\t\"p95\": " << stats.p95 << ",\n";
+	out << indent << "\t\"p99\": " << stats.p99 << ",\n";
+	out << indent << "\t\"p99_9\": " << stats.p999 << ",\n";
+	out << indent << "\t\"medianCI95\": [" << stats.medianCILow << ", " << stats.medianCIHigh << "],\n";
+	out << indent << "\t\"spikes\": [";
+	for (size_t i = 0; i < stats.spikes.size(); ++i)
+		out << (i ? ", " : "") << stats.spikes[i];
+	out << "]\n";
+	out << indent << "}";
+}
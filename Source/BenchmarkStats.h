@@ -0,0 +1,36 @@
+#ifndef _BENCHMARK_STATS_H_
+#define _BENCHMARK_STATS_H_
+
+#include <cstddef>
+#include <vector>
+#include <ostream>
+
+
+// Summary of a frame time series. All times are in milliseconds.
+struct FrameTimeStats
+{
+	size_t count = 0;
+	float mean = 0.0f;
+	float stdDev = 0.0f;
+	float min = 0.0f;
+	float max = 0.0f;
+	float median = 0.0f;
+	float p90 = 0.0f;
+	float p95 = 0.0f;
+	float p99 = 0.0f;
+	float p999 = 0.0f;
+	float medianCILow = 0.0f;		// 95% bootstrap confidence interval of the median.
+	float medianCIHigh = 0.0f;
+	std::vector<size_t> spikes;		// Indices of frames that took much longer than their neighbours.
+};
+
+// Frames taking longer than SpikeFactor times the median of the surrounding SpikeWindow frames are spikes.
+constexpr float SpikeFactor = 2.0f;
+constexpr int SpikeWindow = 31;
+constexpr int BootstrapResamples = 1000;
+
+float Percentile(const std::vector<float>& sortedValues, float percent);
+FrameTimeStats ComputeFrameTimeStats(const std::vector<float>& frameTimes);
+void WriteFrameTimeStatsJson(std::ostream& out, const FrameTimeStats& stats, const char* indent);
+
+#endif // _BENCHMARK_STATS_H_
@@ -1,5 +1,6 @@
 #include "DeferredRenderer.h"
 #include <cassert>
+#include <cstring>
 #include <string>
 #include <algorithm>
 #include <numeric>
@@ -13,6 +14,8 @@
 
 #include <GLSlayer/RenderContextInit.h>
 #include "Utils.h"
+#include "Profiler.h"
+#include "HeapCounter.h"
 
 
 #pragma pack(push, 1)
@@ -35,6 +38,11 @@ struct UniformSceneXformData
 	math3d::vec4f viewport;
 };
 
+struct UniformUpsampleData
+{
+	int32_t halfMaxCoords[2];
+};
+
 struct UniformLightData
 {
 	math3d::vec4f positionRadius;
@@ -65,6 +73,13 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 	if (!_renderContext)
 		return false;
 
+	return InitCommon();
+}
+
+bool DeferredRenderer::InitCommon()
+{
+	PROFILE_ZONE("InitCommon");
+
 	_renderContext->SetCurrentContext();
 	_renderContext->CullFace(gls::PolygonFace::Back);
 	_renderContext->FrontFace(gls::VertexWinding::Counterclockwise);
@@ -78,6 +93,8 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 
 	// Load shaders.
 
+	_shaderCache.Init(_renderContext);
+
 	_fragShaderGeometryPass = LoadFragmentShader("GeometryPass.frag");
 	if (_fragShaderGeometryPass == nullptr)
 	{
@@ -113,6 +130,48 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 		return false;
 	}
 
+	_vertShaderLightQuad = LoadVertexShader("LightQuad.vert");
+	if (_vertShaderLightQuad == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
+	_fragShaderLightingPassQuad = LoadFragmentShader("LightingPass.frag", { "LIGHT_PALETTE" });
+	if (_fragShaderLightingPassQuad == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
+	_fragShaderLightingPassHalfRes = LoadFragmentShader("LightingPass.frag", { "HALF_RES" });
+	if (_fragShaderLightingPassHalfRes == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
+	_fragShaderLightingPassQuadHalfRes = LoadFragmentShader("LightingPass.frag", { "LIGHT_PALETTE", "HALF_RES" });
+	if (_fragShaderLightingPassQuadHalfRes == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
+	_fragShaderDownsampleGBuffer = LoadFragmentShader("DownsampleGBuffer.frag");
+	if (_fragShaderDownsampleGBuffer == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
+	_fragShaderLightingUpsample = LoadFragmentShader("LightingUpsample.frag");
+	if (_fragShaderLightingUpsample == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
 	_vertShaderLightSource = LoadVertexShader("LightSource.vert");
 	if (_vertShaderLightSource == nullptr)
 	{
@@ -148,6 +207,13 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 		return false;
 	}
 
+	_vertShaderForwardSP = LoadVertexShader("Forward.vert", { "LIGHT_RANGE" });
+	if (_vertShaderForwardSP == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
 	_fragShaderForward = LoadFragmentShader("Forward.frag");
 	if (_fragShaderForward == nullptr)
 	{
@@ -176,6 +242,36 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 		return false;
 	}
 
+	_fragShaderForwardTranspOIT = LoadFragmentShader("ForwardTranspSinglePass.frag", { "WEIGHTED_OIT" });
+	if (_fragShaderForwardTranspOIT == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
+	_fragShaderTranspResolve = LoadFragmentShader("TranspResolve.frag");
+	if (_fragShaderTranspResolve == nullptr)
+	{
+		Deinit();
+		return false;
+	}
+
+	// Single pass shaders specialized for a fixed maximum light count, so the light loop can be unrolled.
+	for (size_t i = 0; i < LightCountBuckets.size(); ++i)
+	{
+		std::vector<std::string> defines = { "MAX_LIGHTS " + std::to_string(LightCountBuckets[i]) };
+		_fragShaderForwardSPBuckets[i] = LoadFragmentShader("ForwardSinglePass.frag", defines);
+		_fragShaderForwardTranspSPBuckets[i] = LoadFragmentShader("ForwardTranspSinglePass.frag", defines);
+		defines.push_back("WEIGHTED_OIT");
+		_fragShaderForwardTranspOITBuckets[i] = LoadFragmentShader("ForwardTranspSinglePass.frag", defines);
+		if (_fragShaderForwardSPBuckets[i] == nullptr || _fragShaderForwardTranspSPBuckets[i] == nullptr ||
+			_fragShaderForwardTranspOITBuckets[i] == nullptr)
+		{
+			Deinit();
+			return false;
+		}
+	}
+
 	_vertShaderDepthOnly = LoadVertexShader("DepthOnlyPass.vert");
 	if (_vertShaderDepthOnly == nullptr)
 	{
@@ -183,6 +279,25 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 		return false;
 	}
 
+	// The builds above were only submitted, so the driver can compile them in parallel. Wait only for
+	// the shaders needed to render the first frame; the rest finish in the background and are picked up
+	// by FinishPendingShaderBuilds.
+	gls::IShader* firstFrameShaders[] =
+	{
+		_fragShaderGeometryPass, _vertShaderScreenSpace, _vertShaderLightingPass, _fragShaderLightingPass,
+		_vertShaderLightSource, _fragShaderLightSource, _vertShaderImGui, _fragShaderImGui,
+		_vertShaderForward, _vertShaderForwardSP, _fragShaderForward, _fragShaderForwardSP, _vertShaderDepthOnly
+	};
+
+	for (gls::IShader* shader : firstFrameShaders)
+	{
+		if (!FinishShaderBuild(shader))
+		{
+			Deinit();
+			return false;
+		}
+	}
+
 	// Load the main scene.
 
 	if (!_sponzaScene.Load(_renderContext, "Sponza/sponza.obj"))
@@ -192,6 +307,39 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 		return false;
 	}
 
+	// Light-mesh interactions are cached against the mesh bounding boxes.
+
+	std::vector<math3d::vec3f> meshMinPts, meshMaxPts;
+	for (int meshInd = 0; meshInd < _sponzaScene.GetMeshCount(); ++meshInd)
+	{
+		meshMinPts.push_back(_sponzaScene.GetMesh(meshInd).minPt);
+		meshMaxPts.push_back(_sponzaScene.GetMesh(meshInd).maxPt);
+	}
+	_interactionCache.SetBoxes(meshMinPts, meshMaxPts);
+	_visibleObjectsValid = false;
+
+	// Visible clusters are drawn with one indirect command each at most, so the buffer never needs to grow.
+	_meshClusterDraws.resize(_sponzaScene.GetMeshCount());
+	_clusterDrawBuf = _renderContext->CreateBuffer(
+		std::max(_sponzaScene.GetClusterCount(), 1) * sizeof(gls::DrawIndexedIndirectData), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+
+	_meshLightRanges.assign(_sponzaScene.GetMeshCount(), { 0, 0 });
+	_meshLightRangeBuf = _renderContext->CreateBuffer(
+		std::max(_sponzaScene.GetMeshCount(), 1) * sizeof(LightRange), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+
+	_meshCenters.Resize(_sponzaScene.GetMeshCount());
+	_meshViewCenters.Resize(_sponzaScene.GetMeshCount());
+	for (int meshInd = 0; meshInd < _sponzaScene.GetMeshCount(); ++meshInd)
+		_meshCenters.Set(meshInd, (meshMaxPts[meshInd] + meshMinPts[meshInd]) * 0.5f);
+
+	_clusterCenters.Resize(_sponzaScene.GetClusterCount());
+	_clusterViewCenters.Resize(_sponzaScene.GetClusterCount());
+	for (int clusterInd = 0; clusterInd < _sponzaScene.GetClusterCount(); ++clusterInd)
+	{
+		const ObjScene::Cluster& cluster = _sponzaScene.GetCluster(clusterInd);
+		_clusterCenters.Set(clusterInd, (cluster.maxPt + cluster.minPt) * 0.5f);
+	}
+
 	_sponzaScene.GetBounds(_sceneBoundsMin, _sceneBoundsMax);
 	math3d::vec3f bounds = _sceneBoundsMax - _sceneBoundsMin;
 	_cameraPosition = _sceneBoundsMin + bounds / 2.0f;
@@ -217,13 +365,11 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 
 	CreateRandomLights(_randomLightsToCreate, _lightBoundsMin, _lightBoundsMax);
 
-	_lightInfoBuf = _renderContext->CreateBuffer(MaxLights * sizeof(UniformLightData), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+	// Light buffers grow with the number of visible lights.
 	_lightInfoTex = _renderContext->CreateTextureBuffer();
-	_lightInfoTex->TexBuffer(gls::PixelFormat::RGBA32F, _lightInfoBuf);
-
-	_lightIndexBuf = _renderContext->CreateBuffer(MaxLights * sizeof(int32_t), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
 	_lightIndexTex = _renderContext->CreateTextureBuffer();
-	_lightIndexTex->TexBuffer(gls::PixelFormat::R32I, _lightIndexBuf);
+	ReserveLightBuffers(InitialLightBufferCapacity);
+	ReserveLightIndexBuffer(InitialLightBufferCapacity);
 
 	CreateSphere(1.0f, 16, 16);
 
@@ -238,6 +384,13 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 	};
 	_vertexFormat = _renderContext->CreateVertexFormat(vertDesc, CountOf(vertDesc));
 
+	gls::VertexAttribDesc lightRangeVertDesc[] =
+	{
+		vertDesc[0], vertDesc[1], vertDesc[2], vertDesc[3],
+		{ 1, 4, 2, gls::DataType::Int, true, false, 0 },
+	};
+	_vertFmtLightRange = _renderContext->CreateVertexFormat(lightRangeVertDesc, CountOf(lightRangeVertDesc));
+
 	gls::VertexAttribDesc rectVertDesc[] =
 	{
 		{ 0, 0, 2, gls::DataType::Float, false, false, 0 },
@@ -245,6 +398,12 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 	};
 	_vertFmtScreenRect = _renderContext->CreateVertexFormat(rectVertDesc, CountOf(rectVertDesc));
 
+	gls::VertexAttribDesc lightQuadVertDesc[] =
+	{
+		{ 0, 0, 4, gls::DataType::Float, false, false, 0 },
+	};
+	_vertFmtLightQuad = _renderContext->CreateVertexFormat(lightQuadVertDesc, CountOf(lightQuadVertDesc));
+
 	gls::VertexAttribDesc imGuiVertDesc[] =
 	{
 		{ 0, 0, 2, gls::DataType::Float, false, false, offsetof(ImDrawVert, pos) },
@@ -258,6 +417,7 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 	_ubufSceneXformData = _renderContext->CreateBuffer(sizeof(UniformSceneXformData), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
 	_ubufLightData = _renderContext->CreateBuffer(sizeof(UniformLightData), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
 	_ubufGbufferTexViewData = _renderContext->CreateBuffer(sizeof(UniformGbufferTexViewData), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+	_ubufUpsampleData = _renderContext->CreateBuffer(sizeof(UniformUpsampleData), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
 	_ubufImGui = _renderContext->CreateBuffer(sizeof(math3d::mat4f), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
 
 	// Screen-space rectangles buffer.
@@ -324,15 +484,26 @@ bool DeferredRenderer::Init(gls::CreateContextInfo& info)
 	_imGuiIO->KeyMap[ImGuiKey_Y] = static_cast<int>(Key::Y);
 	_imGuiIO->KeyMap[ImGuiKey_Z] = static_cast<int>(Key::Z);
 
-	_imGuiVertBuffer = _renderContext->CreateBuffer((1 << 16) * sizeof(ImDrawVert), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
-	_imGuiIndexBuffer = _renderContext->CreateBuffer((1 << 20)* sizeof(ImDrawIdx), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+	// Draws add the command's vertex offset as the base vertex, so large plots can use 16 bit indices.
+	_imGuiIO->BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+	ReserveImGuiBuffers(1 << 16, 1 << 18);
 
 	_framerateValues.resize(60, 0.0f);
 	_framerateValueAddTime = 0.0f;
 
+	// GPU timer queries are used in a ring so that reading a result never stalls on the frame just submitted.
+	for (auto& query : _benchmarkData.gpuTimerQueries)
+		query = _renderContext->CreateQuery();
+
+	// Interpolate the camera between samples so that every render path sees the same trajectory at any frame rate.
 	_demoPlayer.SetCallbacks(
 		[this]() { RecorderSamplingFunc(); },
-		[this](int32_t id, size_t size, const void* data) { PlayerSampleUpdate(id, size, data); });
+		[this](int32_t id, size_t size, const void* data) { PlayerSampleUpdate(id, size, data); },
+		{
+			{ DemoDataId::CamPosition, DemoPlayer::Interpolation::Linear },
+			{ DemoDataId::CamForwardVec, DemoPlayer::Interpolation::Spherical },
+			{ DemoDataId::CamRightVec, DemoPlayer::Interpolation::Spherical },
+		});
 
 	return true;
 }
@@ -345,8 +516,9 @@ void DeferredRenderer::Deinit()
 		DestroyFramebuffers();
 		_sponzaScene.Unload();
 
-		_renderContext->DestroyBuffer(_imGuiVertBuffer);
-		_renderContext->DestroyBuffer(_imGuiIndexBuffer);
+		DestroyImGuiBuffers();
+		for (auto query : _benchmarkData.gpuTimerQueries)
+			_renderContext->DestroyQuery(query);
 		if (_imGuiIO != nullptr)
 			_renderContext->DestroyTexture(static_cast<gls::ITexture2D*>(_imGuiIO->Fonts->TexID));
 		if (ImGui::GetCurrentContext() != nullptr)
@@ -356,35 +528,62 @@ void DeferredRenderer::Deinit()
 		_renderContext->DestroyBuffer(_lightInfoBuf);
 		_renderContext->DestroyTexture(_lightIndexTex);
 		_renderContext->DestroyBuffer(_lightIndexBuf);
+		_renderContext->DestroyBuffer(_lightQuadVertBuf);
+		_renderContext->DestroyBuffer(_meshLightRangeBuf);
 		_renderContext->DestroyShader(_fragShaderGeometryPass);
 		_renderContext->DestroyShader(_vertShaderScreenSpace);
 		_renderContext->DestroyShader(_fragShaderVisGBuffer);
 		_renderContext->DestroyShader(_vertShaderLightingPass);
 		_renderContext->DestroyShader(_fragShaderLightingPass);
+		_renderContext->DestroyShader(_vertShaderLightQuad);
+		_renderContext->DestroyShader(_fragShaderLightingPassQuad);
+		_renderContext->DestroyShader(_fragShaderLightingPassHalfRes);
+		_renderContext->DestroyShader(_fragShaderLightingPassQuadHalfRes);
+		_renderContext->DestroyShader(_fragShaderDownsampleGBuffer);
+		_renderContext->DestroyShader(_fragShaderLightingUpsample);
 		_renderContext->DestroyShader(_vertShaderLightSource);
 		_renderContext->DestroyShader(_fragShaderLightSource);
 		_renderContext->DestroyShader(_vertShaderImGui);
 		_renderContext->DestroyShader(_fragShaderImGui);
 		_renderContext->DestroyShader(_vertShaderForward);
+		_renderContext->DestroyShader(_vertShaderForwardSP);
 		_renderContext->DestroyShader(_fragShaderForward);
 		_renderContext->DestroyShader(_fragShaderForwardSP);
 		_renderContext->DestroyShader(_fragShaderForwardTransp);
 		_renderContext->DestroyShader(_fragShaderForwardTranspSP);
+		for (gls::IFragmentShader* shader : _fragShaderForwardSPBuckets)
+			_renderContext->DestroyShader(shader);
+		for (gls::IFragmentShader* shader : _fragShaderForwardTranspSPBuckets)
+			_renderContext->DestroyShader(shader);
+		_renderContext->DestroyShader(_fragShaderForwardTranspOIT);
+		for (gls::IFragmentShader* shader : _fragShaderForwardTranspOITBuckets)
+			_renderContext->DestroyShader(shader);
+		_renderContext->DestroyShader(_fragShaderTranspResolve);
 		_renderContext->DestroyShader(_vertShaderDepthOnly);
 		_renderContext->DestroyVertexFormat(_vertexFormat);
 		_renderContext->DestroyVertexFormat(_vertFmtScreenRect);
+		_renderContext->DestroyVertexFormat(_vertFmtLightQuad);
+		_renderContext->DestroyVertexFormat(_vertFmtLightRange);
 		_renderContext->DestroyVertexFormat(_vertFmtImGui);
 		_renderContext->DestroyBuffer(_rectVertBuf);
 		_renderContext->DestroyBuffer(_ubufSceneXformData);
 		_renderContext->DestroyBuffer(_ubufLightData);
 		_renderContext->DestroyBuffer(_ubufGbufferTexViewData);
+		_renderContext->DestroyBuffer(_ubufUpsampleData);
 		_renderContext->DestroyBuffer(_ubufImGui);
+		_renderContext->DestroyBuffer(_clusterDrawBuf);
 		_renderContext->DestroySamplerState(_samplerSurfaceTex);
 		_renderContext->DestroySamplerState(_samplerLinearClamp);
 		_renderContext->DestroySamplerState(_samplerGBuffer);
 
-		gls::DestroyRenderContext(_renderContext);
+		if (_nullRenderContext)
+			gls::DestroyNullRenderContext(_nullRenderContext);
+		else
+			gls::DestroyRenderContext(_renderContext);
 
+		// The frame containers keep their arena on assignment, while the arena's memory goes to the temporary and is
+		// freed with it, so they must not hold any of it.
+		ResetFrameData();
 		*this = {};		// Reset all member variables to default values.
 	}
 }
@@ -403,58 +602,153 @@ gls::FramebufferFormat DeferredRenderer::GetFramebufferFormat()
 	return fbufFormat;
 }
 
-gls::IVertexShader* DeferredRenderer::LoadVertexShader(const char* fileName)
+gls::IVertexShader* DeferredRenderer::LoadVertexShader(const char* fileName, const std::vector<std::string>& defines)
 {
-	std::string source = LoadShaderSource(fileName);
+	PROFILE_ZONE("LoadVertexShader");
+
+	std::string source = LoadShaderSource(fileName, defines);
 	if (source.empty())
 	{
 		_console.PrintLn("Failed to load vertex shader from file: %s", fileName);
 		return nullptr;
 	}
 
-	const char* sources[] = { source.c_str() };
+	std::string shaderName = GetShaderPermutationName(fileName, defines);
+
 	bool success;
-	gls::IVertexShader* vertShader = _renderContext->CreateVertexShader(1, sources, success);
-	if (vertShader->GetInfoLogLength() > 1)
+	gls::uint binaryFormat;
+	std::vector<char> binary;
+	if (_shaderCache.LoadBinary(shaderName.c_str(), source, binaryFormat, binary))
 	{
-		_console.PrintLn("Compiling vertex shader: %s\n%s", fileName, vertShader->GetInfoLog());
+		gls::IVertexShader* vertShader = _renderContext->CreateVertexShader(static_cast<gls::sizei>(binary.size()), binary.data(), binaryFormat, success);
+		if (success)
+			return vertShader;
+
+		// The driver rejected the cached binary; fall back to compiling from source.
+		_renderContext->DestroyShader(vertShader);
+		_shaderCache.RemoveBinary(shaderName.c_str());
 	}
 
+	// Only submit the build here; the result is collected by FinishShaderBuild.
+	const char* sources[] = { source.c_str() };
+	gls::IVertexShader* vertShader = _renderContext->CreateVertexShaderAsync(1, sources, success);
 	if (!success)
 	{
+		_console.PrintLn("Failed to create vertex shader: %s", shaderName.c_str());
 		_renderContext->DestroyShader(vertShader);
 		return nullptr;
 	}
 
+	_pendingShaders.push_back({ vertShader, std::move(shaderName), std::move(source) });
+
 	return vertShader;
 }
 
-gls::IFragmentShader* DeferredRenderer::LoadFragmentShader(const char* fileName)
+gls::IFragmentShader* DeferredRenderer::LoadFragmentShader(const char* fileName, const std::vector<std::string>& defines)
 {
-	std::string source = LoadShaderSource(fileName);
+	PROFILE_ZONE("LoadFragmentShader");
+
+	std::string source = LoadShaderSource(fileName, defines);
 	if (source.empty())
 	{
 		_console.PrintLn("Failed to load fragment shader from file: %s", fileName);
 		return nullptr;
 	}
 
-	const char* sources[] = { source.c_str() };
+	std::string shaderName = GetShaderPermutationName(fileName, defines);
+
 	bool success;
-	gls::IFragmentShader* fragShader = _renderContext->CreateFragmentShader(1, sources, success);
-	if (fragShader->GetInfoLogLength() > 1)
+	gls::uint binaryFormat;
+	std::vector<char> binary;
+	if (_shaderCache.LoadBinary(shaderName.c_str(), source, binaryFormat, binary))
 	{
-		_console.PrintLn("Compiling fragment shader: %s\n%s", fileName, fragShader->GetInfoLog());
+		gls::IFragmentShader* fragShader = _renderContext->CreateFragmentShader(static_cast<gls::sizei>(binary.size()), binary.data(), binaryFormat, success);
+		if (success)
+			return fragShader;
+
+		// The driver rejected the cached binary; fall back to compiling from source.
+		_renderContext->DestroyShader(fragShader);
+		_shaderCache.RemoveBinary(shaderName.c_str());
 	}
 
+	// Only submit the build here; the result is collected by FinishShaderBuild.
+	const char* sources[] = { source.c_str() };
+	gls::IFragmentShader* fragShader = _renderContext->CreateFragmentShaderAsync(1, sources, success);
 	if (!success)
 	{
+		_console.PrintLn("Failed to create fragment shader: %s", shaderName.c_str());
 		_renderContext->DestroyShader(fragShader);
 		return nullptr;
 	}
 
+	_pendingShaders.push_back({ fragShader, std::move(shaderName), std::move(source) });
+
 	return fragShader;
 }
 
+gls::IFragmentShader* DeferredRenderer::SelectLightLoopShader(const LightLoopShaders& bucketShaders, gls::IFragmentShader* genericShader, int numLights)
+{
+	// Use the smallest bucket that fits. Permutations still being built fall back to the generic shader.
+	for (size_t i = 0; i < LightCountBuckets.size(); ++i)
+	{
+		if (numLights <= LightCountBuckets[i])
+			return IsShaderReady(bucketShaders[i]) ? bucketShaders[i] : genericShader;
+	}
+
+	return genericShader;
+}
+
+bool DeferredRenderer::FinishShaderBuild(gls::IShader* shader)
+{
+	PROFILE_ZONE("FinishShaderBuild");
+
+	auto it = std::find_if(_pendingShaders.begin(), _pendingShaders.end(),
+		[shader](const PendingShaderBuild& build) { return build.shader == shader; });
+	if (it == _pendingShaders.end())
+		return shader != nullptr && std::find(_failedShaders.begin(), _failedShaders.end(), shader) == _failedShaders.end();
+
+	bool success = shader->GetBuildStatus();
+	if (shader->GetInfoLogLength() > 1)
+	{
+		_console.PrintLn("Compiling shader: %s\n%s", it->fileName.c_str(), shader->GetInfoLog());
+	}
+
+	if (success)
+		_shaderCache.SaveBinary(it->fileName.c_str(), it->source, shader);
+	else
+		_failedShaders.push_back(shader);
+
+	_pendingShaders.erase(it);
+
+	return success;
+}
+
+void DeferredRenderer::FinishPendingShaderBuilds(bool wait)
+{
+	PROFILE_ZONE("FinishPendingShaderBuilds");
+
+	size_t i = 0;
+	while (i < _pendingShaders.size())
+	{
+		gls::IShader* shader = _pendingShaders[i].shader;
+		if (wait || shader->IsBuildComplete())
+			FinishShaderBuild(shader);
+		else
+			++i;
+	}
+}
+
+bool DeferredRenderer::IsShaderReady(gls::IShader* shader)
+{
+	for (const PendingShaderBuild& build : _pendingShaders)
+	{
+		if (build.shader == shader)
+			return shader->IsBuildComplete() && FinishShaderBuild(shader);
+	}
+
+	return shader != nullptr && std::find(_failedShaders.begin(), _failedShaders.end(), shader) == _failedShaders.end();
+}
+
 void DeferredRenderer::CreateFramebuffers(int width, int height)
 {
 	DestroyFramebuffers();
@@ -485,6 +779,46 @@ void DeferredRenderer::CreateFramebuffers(int width, int height)
 	buffers[0] = gls::ColorBuffer::Color0;
 	_renderContext->ActiveColorBuffers(_sceneBuffer, buffers, 1);
 
+	_transpBuffer = _renderContext->CreateFramebuffer();
+	_texTranspAccum = _renderContext->CreateTexture2D(1, gls::PixelFormat::RGBA16F, width, height);
+	_texTranspRevealage = _renderContext->CreateTexture2D(1, gls::PixelFormat::R16F, width, height);
+	_transpBuffer->AttachTexture(gls::AttachmentBuffer::Color0, _texTranspAccum, 0);
+	_transpBuffer->AttachTexture(gls::AttachmentBuffer::Color1, _texTranspRevealage, 0);
+	_transpBuffer->AttachTexture(gls::AttachmentBuffer::DepthStencil, _depthBuffer, 0);
+	status = _transpBuffer->CheckStatus();
+	assert(status == gls::FramebufferStatus::Complete);
+
+	buffers[0] = gls::ColorBuffer::Color0;
+	buffers[1] = gls::ColorBuffer::Color1;
+	_renderContext->ActiveColorBuffers(_transpBuffer, buffers, 2);
+
+	// Half resolution lighting renders to the top left quarter of these, like the full resolution passes render to
+	// the top left of theirs when the resolution is scaled down.
+
+	int halfWidth = (width + 1) / 2;
+	int halfHeight = (height + 1) / 2;
+
+	_halfResGBuffer = _renderContext->CreateFramebuffer();
+	_texHalfPosition = _renderContext->CreateTexture2D(1, gls::PixelFormat::RGB16F, halfWidth, halfHeight);
+	_texHalfNormal = _renderContext->CreateTexture2D(1, gls::PixelFormat::RGB16F, halfWidth, halfHeight);
+	_halfResDepthBuffer = _renderContext->CreateTexture2D(1, gls::PixelFormat::Depth24_Stencil8, halfWidth, halfHeight);
+	_halfResGBuffer->AttachTexture(gls::AttachmentBuffer::Color0, _texHalfPosition, 0);
+	_halfResGBuffer->AttachTexture(gls::AttachmentBuffer::Color1, _texHalfNormal, 0);
+	_halfResGBuffer->AttachTexture(gls::AttachmentBuffer::DepthStencil, _halfResDepthBuffer, 0);
+	status = _halfResGBuffer->CheckStatus();
+	assert(status == gls::FramebufferStatus::Complete);
+
+	_renderContext->ActiveColorBuffers(_halfResGBuffer, buffers, 2);
+
+	_halfResLightBuffer = _renderContext->CreateFramebuffer();
+	_texHalfLighting = _renderContext->CreateTexture2D(1, gls::PixelFormat::RGBA16F, halfWidth, halfHeight);
+	_halfResLightBuffer->AttachTexture(gls::AttachmentBuffer::Color0, _texHalfLighting, 0);
+	_halfResLightBuffer->AttachTexture(gls::AttachmentBuffer::DepthStencil, _halfResDepthBuffer, 0);
+	status = _halfResLightBuffer->CheckStatus();
+	assert(status == gls::FramebufferStatus::Complete);
+
+	_renderContext->ActiveColorBuffers(_halfResLightBuffer, buffers, 1);
+
 	buffers[0] = gls::ColorBuffer::BackLeft;
 	_renderContext->ActiveColorBuffers(nullptr, buffers, 1);
 }
@@ -532,10 +866,84 @@ void DeferredRenderer::DestroyFramebuffers()
 		_renderContext->DestroyTexture(_texSceneColor);
 		_texSceneColor = nullptr;
 	}
+
+	if (_transpBuffer)
+	{
+		_renderContext->DestroyFramebuffer(_transpBuffer);
+		_transpBuffer = nullptr;
+	}
+
+	if (_texTranspAccum)
+	{
+		_renderContext->DestroyTexture(_texTranspAccum);
+		_texTranspAccum = nullptr;
+	}
+
+	if (_texTranspRevealage)
+	{
+		_renderContext->DestroyTexture(_texTranspRevealage);
+		_texTranspRevealage = nullptr;
+	}
+
+	if (_halfResGBuffer)
+	{
+		_renderContext->DestroyFramebuffer(_halfResGBuffer);
+		_halfResGBuffer = nullptr;
+	}
+
+	if (_halfResLightBuffer)
+	{
+		_renderContext->DestroyFramebuffer(_halfResLightBuffer);
+		_halfResLightBuffer = nullptr;
+	}
+
+	if (_texHalfPosition)
+	{
+		_renderContext->DestroyTexture(_texHalfPosition);
+		_texHalfPosition = nullptr;
+	}
+
+	if (_texHalfNormal)
+	{
+		_renderContext->DestroyTexture(_texHalfNormal);
+		_texHalfNormal = nullptr;
+	}
+
+	if (_halfResDepthBuffer)
+	{
+		_renderContext->DestroyTexture(_halfResDepthBuffer);
+		_halfResDepthBuffer = nullptr;
+	}
+
+	if (_texHalfLighting)
+	{
+		_renderContext->DestroyTexture(_texHalfLighting);
+		_texHalfLighting = nullptr;
+	}
+}
+
+// The mesh index is the base instance of the draws; single pass shaders read the mesh's lights with it.
+void DeferredRenderer::DrawMesh(const ObjScene::Mesh* mesh)
+{
+	int meshInd = _sponzaScene.GetMeshIndex(*mesh);
+
+	if (_clusterCulling)
+	{
+		const ClusterDrawRange& range = _meshClusterDraws[meshInd];
+		constexpr gls::sizei stride = sizeof(gls::DrawIndexedIndirectData);
+		_renderContext->MultiDrawIndexedIndirect(gls::PrimitiveType::Triangles, _clusterDrawBuf, static_cast<gls::intptr>(range.first) * stride, range.count, stride);
+	}
+	else
+	{
+		const ObjScene::Lod& lod = mesh->lods[_meshLods[meshInd]];
+		_renderContext->DrawIndexedInstanced(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(lod.indexOffset) * 4, 0, lod.numIndices, meshInd, 1);
+	}
 }
 
 void DeferredRenderer::RenderGeometryPass()
 {
+	PROFILE_ZONE("RenderGeometryPass");
+
 	_renderContext->SetFramebuffer(_gbuffer);
 	_renderContext->ClearColorBuffer(_gbuffer, 0, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
 	_renderContext->ClearColorBuffer(_gbuffer, 1, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
@@ -558,7 +966,7 @@ void DeferredRenderer::RenderGeometryPass()
 
 	for (const ObjScene::Mesh* mesh : _visibleObjects)
 	{
-		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+		DrawMesh(mesh);
 	}
 
 	_renderContext->EnableColorWrite(true, true, true, true);
@@ -584,7 +992,7 @@ void DeferredRenderer::RenderGeometryPass()
 			prevMatInd = mesh->materialIndex;
 		}
 
-		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+		DrawMesh(mesh);
 	}
 
 	_renderContext->EnableDepthTest(false);
@@ -592,93 +1000,314 @@ void DeferredRenderer::RenderGeometryPass()
 	_renderContext->DepthTestFunc(gls::CompareFunc::Less);
 }
 
-void DeferredRenderer::RenderLightingPass()
+void DeferredRenderer::DrawViewportRect()
 {
-	_renderContext->SetFramebuffer(_sceneBuffer);
-	_renderContext->ClearColorBuffer(_sceneBuffer, 0, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
-	// Stencil buffer was cleared in the previous pass together with depth buffer, while it was attached to the G-buffer.
-	// We use the content of the depth buffer from the previous pass.
+	_renderContext->ActiveVertexFormat(_vertFmtScreenRect);
+	_renderContext->VertexSource(0, _rectVertBuf, sizeof(SSRectVertex), 0, 0);
+	_renderContext->IndexSource(nullptr, gls::DataType::None);
 
-	_renderContext->SetUniformBuffer(0, _ubufSceneXformData);
-	_renderContext->SetUniformBuffer(1, _ubufLightData);
+	float width = static_cast<float>(_viewportWidth);
+	float height = static_cast<float>(_viewportHeight);
+	SSRectVertex vertices[6];
+	vertices[0].position.set(0.0f, 0.0f);
+	vertices[0].uv.set(0.0f, 0.0f);
+	vertices[1].position.set(width, 0.0f);
+	vertices[1].uv.set(1.0f, 0.0f);
+	vertices[2].position.set(width, height);
+	vertices[2].uv.set(1.0f, 1.0f);
+	vertices[3].position.set(0.0f, 0.0f);
+	vertices[3].uv.set(0.0f, 0.0f);
+	vertices[4].position.set(width, height);
+	vertices[4].uv.set(1.0f, 1.0f);
+	vertices[5].position.set(0.0f, height);
+	vertices[5].uv.set(0.0f, 1.0f);
+	_rectVertBuf->BufferSubData(0, sizeof(vertices), vertices);
 
-	_renderContext->ActiveVertexFormat(_vertFmtSphere);
-	_renderContext->VertexSource(0, _sphereVertBuf, sizeof(math3d::vec3f), 0, 0);
-	_renderContext->IndexSource(_sphereIndexBuf, gls::DataType::UnsignedShort);
-	_renderContext->SetVertexShader(_vertShaderLightingPass);
+	_renderContext->Draw(gls::PrimitiveType::Triangles, 0, 6);
+}
 
-	_renderContext->SetSamplerState(0, _samplerGBuffer);
-	_renderContext->SetSamplerState(1, _samplerGBuffer);
-	_renderContext->SetSamplerState(2, _samplerGBuffer);
+void DeferredRenderer::DownsampleGBuffer()
+{
+	PROFILE_ZONE("DownsampleGBuffer");
 
-	_renderContext->SetSamplerTexture(0, _texDiffuse);
-	_renderContext->SetSamplerTexture(1, _texPosition);
-	_renderContext->SetSamplerTexture(2, _texNormal);
+	// Copies every other pixel's position, normal and depth. The depth makes the light volumes' depth and stencil
+	// tests work at half resolution the same way as at full.
+
+	_renderContext->Viewport(0, 0, (_renderWidth + 1) / 2, (_renderHeight + 1) / 2);
+	_renderContext->SetFramebuffer(_halfResGBuffer);
+	_renderContext->ClearDepthStencilBuffer(_halfResGBuffer, 1.0f, 0);
 
-	_renderContext->BlendingFunc(gls::BlendFunc::One, gls::BlendFunc::One);
-	_renderContext->EnableStencilTest(true);
 	_renderContext->EnableDepthTest(true);
-	_renderContext->EnableDepthWrite(false);
-	_renderContext->StencilOperation(gls::PolygonFace::Front, gls::StencilOp::Keep, gls::StencilOp::Replace, gls::StencilOp::Keep);
-	_renderContext->StencilOperation(gls::PolygonFace::Back, gls::StencilOp::Keep, gls::StencilOp::Keep, gls::StencilOp::Keep);
+	_renderContext->DepthTestFunc(gls::CompareFunc::AlwaysPass);
 
-	gls::uint stencilRefVal = 0;
+	_renderContext->SetUniformBuffer(0, _ubufSceneXformData);
+	_renderContext->SetVertexShader(_vertShaderScreenSpace);
+	_renderContext->SetFragmentShader(_fragShaderDownsampleGBuffer);
 
-	for (auto light : _visibleLights)
-	{
-		// Clear the stencil buffer each time we wrap the stencil reference value.
-		stencilRefVal = (stencilRefVal + 1) % 256;
-		if (stencilRefVal == 0)
-		{
-			_renderContext->ClearStencilBuffer(_sceneBuffer, 0);
-			stencilRefVal = 1;
-		}
+	_renderContext->SetSamplerState(0, nullptr);
+	_renderContext->SetSamplerTexture(0, _depthBuffer);
+	_renderContext->SetSamplerState(1, nullptr);
+	_renderContext->SetSamplerTexture(1, _texPosition);
+	_renderContext->SetSamplerState(2, nullptr);
+	_renderContext->SetSamplerTexture(2, _texNormal);
 
-		// Draw front faces of the light sphere, marking pixels in the stencil buffer when the depth test fails.
+	DrawViewportRect();
 
-		UniformLightData lightData = {
-			math3d::vec4f(light->position, light->radius * _lightRadiusScale),
-			math3d::vec4f(light->color, light->falloffExponent)
-		};
-		_ubufLightData->BufferSubData(0, sizeof(lightData), &lightData);
+	_renderContext->DepthTestFunc(gls::CompareFunc::Less);
+	_renderContext->EnableDepthTest(false);
+}
 
-		_renderContext->SetFragmentShader(nullptr);
+void DeferredRenderer::ClassifyLights()
+{
+	PROFILE_ZONE("ClassifyLights");
 
-		_renderContext->EnableColorWrite(false, false, false, false);
+	_lightQuadVerts.clear();
+	_sphereLights.clear();
 
-		_renderContext->StencilTestFunc(gls::PolygonFace::Front, gls::CompareFunc::AlwaysPass, stencilRefVal, 0);
+	if (!_smallLightQuads || !IsShaderReady(_vertShaderLightQuad) || !IsShaderReady(_fragShaderLightingPassQuad))
+	{
+		_sphereLights.assign(_visibleLights.begin(), _visibleLights.end());
+		_quadShadedLights = 0;
+		return;
+	}
 
-		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, 0, 0, _sphereIndexCount);
+	for (size_t i = 0; i < _visibleLights.size(); ++i)
+	{
+		const PointLight* light = _visibleLights[i];
+		math3d::vec3f center = light->position * _viewMat;
+		float radius = light->radius * _lightRadiusScale;
 
-		_renderContext->EnableColorWrite(true, true, true, true);
+		// A camera inside the sphere sees the light in every direction, so it covers the whole screen. Otherwise the
+		// rect bounds the light's view-space box, clipped against the near plane where it crosses it. The box is
+		// axis-aligned, so the clipped box's front face lies on the near plane, and its corners are the points
+		// where the box edges cross it.
 
-		// Draw back faces of the light sphere using the GBuffer and set depth function to greater, affecting only pixels where stencil
-		// value is not marked by previous draw and the back of the sphere is behind visible surfaces. Add light contribution by blending.
+		math3d::vec2f rectMin(-1.0f, -1.0f);
+		math3d::vec2f rectMax(1.0f, 1.0f);
 
-		_renderContext->SetFragmentShader(_fragShaderLightingPass);
+		if (center.length() >= radius)
+		{
+			float backZ = center.z - radius;
+			float frontZ = std::min(center.z + radius, -NearPlane);
+			if (backZ >= frontZ)
+				continue;
 
-		_renderContext->EnableDepthClamp(true);
-		_renderContext->EnableBlending(true);
-		_renderContext->CullFace(gls::PolygonFace::Front);
+			rectMin.set(FLT_MAX, FLT_MAX);
+			rectMax.set(-FLT_MAX, -FLT_MAX);
 
-		_renderContext->StencilTestFunc(gls::PolygonFace::Back, gls::CompareFunc::NotEqual, stencilRefVal, static_cast<gls::uint>(-1));
-		_renderContext->DepthTestFunc(gls::CompareFunc::Greater);
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				math3d::vec4f pt(
+					center.x + (corner & 1 ? radius : -radius),
+					center.y + (corner & 2 ? radius : -radius),
+					corner & 4 ? frontZ : backZ,
+					1.0f);
+				pt = pt * _projMat;
+				math3d::vec2f ndc(pt.x / pt.w, pt.y / pt.w);
+				rectMin.set(std::min(rectMin.x, ndc.x), std::min(rectMin.y, ndc.y));
+				rectMax.set(std::max(rectMax.x, ndc.x), std::max(rectMax.y, ndc.y));
+			}
 
-		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, 0, 0, _sphereIndexCount);
+			rectMin.set(std::max(rectMin.x, -1.0f), std::max(rectMin.y, -1.0f));
+			rectMax.set(std::min(rectMax.x, 1.0f), std::min(rectMax.y, 1.0f));
 
-		_renderContext->EnableDepthClamp(false);
-		_renderContext->EnableBlending(false);
-		_renderContext->CullFace(gls::PolygonFace::Back);
-		_renderContext->DepthTestFunc(gls::CompareFunc::Less);
+			float screenFraction = (rectMax.x - rectMin.x) * (rectMax.y - rectMin.y) * 0.25f;
+			if (screenFraction > SmallLightMaxScreenFraction)
+			{
+				_sphereLights.push_back(light);
+				continue;
+			}
+		}
+
+		// The back of the sphere, clamped to the depth range like the sphere's back faces are with depth clamping.
+		math3d::vec4f backPt(0.0f, 0.0f, -std::clamp(-center.z + radius, NearPlane, FarPlane), 1.0f);
+		backPt = backPt * _projMat;
+		float depth = backPt.z / backPt.w;
+		float index = static_cast<float>(i);
+
+		_lightQuadVerts.emplace_back(rectMin.x, rectMin.y, depth, index);
+		_lightQuadVerts.emplace_back(rectMax.x, rectMin.y, depth, index);
+		_lightQuadVerts.emplace_back(rectMax.x, rectMax.y, depth, index);
+		_lightQuadVerts.emplace_back(rectMin.x, rectMin.y, depth, index);
+		_lightQuadVerts.emplace_back(rectMax.x, rectMax.y, depth, index);
+		_lightQuadVerts.emplace_back(rectMin.x, rectMax.y, depth, index);
+	}
+
+	_quadShadedLights = static_cast<int>(_lightQuadVerts.size() / 6);
+}
+
+void DeferredRenderer::RenderLightingPass()
+{
+	PROFILE_ZONE("RenderLightingPass");
+
+	// Half resolution lighting shades the downsampled G-buffer, accumulating only the light reaching the surfaces,
+	// and applies it to the full resolution albedo afterwards.
+	bool halfRes = _halfResLighting &&
+		IsShaderReady(_fragShaderDownsampleGBuffer) && IsShaderReady(_fragShaderLightingUpsample) &&
+		IsShaderReady(_fragShaderLightingPassHalfRes) && IsShaderReady(_fragShaderLightingPassQuadHalfRes);
+
+	if (halfRes)
+		DownsampleGBuffer();
+
+	ClassifyLights();
+
+	gls::IFramebuffer* lightBuffer = halfRes ? _halfResLightBuffer : _sceneBuffer;
+	gls::IFragmentShader* fragShader = halfRes ? _fragShaderLightingPassHalfRes : _fragShaderLightingPass;
+	gls::IFragmentShader* fragShaderQuad = halfRes ? _fragShaderLightingPassQuadHalfRes : _fragShaderLightingPassQuad;
+
+	_renderContext->SetFramebuffer(lightBuffer);
+	_renderContext->ClearColorBuffer(lightBuffer, 0, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
+	// Stencil buffer was cleared in the previous pass together with depth buffer, while it was attached to the G-buffer
+	// (or the downsampled G-buffer). We use the content of the depth buffer from the previous pass.
+
+	_renderContext->SetUniformBuffer(0, _ubufSceneXformData);
+	_renderContext->SetUniformBuffer(1, _ubufLightData);
+
+	_renderContext->SetSamplerState(0, _samplerGBuffer);
+	_renderContext->SetSamplerState(1, _samplerGBuffer);
+	_renderContext->SetSamplerState(2, _samplerGBuffer);
+
+	_renderContext->SetSamplerTexture(0, _texDiffuse);
+	_renderContext->SetSamplerTexture(1, halfRes ? _texHalfPosition : _texPosition);
+	_renderContext->SetSamplerTexture(2, halfRes ? _texHalfNormal : _texNormal);
+
+	_renderContext->BlendingFunc(gls::BlendFunc::One, gls::BlendFunc::One);
+	_renderContext->EnableDepthTest(true);
+	_renderContext->EnableDepthWrite(false);
+
+	// Small lights are drawn together as screen aligned quads covering their projected bounds. The quads lie at the
+	// depth of the back of the light sphere, so the depth test discards pixels behind the light like the sphere's back
+	// faces do. Surfaces in front of the light are shaded, but are too far from it to get any light.
+
+	if (!_lightQuadVerts.empty())
+	{
+		PROFILE_ZONE("LightQuads");
+
+		_lightQuadVertBuf->BufferSubData(0, sizeof(math3d::vec4f) * _lightQuadVerts.size(), _lightQuadVerts.data());
+
+		_renderContext->ActiveVertexFormat(_vertFmtLightQuad);
+		_renderContext->VertexSource(0, _lightQuadVertBuf, sizeof(math3d::vec4f), 0, 0);
+		_renderContext->IndexSource(nullptr, gls::DataType::None);
+		_renderContext->SetVertexShader(_vertShaderLightQuad);
+		_renderContext->SetFragmentShader(fragShaderQuad);
+		_renderContext->SetSamplerState(3, nullptr);
+		_renderContext->SetSamplerTexture(3, _lightInfoTex);
+
+		_renderContext->EnableBlending(true);
+		_renderContext->DepthTestFunc(gls::CompareFunc::Greater);
+
+		_renderContext->Draw(gls::PrimitiveType::Triangles, 0, static_cast<int>(_lightQuadVerts.size()));
+
+		_renderContext->EnableBlending(false);
+		_renderContext->DepthTestFunc(gls::CompareFunc::Less);
+	}
+
+	_renderContext->ActiveVertexFormat(_vertFmtSphere);
+	_renderContext->VertexSource(0, _sphereVertBuf, sizeof(math3d::vec3f), 0, 0);
+	_renderContext->IndexSource(_sphereIndexBuf, gls::DataType::UnsignedShort);
+	_renderContext->SetVertexShader(_vertShaderLightingPass);
+
+	_renderContext->EnableStencilTest(true);
+	_renderContext->StencilOperation(gls::PolygonFace::Front, gls::StencilOp::Keep, gls::StencilOp::Replace, gls::StencilOp::Keep);
+	_renderContext->StencilOperation(gls::PolygonFace::Back, gls::StencilOp::Keep, gls::StencilOp::Keep, gls::StencilOp::Keep);
+
+	gls::uint stencilRefVal = 0;
+
+	for (auto light : _sphereLights)
+	{
+		// Clear the stencil buffer each time we wrap the stencil reference value.
+		stencilRefVal = (stencilRefVal + 1) % 256;
+		if (stencilRefVal == 0)
+		{
+			_renderContext->ClearStencilBuffer(lightBuffer, 0);
+			stencilRefVal = 1;
+		}
+
+		// Draw front faces of the light sphere, marking pixels in the stencil buffer when the depth test fails.
+
+		UniformLightData lightData = {
+			math3d::vec4f(light->position, light->radius * _lightRadiusScale),
+			math3d::vec4f(light->color, light->falloffExponent)
+		};
+		_ubufLightData->BufferSubData(0, sizeof(lightData), &lightData);
+
+		_renderContext->SetFragmentShader(nullptr);
+
+		_renderContext->EnableColorWrite(false, false, false, false);
+
+		_renderContext->StencilTestFunc(gls::PolygonFace::Front, gls::CompareFunc::AlwaysPass, stencilRefVal, 0);
+
+		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, 0, 0, _sphereIndexCount);
+
+		_renderContext->EnableColorWrite(true, true, true, true);
+
+		// Draw back faces of the light sphere using the GBuffer and set depth function to greater, affecting only pixels where stencil
+		// value is not marked by previous draw and the back of the sphere is behind visible surfaces. Add light contribution by blending.
+
+		_renderContext->SetFragmentShader(fragShader);
+
+		_renderContext->EnableDepthClamp(true);
+		_renderContext->EnableBlending(true);
+		_renderContext->CullFace(gls::PolygonFace::Front);
+
+		_renderContext->StencilTestFunc(gls::PolygonFace::Back, gls::CompareFunc::NotEqual, stencilRefVal, static_cast<gls::uint>(-1));
+		_renderContext->DepthTestFunc(gls::CompareFunc::Greater);
+
+		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, 0, 0, _sphereIndexCount);
+
+		_renderContext->EnableDepthClamp(false);
+		_renderContext->EnableBlending(false);
+		_renderContext->CullFace(gls::PolygonFace::Back);
+		_renderContext->DepthTestFunc(gls::CompareFunc::Less);
 	}
 
 	_renderContext->EnableStencilTest(false);
 	_renderContext->EnableDepthTest(false);
 	_renderContext->EnableDepthWrite(true);
+
+	if (halfRes)
+		UpsampleLighting();
+}
+
+void DeferredRenderer::UpsampleLighting()
+{
+	PROFILE_ZONE("UpsampleLighting");
+
+	// Each pixel blends the nearest half resolution samples, weighted by how close they are to the pixel's surface,
+	// so that light doesn't bleed across edges.
+
+	_renderContext->Viewport(0, 0, _renderWidth, _renderHeight);
+	_renderContext->SetFramebuffer(_sceneBuffer);
+	_renderContext->ClearColorBuffer(_sceneBuffer, 0, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
+
+	// With a scaled down resolution the half resolution buffers hold stale data past the region lit this frame.
+	UniformUpsampleData upsampleData;
+	upsampleData.halfMaxCoords[0] = (_renderWidth + 1) / 2 - 1;
+	upsampleData.halfMaxCoords[1] = (_renderHeight + 1) / 2 - 1;
+	_ubufUpsampleData->BufferSubData(0, sizeof(UniformUpsampleData), &upsampleData);
+
+	_renderContext->SetUniformBuffer(1, _ubufUpsampleData);
+	_renderContext->SetVertexShader(_vertShaderScreenSpace);
+	_renderContext->SetFragmentShader(_fragShaderLightingUpsample);
+
+	_renderContext->SetSamplerTexture(0, _texDiffuse);
+	_renderContext->SetSamplerTexture(1, _texPosition);
+	_renderContext->SetSamplerTexture(2, _texNormal);
+	_renderContext->SetSamplerState(3, nullptr);
+	_renderContext->SetSamplerTexture(3, _texHalfLighting);
+	_renderContext->SetSamplerState(4, nullptr);
+	_renderContext->SetSamplerTexture(4, _texHalfPosition);
+	_renderContext->SetSamplerState(5, nullptr);
+	_renderContext->SetSamplerTexture(5, _texHalfNormal);
+
+	DrawViewportRect();
 }
 
 void DeferredRenderer::RenderGBufferPreview()
 {
+	PROFILE_ZONE("RenderGBufferPreview");
+
+	_renderContext->Viewport(0, 0, _viewportWidth, _viewportHeight);
 	_renderContext->SetFramebuffer(nullptr);
 	_renderContext->ClearColorBuffer(nullptr, 0, math3d::vec4f(0.1f, 0.3f, 0.3f, 1.0f));
 
@@ -695,6 +1324,8 @@ void DeferredRenderer::RenderGBufferPreview()
 	const int rows = 2, cols = 2;
 	float width = static_cast<float>(_viewportWidth) / cols;
 	float height = static_cast<float>(_viewportHeight)/ rows;
+	float u = static_cast<float>(_renderWidth) / _viewportWidth;
+	float v = static_cast<float>(_renderHeight) / _viewportHeight;
 	SSRectVertex vertices[rows * cols * 6];
 	for (int r = 0; r < rows; ++r)
 	{
@@ -704,15 +1335,15 @@ void DeferredRenderer::RenderGBufferPreview()
 			vertices[index + 0].position.set(x1 + c * width, y1 + r * height);
 			vertices[index + 0].uv.set(0.0f, 0.0f);
 			vertices[index + 1].position.set(x1 + c * width + width, y1 + r * height);
-			vertices[index + 1].uv.set(1.0f, 0.0f);
+			vertices[index + 1].uv.set(u, 0.0f);
 			vertices[index + 2].position.set(x1 + c * width + width, y1 + r * height + height);
-			vertices[index + 2].uv.set(1.0f, 1.0f);
+			vertices[index + 2].uv.set(u, v);
 			vertices[index + 3].position.set(x1 + c * width, y1 + r * height);
 			vertices[index + 3].uv.set(0.0f, 0.0f);
 			vertices[index + 4].position.set(x1 + c * width + width, y1 + r * height + height);
-			vertices[index + 4].uv.set(1.0f, 1.0f);
+			vertices[index + 4].uv.set(u, v);
 			vertices[index + 5].position.set(x1 + c * width, y1 + r * height + height);
-			vertices[index + 5].uv.set(0.0f, 1.0f);
+			vertices[index + 5].uv.set(0.0f, v);
 		}
 	}
 	_rectVertBuf->BufferSubData(0, sizeof(SSRectVertex) * rows * cols * 6, vertices);
@@ -756,6 +1387,8 @@ void DeferredRenderer::RenderGBufferPreview()
 
 void DeferredRenderer::RenderForward()
 {
+	PROFILE_ZONE("RenderForward");
+
 	_renderContext->SetFramebuffer(_sceneBuffer);
 	_renderContext->ClearColorBuffer(_sceneBuffer, 0, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
 	_renderContext->ClearDepthStencilBuffer(_sceneBuffer, 1.0f, 0);
@@ -775,7 +1408,7 @@ void DeferredRenderer::RenderForward()
 
 	for (const ObjScene::Mesh* mesh : _visibleObjects)
 	{
-		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+		DrawMesh(mesh);
 	}
 
 	// Draw lit objects.
@@ -798,9 +1431,9 @@ void DeferredRenderer::RenderForward()
 
 	for (size_t objInd = 0; objInd < _visibleObjects.size(); ++objInd)
 	{
-		const std::vector<int32_t>& lightIndices = _interactions[objInd];
+		LightRange lights = GetInteractions(objInd);
 
-		if (lightIndices.size() > 0)
+		if (lights.count > 0)
 		{
 			const ObjScene::Mesh* mesh = _visibleObjects[objInd];
 
@@ -812,16 +1445,16 @@ void DeferredRenderer::RenderForward()
 				prevMatInd = mesh->materialIndex;
 			}
 
-			for (int32_t lightIndex : lightIndices)
+			for (int32_t i = lights.first; i < lights.first + lights.count; ++i)
 			{
-				const PointLight* light = _visibleLights[lightIndex];
+				const PointLight* light = _visibleLights[_interactionLights[i]];
 				UniformLightData lightData = {
 					math3d::vec4f(light->position, light->radius * _lightRadiusScale),
 					math3d::vec4f(light->color, light->falloffExponent)
 				};
 				_ubufLightData->BufferSubData(0, sizeof(lightData), &lightData);
 
-				_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+				DrawMesh(mesh);
 			}
 		}
 	}
@@ -834,6 +1467,8 @@ void DeferredRenderer::RenderForward()
 
 void DeferredRenderer::RenderForwardSinglePass()
 {
+	PROFILE_ZONE("RenderForwardSinglePass");
+
 	_renderContext->SetFramebuffer(_sceneBuffer);
 	_renderContext->ClearColorBuffer(_sceneBuffer, 0, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
 	_renderContext->ClearDepthStencilBuffer(_sceneBuffer, 1.0f, 0);
@@ -853,7 +1488,7 @@ void DeferredRenderer::RenderForwardSinglePass()
 
 	for (const ObjScene::Mesh* mesh : _visibleObjects)
 	{
-		_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+		DrawMesh(mesh);
 	}
 
 	// Draw lit objects.
@@ -862,9 +1497,9 @@ void DeferredRenderer::RenderForwardSinglePass()
 	_renderContext->DepthTestFunc(gls::CompareFunc::Equal);
 	_renderContext->EnableDepthWrite(false);
 
-	_renderContext->SetUniformBuffer(1, _ubufLightData);
-	_renderContext->SetVertexShader(_vertShaderForward);
-	_renderContext->SetFragmentShader(_fragShaderForwardSP);
+	_renderContext->SetVertexShader(_vertShaderForwardSP);
+	_renderContext->ActiveVertexFormat(_vertFmtLightRange);
+	_renderContext->VertexSource(1, _meshLightRangeBuf, sizeof(LightRange), 0, 1);
 
 	_renderContext->SetSamplerState(0, _samplerSurfaceTex);
 	_renderContext->SetSamplerState(1, _samplerSurfaceTex);
@@ -874,16 +1509,23 @@ void DeferredRenderer::RenderForwardSinglePass()
 	_renderContext->SetSamplerTexture(3, _lightInfoTex);
 
 	int prevMatInd = -1;
+	gls::IFragmentShader* prevFragShader = nullptr;
 
 	for (size_t objInd = 0; objInd < _visibleObjects.size(); ++objInd)
 	{
-		const std::vector<int32_t>& lightIndices = _interactions[objInd];
-		int32_t numLights = static_cast<int32_t>(lightIndices.size());
+		int32_t numLights = GetInteractions(objInd).count;
 
 		if (numLights > 0)
 		{
 			const ObjScene::Mesh* mesh = _visibleObjects[objInd];
 
+			gls::IFragmentShader* fragShader = SelectLightLoopShader(_fragShaderForwardSPBuckets, _fragShaderForwardSP, numLights);
+			if (fragShader != prevFragShader)
+			{
+				_renderContext->SetFragmentShader(fragShader);
+				prevFragShader = fragShader;
+			}
+
 			if (mesh->materialIndex != prevMatInd)
 			{
 				const ObjScene::Material& material = _sponzaScene.GetMaterial(mesh->materialIndex);
@@ -892,10 +1534,7 @@ void DeferredRenderer::RenderForwardSinglePass()
 				prevMatInd = mesh->materialIndex;
 			}
 
-			_ubufLightData->BufferSubData(0, sizeof(int32_t), &numLights);
-			_lightIndexBuf->BufferSubData(0, sizeof(int32_t) * numLights, lightIndices.data());
-
-			_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+			DrawMesh(mesh);
 		}
 	}
 
@@ -906,6 +1545,8 @@ void DeferredRenderer::RenderForwardSinglePass()
 
 void DeferredRenderer::RenderForwardTransparent()
 {
+	PROFILE_ZONE("RenderForwardTransparent");
+
 	_renderContext->ActiveVertexFormat(_vertexFormat);
 	_renderContext->VertexSource(0, _sponzaScene.GetVertexBuffer(), sizeof(ObjScene::Vertex), 0, 0);
 	_renderContext->IndexSource(_sponzaScene.GetIndexBuffer(), gls::DataType::UnsignedInt);
@@ -926,9 +1567,9 @@ void DeferredRenderer::RenderForwardTransparent()
 
 	for (size_t objInd = 0; objInd < _visibleTranspObjects.size(); ++objInd)
 	{
-		const std::vector<int32_t>& lightIndices = _transpInteractions[objInd];
+		LightRange lights = GetTranspInteractions(objInd);
 
-		if (lightIndices.size() > 0)
+		if (lights.count > 0)
 		{
 			const ObjScene::Mesh* mesh = _visibleTranspObjects[objInd];
 
@@ -943,9 +1584,9 @@ void DeferredRenderer::RenderForwardTransparent()
 			int lightCount = 0;
 			_renderContext->BlendingFunc(gls::BlendFunc::SrcAlpha, gls::BlendFunc::OneMinusSrcAlpha);
 
-			for (int32_t lightIndex : lightIndices)
+			for (int32_t i = lights.first; i < lights.first + lights.count; ++i)
 			{
-				const PointLight* light = _visibleLights[lightIndex];
+				const PointLight* light = _visibleLights[_interactionLights[i]];
 				UniformLightData lightData = {
 					math3d::vec4f(light->position, light->radius * _lightRadiusScale),
 					math3d::vec4f(light->color, light->falloffExponent)
@@ -960,7 +1601,7 @@ void DeferredRenderer::RenderForwardTransparent()
 					_renderContext->DepthTestFunc(gls::CompareFunc::Equal);
 				}
 
-				_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+				DrawMesh(mesh);
 				++lightCount;
 			}
 
@@ -976,14 +1617,15 @@ void DeferredRenderer::RenderForwardTransparent()
 
 void DeferredRenderer::RenderForwardTransparentSinglePass()
 {
-	_renderContext->ActiveVertexFormat(_vertexFormat);
+	PROFILE_ZONE("RenderForwardTransparentSinglePass");
+
+	_renderContext->ActiveVertexFormat(_vertFmtLightRange);
 	_renderContext->VertexSource(0, _sponzaScene.GetVertexBuffer(), sizeof(ObjScene::Vertex), 0, 0);
+	_renderContext->VertexSource(1, _meshLightRangeBuf, sizeof(LightRange), 0, 1);
 	_renderContext->IndexSource(_sponzaScene.GetIndexBuffer(), gls::DataType::UnsignedInt);
 
 	_renderContext->SetUniformBuffer(0, _ubufSceneXformData);
-	_renderContext->SetUniformBuffer(1, _ubufLightData);
-	_renderContext->SetVertexShader(_vertShaderForward);
-	_renderContext->SetFragmentShader(_fragShaderForwardTranspSP);
+	_renderContext->SetVertexShader(_vertShaderForwardSP);
 
 	_renderContext->EnableDepthTest(true);
 	_renderContext->EnableFaceCulling(false);
@@ -998,16 +1640,23 @@ void DeferredRenderer::RenderForwardTransparentSinglePass()
 	_renderContext->SetSamplerTexture(3, _lightInfoTex);
 
 	int prevMatInd = -1;
+	gls::IFragmentShader* prevFragShader = nullptr;
 
 	for (size_t objInd = 0; objInd < _visibleTranspObjects.size(); ++objInd)
 	{
-		const std::vector<int32_t>& lightIndices = _transpInteractions[objInd];
-		int32_t numLights = static_cast<int32_t>(lightIndices.size());
+		int32_t numLights = GetTranspInteractions(objInd).count;
 
 		if (numLights > 0)
 		{
 			const ObjScene::Mesh* mesh = _visibleTranspObjects[objInd];
 
+			gls::IFragmentShader* fragShader = SelectLightLoopShader(_fragShaderForwardTranspSPBuckets, _fragShaderForwardTranspSP, numLights);
+			if (fragShader != prevFragShader)
+			{
+				_renderContext->SetFragmentShader(fragShader);
+				prevFragShader = fragShader;
+			}
+
 			if (mesh->materialIndex != prevMatInd)
 			{
 				const ObjScene::Material& material = _sponzaScene.GetMaterial(mesh->materialIndex);
@@ -1016,20 +1665,129 @@ void DeferredRenderer::RenderForwardTransparentSinglePass()
 				prevMatInd = mesh->materialIndex;
 			}
 
-			_ubufLightData->BufferSubData(0, sizeof(int32_t), &numLights);
-			_lightIndexBuf->BufferSubData(0, sizeof(int32_t) * numLights, lightIndices.data());
+			DrawMesh(mesh);
+		}
+	}
+
+	_renderContext->EnableDepthTest(false);
+	_renderContext->EnableBlending(false);
+	_renderContext->EnableFaceCulling(true);
+}
+
+void DeferredRenderer::RenderTransparentOIT()
+{
+	PROFILE_ZONE("RenderTransparentOIT");
+
+	if (_visibleTranspObjects.empty())
+		return;
+
+	// All transparent surfaces are drawn once, in any order. Their weighted colors are summed in the accumulation
+	// buffer and the revealage buffer keeps the product of (1 - alpha), which is how much of the background shows
+	// through. The resolve pass then blends the weighted average color over the scene.
+
+	_renderContext->SetFramebuffer(_transpBuffer);
+	_renderContext->ClearColorBuffer(_transpBuffer, 0, math3d::vec4f(0.0f, 0.0f, 0.0f, 0.0f));
+	_renderContext->ClearColorBuffer(_transpBuffer, 1, math3d::vec4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+	_renderContext->ActiveVertexFormat(_vertFmtLightRange);
+	_renderContext->VertexSource(0, _sponzaScene.GetVertexBuffer(), sizeof(ObjScene::Vertex), 0, 0);
+	_renderContext->VertexSource(1, _meshLightRangeBuf, sizeof(LightRange), 0, 1);
+	_renderContext->IndexSource(_sponzaScene.GetIndexBuffer(), gls::DataType::UnsignedInt);
+
+	_renderContext->SetUniformBuffer(0, _ubufSceneXformData);
+	_renderContext->SetVertexShader(_vertShaderForwardSP);
+
+	_renderContext->EnableDepthTest(true);
+	_renderContext->EnableDepthWrite(false);
+	_renderContext->EnableFaceCulling(false);
+	_renderContext->EnableBlending(true);
+	_renderContext->BlendingFunc(0, gls::BlendFunc::One, gls::BlendFunc::One);
+	_renderContext->BlendingFunc(1, gls::BlendFunc::Zero, gls::BlendFunc::OneMinusSrcColor);
+
+	_renderContext->SetSamplerState(0, _samplerSurfaceTex);
+	_renderContext->SetSamplerState(1, _samplerSurfaceTex);
+	_renderContext->SetSamplerState(2, nullptr);
+	_renderContext->SetSamplerTexture(2, _lightIndexTex);
+	_renderContext->SetSamplerState(3, nullptr);
+	_renderContext->SetSamplerTexture(3, _lightInfoTex);
+
+	int prevMatInd = -1;
+	gls::IFragmentShader* prevFragShader = nullptr;
+
+	for (size_t objInd = 0; objInd < _visibleTranspObjects.size(); ++objInd)
+	{
+		int32_t numLights = GetTranspInteractions(objInd).count;
+
+		if (numLights > 0)
+		{
+			const ObjScene::Mesh* mesh = _visibleTranspObjects[objInd];
+
+			gls::IFragmentShader* fragShader = SelectLightLoopShader(_fragShaderForwardTranspOITBuckets, _fragShaderForwardTranspOIT, numLights);
+			if (fragShader != prevFragShader)
+			{
+				_renderContext->SetFragmentShader(fragShader);
+				prevFragShader = fragShader;
+			}
+
+			if (mesh->materialIndex != prevMatInd)
+			{
+				const ObjScene::Material& material = _sponzaScene.GetMaterial(mesh->materialIndex);
+				_renderContext->SetSamplerTexture(0, material.diffuseTexture);
+				_renderContext->SetSamplerTexture(1, material.normalTexture);
+				prevMatInd = mesh->materialIndex;
+			}
 
-			_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, static_cast<gls::intptr>(mesh->indexOffset) * 4, 0, mesh->numIndices);
+			DrawMesh(mesh);
 		}
 	}
 
 	_renderContext->EnableDepthTest(false);
+	_renderContext->EnableDepthWrite(true);
+
+	// Resolve over the whole viewport. dst = color * (1 - revealage) + dst * revealage
+
+	_renderContext->SetFramebuffer(_sceneBuffer);
+	_renderContext->BlendingFunc(gls::BlendFunc::OneMinusSrcAlpha, gls::BlendFunc::SrcAlpha);
+
+	_renderContext->SetVertexShader(_vertShaderScreenSpace);
+	_renderContext->SetFragmentShader(_fragShaderTranspResolve);
+
+	_renderContext->SetSamplerState(0, nullptr);
+	_renderContext->SetSamplerTexture(0, _texTranspAccum);
+	_renderContext->SetSamplerState(1, nullptr);
+	_renderContext->SetSamplerTexture(1, _texTranspRevealage);
+
+	DrawViewportRect();
+
 	_renderContext->EnableBlending(false);
 	_renderContext->EnableFaceCulling(true);
 }
 
+void DeferredRenderer::RenderTransparentSurfaces()
+{
+	if (_oitTransparency && IsShaderReady(_fragShaderForwardTranspOIT) && IsShaderReady(_fragShaderTranspResolve))
+		RenderTransparentOIT();
+	else if (_renderPath == RenderPath::Forward && IsShaderReady(_fragShaderForwardTransp))
+		RenderForwardTransparent();
+	else if (_renderPath != RenderPath::Forward && IsShaderReady(_fragShaderForwardTranspSP))
+		RenderForwardTransparentSinglePass();
+}
+
+void DeferredRenderer::BlitSceneToScreen()
+{
+	_renderContext->Viewport(0, 0, _viewportWidth, _viewportHeight);
+
+	// Scaled down frames are upscaled with bilinear filtering.
+	bool scaled = _renderWidth != _viewportWidth || _renderHeight != _viewportHeight;
+	_renderContext->BlitFramebuffer(
+		_sceneBuffer, gls::ColorBuffer::Color0, 0, 0, _renderWidth, _renderHeight,
+		nullptr, 0, 0, _viewportWidth, _viewportHeight, gls::COLOR_BUFFER_BIT, scaled ? gls::TexFilter::Linear : gls::TexFilter::Nearest);
+}
+
 void DeferredRenderer::RenderLightSources()
 {
+	PROFILE_ZONE("RenderLightSources");
+
 	_renderContext->SetUniformBuffer(0, _ubufSceneXformData);
 
 	_renderContext->SetVertexShader(_vertShaderLightSource);
@@ -1053,7 +1811,30 @@ void DeferredRenderer::Update(float frameTime)
 	if (_renderContext == nullptr)
 		return;
 
-	_demoPlayer.Update(frameTime);
+	PROFILE_ZONE("Update");
+
+	// Allocations are counted from the start of one update to the start of the next, which covers a whole frame.
+	uint64_t heapAllocations = GetHeapAllocationCount();
+	_frameHeapAllocations = static_cast<int>(heapAllocations - _frameStartHeapAllocations);
+	_frameStartHeapAllocations = heapAllocations;
+
+	ResetFrameData();
+
+	// In fixed step benchmark mode the demo advances by the same amount every frame, so each render path draws
+	// exactly the same sequence of frames. Warm-up frames hold the demo at its start.
+
+	float simTime = frameTime;
+	if (_runMode == RunMode::Benchmark)
+	{
+		_frameStartTime = std::chrono::high_resolution_clock::now();
+		if (_benchmarkData.fixedStep)
+			simTime = _benchmarkData.framesToSkip > 0 ? 0.0f : BenchmarkData::FixedStepDt;
+	}
+
+	_demoPlayer.Update(simTime);
+
+	if (!_pendingShaders.empty())
+		FinishPendingShaderBuilds(false);
 
 	// Update ImGui data.
 
@@ -1073,6 +1854,8 @@ void DeferredRenderer::Update(float frameTime)
 		_framerateValues.back() = _imGuiIO->Framerate;
 	}
 
+	UpdateResolutionScale();
+
 	// If the demo or benchmark is running, update it.
 
 	if (_runMode == RunMode::Benchmark)
@@ -1097,8 +1880,8 @@ void DeferredRenderer::Update(float frameTime)
 	// Update camera, light positions and find lights and objects which are inside the current view frustum.
 	// Light-object interactions are updated only for render paths that need them.
 
-	UpdateCamera(frameTime);
-	UpdateLights(frameTime);
+	UpdateCamera(simTime);
+	UpdateLights(simTime);
 	UpdateVisibleObjects();
 	UpdateLightObjectInteractions();
 
@@ -1118,24 +1901,75 @@ void DeferredRenderer::Update(float frameTime)
 	xformData.viewport.set(0.0f, 0.0f, static_cast<float>(_viewportWidth), static_cast<float>(_viewportHeight));
 	_ubufSceneXformData->BufferSubData(0, sizeof(UniformSceneXformData), &xformData);
 
-	// Update light info buffer (necessary only for forward single pass rendering or when showing light sources).
+	// Make room for all visible lights, and upload the interactions for the single pass paths.
 
-	if (_showLightSources || _renderPath == RenderPath::ForwardSinglePass || (_renderPath == RenderPath::Deferred && _showTranspSurfaces))
+	ReserveLightBuffers(_visibleLights.size());
+
+	if (_renderPath == RenderPath::ForwardSinglePass ||
+		(_showTranspSurfaces && (_renderPath != RenderPath::Forward || _oitTransparency)))
+		UploadInteractions();
+
+	// Update light info buffer (necessary only for single pass lighting or when showing light sources).
+
+	if (_showLightSources || _renderPath == RenderPath::ForwardSinglePass ||
+		(_renderPath == RenderPath::Deferred && _smallLightQuads) ||
+		(_showTranspSurfaces && (_renderPath == RenderPath::Deferred || _oitTransparency)))
 	{
-		UniformLightData lightInfo[MaxLights];
+		PROFILE_ZONE("UploadLightData");
+
 		size_t numVisLights = _visibleLights.size();
+		_lightInfoData.resize(numVisLights * 2);
 		for (size_t i = 0; i < numVisLights; ++i)
 		{
-			lightInfo[i].positionRadius.set(_visibleLights[i]->position, _visibleLights[i]->radius * _lightRadiusScale);
-			lightInfo[i].colorFalloffExp.set(_visibleLights[i]->color, _visibleLights[i]->falloffExponent);
+			_lightInfoData[i * 2 + 0].set(_visibleLights[i]->position, _visibleLights[i]->radius * _lightRadiusScale);
+			_lightInfoData[i * 2 + 1].set(_visibleLights[i]->color, _visibleLights[i]->falloffExponent);
 		}
-		_lightInfoBuf->BufferSubData(0, sizeof(UniformLightData) * numVisLights, lightInfo);
+		_lightInfoBuf->BufferSubData(0, sizeof(UniformLightData) * numVisLights, _lightInfoData.data());
 	}
 }
 
 void DeferredRenderer::RenderImGui()
 {
+	PROFILE_ZONE("RenderImGui");
+
 	ImDrawData* drawData = ImGui::GetDrawData();
+	if (drawData->TotalVtxCount == 0)
+		return;
+
+	ReserveImGuiBuffers(drawData->TotalVtxCount, drawData->TotalIdxCount);
+
+	// Wait until the GPU is done with the part of the buffers this frame writes to. It was last used
+	// ImGuiBufferFrames frames ago, so the wait rarely blocks.
+
+	gls::SyncObject& fence = _imGuiFences[_imGuiBufferFrame];
+	if (fence != nullptr)
+	{
+		while (_renderContext->ClientWaitSync(fence, gls::SYNC_FLUSH_COMMANDS_BIT, 1000000000) == gls::SyncWaitStatus::TimeoutExpired)
+			;
+		_renderContext->DeleteSync(fence);
+		fence = nullptr;
+	}
+
+	// All command lists are copied one after another, and draws find their list's data through the index offset
+	// and base vertex. The mapping is coherent, so nothing needs to be flushed.
+
+	size_t firstVertex = _imGuiBufferFrame * _imGuiVertCapacity;
+	size_t firstIndex = _imGuiBufferFrame * _imGuiIndexCapacity;
+
+	{
+		PROFILE_ZONE("UploadImGuiData");
+
+		ImDrawVert* vertices = _imGuiVertices + firstVertex;
+		ImDrawIdx* indices = _imGuiIndices + firstIndex;
+		for (int i = 0; i < drawData->CmdListsCount; ++i)
+		{
+			const ImDrawList* cmdList = drawData->CmdLists[i];
+			memcpy(vertices, cmdList->VtxBuffer.Data, cmdList->VtxBuffer.Size * sizeof(ImDrawVert));
+			memcpy(indices, cmdList->IdxBuffer.Data, cmdList->IdxBuffer.Size * sizeof(ImDrawIdx));
+			vertices += cmdList->VtxBuffer.Size;
+			indices += cmdList->IdxBuffer.Size;
+		}
+	}
 
 	_renderContext->SetFramebuffer(nullptr);
 	_renderContext->EnableBlending(true);
@@ -1162,13 +1996,18 @@ void DeferredRenderer::RenderImGui()
 
 	_ubufImGui->BufferSubData(0, sizeof(math3d::mat4f), projMat);
 
+	// Most commands use the font texture and the clip rectangle of their window, so the texture and scissor
+	// are set only when they change.
+	gls::ITexture2D* prevTexture = nullptr;
+	int prevScissor[4] = { -1, -1, -1, -1 };
+
+	size_t listVertex = firstVertex;
+	size_t listIndex = firstIndex;
+
 	for (int i = 0; i < drawData->CmdListsCount; ++i)
 	{
 		const ImDrawList* cmdList = drawData->CmdLists[i];
 
-		_imGuiVertBuffer->BufferSubData(0, cmdList->VtxBuffer.Size * sizeof(ImDrawVert), cmdList->VtxBuffer.Data);
-		_imGuiIndexBuffer->BufferSubData(0, cmdList->IdxBuffer.Size * sizeof(ImDrawIdx), cmdList->IdxBuffer.Data);
-
 		for (int cmdInd = 0; cmdInd < cmdList->CmdBuffer.Size; ++cmdInd)
 		{
 			const ImDrawCmd* cmd = &cmdList->CmdBuffer[cmdInd];
@@ -1176,6 +2015,8 @@ void DeferredRenderer::RenderImGui()
 			if (cmd->UserCallback)
 			{
 				cmd->UserCallback(cmdList, cmd);
+				prevTexture = nullptr;
+				prevScissor[0] = -1;
 			}
 			else
 			{
@@ -1187,24 +2028,97 @@ void DeferredRenderer::RenderImGui()
 
 				if (clipRect.x < fbWidth && clipRect.y < fbHeight && clipRect.z >= 0.0f && clipRect.w >= 0.0f)
 				{
-					_renderContext->SetSamplerTexture(0, static_cast<gls::ITexture2D*>(cmd->TextureId));
-					_renderContext->Scissor(
+					gls::ITexture2D* texture = static_cast<gls::ITexture2D*>(cmd->TextureId);
+					if (texture != prevTexture)
+					{
+						_renderContext->SetSamplerTexture(0, texture);
+						prevTexture = texture;
+					}
+
+					int scissor[4] =
+					{
 						static_cast<int>(clipRect.x),
 						static_cast<int>(fbHeight - clipRect.w),
 						static_cast<int>(clipRect.z - clipRect.x),
-						static_cast<int>(clipRect.w - clipRect.y));
+						static_cast<int>(clipRect.w - clipRect.y)
+					};
+					if (memcmp(scissor, prevScissor, sizeof(scissor)) != 0)
+					{
+						_renderContext->Scissor(scissor[0], scissor[1], scissor[2], scissor[3]);
+						memcpy(prevScissor, scissor, sizeof(scissor));
+					}
 
-					_renderContext->DrawIndexed(gls::PrimitiveType::Triangles, cmd->IdxOffset * sizeof(ImDrawIdx), cmd->VtxOffset, cmd->ElemCount);
+					_renderContext->DrawIndexed(
+						gls::PrimitiveType::Triangles, (listIndex + cmd->IdxOffset) * sizeof(ImDrawIdx),
+						static_cast<int>(listVertex + cmd->VtxOffset), cmd->ElemCount);
 				}
 			}
 		}
+
+		listVertex += cmdList->VtxBuffer.Size;
+		listIndex += cmdList->IdxBuffer.Size;
 	}
 
+	_imGuiFences[_imGuiBufferFrame] = _renderContext->InsertFenceSync(gls::FenceSyncCondition::GPUCommandsComplete, 0);
+	_imGuiBufferFrame = (_imGuiBufferFrame + 1) % ImGuiBufferFrames;
+
 	_renderContext->EnableBlending(false);
 	_renderContext->EnableFaceCulling(true);
 	_renderContext->EnableScissorTest(false);
 }
 
+void DeferredRenderer::ReserveImGuiBuffers(size_t numVertices, size_t numIndices)
+{
+	if (_imGuiVertBuffer != nullptr && _imGuiVertCapacity >= numVertices && _imGuiIndexCapacity >= numIndices)
+		return;
+
+	size_t vertCapacity = std::max<size_t>(_imGuiVertCapacity, 1);
+	while (vertCapacity < numVertices)
+		vertCapacity *= 2;
+	size_t indexCapacity = std::max<size_t>(_imGuiIndexCapacity, 1);
+	while (indexCapacity < numIndices)
+		indexCapacity *= 2;
+
+	// Buffers still read by the GPU are released by the driver when it's done with them, so the fences of the
+	// old buffers aren't needed anymore.
+	DestroyImGuiBuffers();
+
+	gls::uint storageFlags = gls::BUFFER_MAP_WRITE_BIT | gls::BUFFER_MAP_PERSISTENT_BIT | gls::BUFFER_MAP_COHERENT_BIT;
+	gls::uint mapFlags = gls::MAP_WRITE_BIT | gls::MAP_PERSISTENT_BIT | gls::MAP_COHERENT_BIT;
+
+	_imGuiVertBuffer = _renderContext->CreateBuffer(ImGuiBufferFrames * vertCapacity * sizeof(ImDrawVert), nullptr, storageFlags);
+	_imGuiIndexBuffer = _renderContext->CreateBuffer(ImGuiBufferFrames * indexCapacity * sizeof(ImDrawIdx), nullptr, storageFlags);
+	_imGuiVertices = static_cast<ImDrawVert*>(_imGuiVertBuffer->Map(mapFlags));
+	_imGuiIndices = static_cast<ImDrawIdx*>(_imGuiIndexBuffer->Map(mapFlags));
+	_imGuiVertCapacity = vertCapacity;
+	_imGuiIndexCapacity = indexCapacity;
+	_imGuiBufferFrame = 0;
+}
+
+void DeferredRenderer::DestroyImGuiBuffers()
+{
+	for (gls::SyncObject& fence : _imGuiFences)
+	{
+		if (fence != nullptr)
+		{
+			_renderContext->DeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	if (_imGuiVertBuffer != nullptr)
+	{
+		_imGuiVertBuffer->Unmap();
+		_imGuiIndexBuffer->Unmap();
+		_renderContext->DestroyBuffer(_imGuiVertBuffer);
+		_renderContext->DestroyBuffer(_imGuiIndexBuffer);
+		_imGuiVertBuffer = nullptr;
+		_imGuiIndexBuffer = nullptr;
+		_imGuiVertices = nullptr;
+		_imGuiIndices = nullptr;
+	}
+}
+
 void DeferredRenderer::ImGuiSettingsDlg()
 {
 	if (ImGui::Begin("Settings", &_settingsDlgVisible, ImGuiWindowFlags_AlwaysAutoResize))
@@ -1223,8 +2137,12 @@ void DeferredRenderer::ImGuiSettingsDlg()
 		ImGui::TextColored(teal, "Use w, s, a, d keys to move; F2 to show demo dialog.");
 		int visibleObjects = static_cast<int>(_visibleObjects.size() + (_showTranspSurfaces ? _visibleTranspObjects.size() : 0));
 		ImGui::TextColored(orange, "Objects in view: %d / %d", visibleObjects, _sponzaScene.GetMeshCount());
+		ImGui::TextColored(orange, "Triangles in view: %d", _visibleTriangles);
+		if (_clusterCulling)
+			ImGui::TextColored(orange, "Clusters in view: %d / %d", _visibleClusters, _testedClusters);
 		ImGui::TextColored(orange, "Lights in view: %d / %d", static_cast<int>(_visibleLights.size()), static_cast<int>(_lights.size()));
 		ImGui::TextColored(orange, "FPS: %.0f", _imGuiIO->Framerate);
+		ImGui::TextColored(orange, "Heap allocations per frame: %d (frame arena %d KB)", _frameHeapAllocations, static_cast<int>(_frameArena.GetCapacity() / 1024));
 		ImGui::PlotLines("##plot", _framerateValues.data(), static_cast<int>(_framerateValues.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(400.0f, 100.0f));
 
 		ImGui::Combo("renderer", reinterpret_cast<int*>(&_renderPath), "Forward multi-pass\0Forward single pass\0Deferred\0\0");
@@ -1240,9 +2158,23 @@ void DeferredRenderer::ImGuiSettingsDlg()
 
 		ImGui::Checkbox("Show light sources (l)", &_showLightSources);
 		ImGui::Checkbox("Show transp. surfaces (t)", &_showTranspSurfaces);
-
+		if (_showTranspSurfaces)
+		{
+			ImGui::SameLine();
+			ImGui::Checkbox("Order-independent", &_oitTransparency);
+		}
+
 		ImGui::Checkbox("V-sync (v)", &_vsync);
 
+		ImGui::Checkbox("Incremental interactions", &_incrementalInteractions);
+		if (_incrementalInteractions)
+		{
+			ImGui::SameLine();
+			ImGui::Checkbox("Validate", &_validateInteractions);
+			ImGui::Text("Lights recomputed: %d, against all meshes: %d",
+				static_cast<int>(_interactionCache.GetRecomputeCount()), static_cast<int>(_interactionCache.GetFullRecomputeCount()));
+		}
+
 		ImGui::Text("FOV angle");
 		ImGui::SameLine();
 		if (ImGui::SliderFloat("##fovdeg", &_fovAngleDeg, MinFOV, MaxFOV, u8"%.0f\u00B0"))
@@ -1254,6 +2186,37 @@ void DeferredRenderer::ImGuiSettingsDlg()
 			UpdateProjectionMatrix();
 		}
 
+		if (ImGui::Checkbox("Mesh LODs", &_meshLodsEnabled))
+			_visibleObjectsValid = false;
+		if (_meshLodsEnabled)
+		{
+			ImGui::SameLine();
+			if (ImGui::SliderFloat("##loderror", &_lodErrorPixels, 0.25f, 8.0f, "max error %.2f px"))
+				_visibleObjectsValid = false;
+		}
+
+		if (ImGui::Checkbox("Cluster culling", &_clusterCulling))
+			_visibleObjectsValid = false;
+
+		if (_renderPath == RenderPath::Deferred)
+		{
+			ImGui::Checkbox("Half resolution lighting", &_halfResLighting);
+			ImGui::Checkbox("Quads for small lights", &_smallLightQuads);
+			if (_smallLightQuads)
+			{
+				ImGui::SameLine();
+				ImGui::Text("%d / %d lights", _quadShadedLights, static_cast<int>(_visibleLights.size()));
+			}
+		}
+
+		ImGui::Checkbox("Dynamic resolution", &_dynamicResolution);
+		if (_dynamicResolution)
+		{
+			ImGui::SameLine();
+			ImGui::SliderFloat("##framebudget", &_frameBudgetMs, 4.0f, 50.0f, "budget %.1f ms");
+			ImGui::Text("Rendering at %d x %d (%.0f%%)", _renderWidth, _renderHeight, _resolutionScale * 100.0f);
+		}
+
 		ImGui::Text("Light radius scale");
 		ImGui::SameLine();
 		ImGui::SliderFloat("##radscale", &_lightRadiusScale, 0.5f, 3.0f, "%.1f x");
@@ -1296,11 +2259,21 @@ void DeferredRenderer::ImGuiSettingsDlg()
 		}
 		ImGui::SameLine();
 		ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.78f);
-		ImGui::SliderInt("##numlights", &_randomLightsToCreate, 1, MaxLights, (_randomLightsToCreate == 1) ? "%d light" : "%d lights");
+		// Power curve, so that small counts stay selectable next to the maximum.
+		float lightsToCreate = static_cast<float>(_randomLightsToCreate);
+		if (ImGui::SliderFloat("##numlights", &lightsToCreate, 1.0f, static_cast<float>(MaxRandomLights), (_randomLightsToCreate == 1) ? "%.0f light" : "%.0f lights", 4.0f))
+			_randomLightsToCreate = std::max(1, static_cast<int>(lightsToCreate + 0.5f));
 		ImGui::PopItemWidth();
 
 		if (ImGui::Button("Remove all lights (r)"))
 			RemoveAllLights();
+
+#if defined (ENABLE_PROFILER)
+		if (IsProfilerCapturing())
+			ImGui::TextColored(yellow, "Capturing CPU trace...");
+		else if (ImGui::Button("Capture CPU trace"))
+			StartTraceCapture(TraceCaptureFrames);
+#endif
 	}
 	ImGui::End();
 }
@@ -1334,6 +2307,9 @@ void DeferredRenderer::ImGuiDemoDlg()
 		ImGui::ListBoxFooter();
 
 		ImGui::Checkbox("Loop demo playback", &_loopDemoPlayback);
+		ImGui::Checkbox("Fixed step benchmark", &_fixedStepBenchmark);
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Advance the demo by 1/60 s per frame so that every render path draws the same frames.");
 
 		if (ImGui::Button("New"))
 			_newDemoDlgVisible = true;
@@ -1479,6 +2455,14 @@ void DeferredRenderer::ImGuiBenchmarkResultsDlg()
 				ImGui::TextColored(lime, "    Avg:"); ImGui::SameLine(); ImGui::TextColored(lime, "%20.2f%20.3f", results.averageFPS, results.averageDt);
 				ImGui::TextColored(plum, "    Min:"); ImGui::SameLine(); ImGui::TextColored(plum, "%20.2f%20.3f", results.minFPS, results.minDt);
 				ImGui::TextColored(rouge, "    Max:"); ImGui::SameLine(); ImGui::TextColored(rouge, "%20.2f%20.3f", results.maxFPS, results.maxDt);
+
+				// Percentiles and spikes show stutter that the averages hide.
+				const FrameTimeStats& dt = results.dtStats;
+				ImGui::TextColored(white, "    Median %.3f [%.3f, %.3f]  StdDev %.3f", dt.median, dt.medianCILow, dt.medianCIHigh, dt.stdDev);
+				ImGui::TextColored(white, "    p90 %.3f  p95 %.3f  p99 %.3f  p99.9 %.3f", dt.p90, dt.p95, dt.p99, dt.p999);
+				ImGui::TextColored(dt.spikes.empty() ? white : rouge, "    Spikes: %d of %d frames", static_cast<int>(dt.spikes.size()), static_cast<int>(dt.count));
+				if (results.gpuStats.count > 0)
+					ImGui::TextColored(white, "    CPU median %.3f  GPU median %.3f  GPU p99 %.3f", results.cpuStats.median, results.gpuStats.median, results.gpuStats.p99);
 			}
 			else
 			{
@@ -1507,11 +2491,22 @@ void DeferredRenderer::Render()
 	if (_renderContext == nullptr)
 		return;
 
+	PROFILE_ZONE("Render");
+
+	// Dynamic resolution is driven by the GPU time of frames, which unlike the frame interval doesn't include
+	// waiting for vsync.
+	bool timeGpuFrame = _benchmarkData.measureFrame || (_dynamicResolution && _runMode != RunMode::Benchmark);
+	if (timeGpuFrame)
+		BeginGpuFrameTimer();
+
+	// Scene passes render into the bottom left part of the framebuffers when the resolution is scaled down.
+	_renderContext->Viewport(0, 0, _renderWidth, _renderHeight);
+
 	if (_renderPath == RenderPath::Deferred)
 	{
 		RenderGeometryPass();
 
-		if (_showGBuffer)
+		if (_showGBuffer && IsShaderReady(_fragShaderVisGBuffer))
 		{
 			RenderGBufferPreview();
 		}
@@ -1521,9 +2516,9 @@ void DeferredRenderer::Render()
 			if (_showLightSources)
 				RenderLightSources();
 			if (_showTranspSurfaces)
-				RenderForwardTransparentSinglePass();
+				RenderTransparentSurfaces();
 
-			_renderContext->BlitFramebuffer(_sceneBuffer, gls::ColorBuffer::Color0, 0, 0, _viewportWidth, _viewportHeight, nullptr, 0, 0, _viewportWidth, _viewportHeight, gls::COLOR_BUFFER_BIT, gls::TexFilter::Nearest);
+			BlitSceneToScreen();
 		}
 	}
 	else if (_renderPath == RenderPath::ForwardSinglePass)
@@ -1532,9 +2527,9 @@ void DeferredRenderer::Render()
 		if (_showLightSources)
 			RenderLightSources();
 		if (_showTranspSurfaces)
-			RenderForwardTransparentSinglePass();
+			RenderTransparentSurfaces();
 
-		_renderContext->BlitFramebuffer(_sceneBuffer, gls::ColorBuffer::Color0, 0, 0, _viewportWidth, _viewportHeight, nullptr, 0, 0, _viewportWidth, _viewportHeight, gls::COLOR_BUFFER_BIT, gls::TexFilter::Nearest);
+		BlitSceneToScreen();
 	}
 	else
 	{
@@ -1542,9 +2537,9 @@ void DeferredRenderer::Render()
 		if (_showLightSources)
 			RenderLightSources();
 		if (_showTranspSurfaces)
-			RenderForwardTransparent();
+			RenderTransparentSurfaces();
 
-		_renderContext->BlitFramebuffer(_sceneBuffer, gls::ColorBuffer::Color0, 0, 0, _viewportWidth, _viewportHeight, nullptr, 0, 0, _viewportWidth, _viewportHeight, gls::COLOR_BUFFER_BIT, gls::TexFilter::Nearest);
+		BlitSceneToScreen();
 	}
 
 	ImGui::EndFrame();
@@ -1559,7 +2554,27 @@ void DeferredRenderer::Render()
 	_renderContext->SetVertexShader(nullptr);
 	_renderContext->SetFragmentShader(nullptr);
 
-	_renderContext->SwapBuffers();
+	if (timeGpuFrame)
+		EndGpuFrameTimer();
+
+	if (_benchmarkData.measureFrame)
+	{
+		// CPU time covers update and render command submission, but not waiting for the swap.
+		std::chrono::duration<float, std::milli> cpuTime = std::chrono::high_resolution_clock::now() - _frameStartTime;
+		auto& results = _benchmarkData.results[_benchmarkData.currentRenderPath];
+		results.cpuTimes.push_back(cpuTime.count());
+		results.heapAllocations += GetHeapAllocationCount() - _frameStartHeapAllocations;
+		_benchmarkData.measureFrame = false;
+	}
+
+	{
+		PROFILE_ZONE("SwapBuffers");
+		_renderContext->SwapBuffers();
+	}
+
+#if defined (ENABLE_PROFILER)
+	UpdateTraceCapture();
+#endif
 }
 
 void DeferredRenderer::OnResize(int width, int height)
@@ -1571,6 +2586,7 @@ void DeferredRenderer::OnResize(int width, int height)
 	_renderContext->Viewport(0, 0, width, height);
 	_viewportWidth = width;
 	_viewportHeight = height;
+	UpdateRenderSize();
 	UpdateProjectionMatrix();
 
 	_imGuiIO->DisplaySize.x = static_cast<float>(width);
@@ -1788,8 +2804,8 @@ void DeferredRenderer::OnLostKeyboardFocus()
 void DeferredRenderer::CreateRandomLights(int count, const math3d::vec3f& minPt, const math3d::vec3f& maxPt)
 {
 	_lights.clear();
-	std::random_device rd;
-	std::mt19937 gen { rd() };
+	_lights.reserve(count);
+	std::mt19937& gen = _lightRandomGen;
 	std::uniform_real_distribution<float> dist { 0.0f, 1.0f };
 	std::uniform_real_distribution<float> distNeg { -1.0f, 1.0f };
 
@@ -1812,11 +2828,52 @@ void DeferredRenderer::CreateRandomLights(int count, const math3d::vec3f& minPt,
 	}
 }
 
-void DeferredRenderer::CreateNewLight(const math3d::vec3f& position, const math3d::vec3f& moveDir)
+void DeferredRenderer::ReserveLightBuffers(size_t numLights)
+{
+	if (_lightInfoBuf != nullptr && _lightBufferCapacity >= numLights)
+		return;
+
+	// Grow geometrically, so a growing light count reallocates only a few times.
+	size_t capacity = std::max(_lightBufferCapacity, InitialLightBufferCapacity);
+	while (capacity < numLights)
+		capacity *= 2;
+
+	gls::IBuffer* lightInfoBuf = _renderContext->CreateBuffer(capacity * sizeof(UniformLightData), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+	gls::IBuffer* lightQuadVertBuf = _renderContext->CreateBuffer(capacity * 6 * sizeof(math3d::vec4f), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+	_lightInfoTex->TexBuffer(gls::PixelFormat::RGBA32F, lightInfoBuf);
+
+	if (_lightInfoBuf != nullptr)
+	{
+		_renderContext->DestroyBuffer(_lightInfoBuf);
+		_renderContext->DestroyBuffer(_lightQuadVertBuf);
+	}
+
+	_lightInfoBuf = lightInfoBuf;
+	_lightQuadVertBuf = lightQuadVertBuf;
+	_lightBufferCapacity = capacity;
+}
+
+void DeferredRenderer::ReserveLightIndexBuffer(size_t numIndices)
 {
-	if (_lights.size() + 1 > MaxLights)
+	if (_lightIndexBuf != nullptr && _lightIndexCapacity >= numIndices)
 		return;
 
+	size_t capacity = std::max(_lightIndexCapacity, InitialLightBufferCapacity);
+	while (capacity < numIndices)
+		capacity *= 2;
+
+	gls::IBuffer* lightIndexBuf = _renderContext->CreateBuffer(capacity * sizeof(int32_t), nullptr, gls::BUFFER_DYNAMIC_STORAGE_BIT);
+	_lightIndexTex->TexBuffer(gls::PixelFormat::R32I, lightIndexBuf);
+
+	if (_lightIndexBuf != nullptr)
+		_renderContext->DestroyBuffer(_lightIndexBuf);
+
+	_lightIndexBuf = lightIndexBuf;
+	_lightIndexCapacity = capacity;
+}
+
+void DeferredRenderer::CreateNewLight(const math3d::vec3f& position, const math3d::vec3f& moveDir)
+{
 	PointLight light;
 
 	light.position = position;
@@ -1824,8 +2881,7 @@ void DeferredRenderer::CreateNewLight(const math3d::vec3f& position, const math3
 
 	if (_newLightRandomParams)
 	{
-		std::random_device rd;
-		std::mt19937 gen { rd() };
+		std::mt19937& gen = _lightRandomGen;
 		std::uniform_real_distribution<float> dist { 0.0f, 1.0f };
 		std::uniform_real_distribution<float> distBrightClr { LightClrBrightThreshold, 1.0f };
 		std::uniform_int_distribution<int> distClrChan { 0, 2 };
@@ -1967,8 +3023,20 @@ void DeferredRenderer::DestroySphere()
 	_vertFmtSphere = nullptr;
 }
 
+void DeferredRenderer::ResetFrameData()
+{
+	ResetFrameVector(_lightInfoData);
+	ResetFrameVector(_lightQuadVerts);
+	ResetFrameVector(_sphereLights);
+	ResetFrameVector(_interactionOffsets);
+	ResetFrameVector(_interactionLights);
+	_frameArena.Reset();
+}
+
 void DeferredRenderer::UpdateCamera(float frameTime)
 {
+	PROFILE_ZONE("UpdateCamera");
+
 	// Calculate the movement vector and update the view and view-projection matrices.
 
 	float forwardMovement = 0.0f;
@@ -2001,15 +3069,73 @@ void DeferredRenderer::UpdateCamera(float frameTime)
 	math3d::mul(_viewProjMat, _viewMat, _projMat);
 }
 
+void DeferredRenderer::UpdateResolutionScale()
+{
+	// Benchmarks compare render paths at the full resolution.
+	if (!_dynamicResolution || _runMode == RunMode::Benchmark)
+	{
+		if (_resolutionScale != 1.0f)
+		{
+			_resolutionScale = 1.0f;
+			UpdateRenderSize();
+		}
+		_fullResFrameTime = 0.0f;
+		return;
+	}
+
+	// The GPU time is used rather than the time between frames, which with vsync on is the swap interval however
+	// little there is to render. It comes from a frame a few frames back and is scaled with the scale that frame was
+	// rendered at. CPU time doesn't go down with the resolution, so it isn't counted.
+	if (_gpuFrameTime <= 0.0f)
+		return;
+
+	// GPU time is taken to go with the pixel count, the square of the scale. Smoothing the time scaled back to
+	// full resolution, instead of the measured one, keeps the estimate from lagging behind scale changes.
+	// The scale then moves towards the one which fits the estimate into the budget with some headroom.
+
+	float fullResTime = _gpuFrameTime / (_gpuFrameScale * _gpuFrameScale);
+	_fullResFrameTime = _fullResFrameTime > 0.0f ? math3d::lerp(_fullResFrameTime, fullResTime, FrameTimeSmoothing) : fullResTime;
+
+	float targetScale = std::clamp(std::sqrt(_frameBudgetMs * ResolutionBudgetFraction / _fullResFrameTime), MinResolutionScale, 1.0f);
+	if (std::abs(targetScale - _resolutionScale) <= ResolutionDeadZone && targetScale < 1.0f)
+		return;
+
+	float scale = targetScale < _resolutionScale ?
+		std::max(targetScale, _resolutionScale * MaxResolutionStepDown) :
+		std::min(targetScale, _resolutionScale * MaxResolutionStepUp);
+
+	if (scale != _resolutionScale)
+	{
+		_resolutionScale = scale;
+		UpdateRenderSize();
+	}
+}
+
+void DeferredRenderer::UpdateRenderSize()
+{
+	int width = std::max(static_cast<int>(_viewportWidth * _resolutionScale + 0.5f), 1);
+	int height = std::max(static_cast<int>(_viewportHeight * _resolutionScale + 0.5f), 1);
+
+	// Levels of detail are chosen for the rendered pixel size.
+	if (height != _renderHeight)
+		_visibleObjectsValid = false;
+
+	_renderWidth = width;
+	_renderHeight = height;
+}
+
 void DeferredRenderer::UpdateProjectionMatrix()
 {
-	_projMat.perspective(math3d::deg2rad(_fovAngleDeg), float(_viewportWidth) / _viewportHeight, 10.0f, 4000.0f);
+	_projMat.perspective(math3d::deg2rad(_fovAngleDeg), float(_viewportWidth) / _viewportHeight, NearPlane, FarPlane);
 	ExtractFrustumPlanes(_projMat, _frustumPlanes);
 }
 
 void DeferredRenderer::UpdateLights(float frameTime)
 {
+	PROFILE_ZONE("UpdateLights");
+
 	_visibleLights.clear();
+	_lightVisibleIndex.assign(_lights.size(), -1);
 
 	for (PointLight& light :_lights)
 	{
@@ -2049,16 +3175,69 @@ void DeferredRenderer::UpdateLights(float frameTime)
 				light.moveDir.z = -light.moveDir.z;
 			}
 		}
+	}
+
+	// Only lights which moved to another cell are reinserted into the grid.
+	{
+		PROFILE_ZONE("UpdateLightGrid");
+		_lightGrid.Update(_lights.size(), [this](size_t i)
+		{
+			return math3d::vec4f(_lights[i].position, _lights[i].radius * _lightRadiusScale);
+		});
+	}
 
-		if (ViewSpaceSphereInsideFrustum(light.position * _viewMat, light.radius * _lightRadiusScale, _frustumPlanes))
-			_visibleLights.push_back(&light);
+	// The light palette texture holds two texels per light and can't exceed the texture buffer size limit.
+	size_t maxVisibleLights = static_cast<size_t>(_renderContext->GetInfo().maxTextureBufferSize) / 2;
+
+	_lightGrid.QueryFrustum(_viewMat, _frustumPlanes, [this](uint32_t lightIndex)
+	{
+		_lightVisibleIndex[lightIndex] = 0;
+	});
+
+	// The grid returns lights in cell order; visible lights are numbered in the order they're stored instead,
+	// so that passes over the visible lights read the light data sequentially.
+	for (size_t lightIndex = 0; lightIndex < _lights.size(); ++lightIndex)
+	{
+		if (_lightVisibleIndex[lightIndex] < 0)
+			continue;
+
+		if (_visibleLights.size() < maxVisibleLights)
+		{
+			_lightVisibleIndex[lightIndex] = static_cast<int32_t>(_visibleLights.size());
+			_visibleLights.push_back(&_lights[lightIndex]);
+		}
+		else
+		{
+			_lightVisibleIndex[lightIndex] = -1;
+		}
 	}
 }
 
 void DeferredRenderer::UpdateVisibleObjects()
 {
+	PROFILE_ZONE("UpdateVisibleObjects");
+
+	// The scene is static, so the lists change only with the view.
+	if (_visibleObjectsValid && _visibleObjectsShowTransp == _showTranspSurfaces &&
+		memcmp(&_visibleObjectsViewProjMat, &_viewProjMat, sizeof(math3d::mat4f)) == 0)
+		return;
+
+	_visibleObjectsViewProjMat = _viewProjMat;
+	_visibleObjectsShowTransp = _showTranspSurfaces;
+	_visibleObjectsValid = true;
+
 	_visibleObjects.clear();
 	_visibleTranspObjects.clear();
+	_meshLods.assign(_sponzaScene.GetMeshCount(), 0);
+	_visibleTriangles = 0;
+	_clusterDraws.clear();
+	_visibleClusters = 0;
+	_testedClusters = 0;
+
+	// Screen pixels per model unit at unit distance from the camera.
+	float pixelsPerUnit = _renderHeight / (2.0f * std::tan(math3d::deg2rad(_fovAngleDeg) * 0.5f));
+
+	TransformToView(_meshCenters, _meshViewCenters, 0, _meshCenters.x.size());
 
 	for (int meshInd = 0; meshInd < _sponzaScene.GetMeshCount(); ++meshInd)
 	{
@@ -2071,62 +3250,296 @@ void DeferredRenderer::UpdateVisibleObjects()
 			if (material.diffuseTexture != nullptr && material.normalTexture != nullptr &&
 				(!material.transparent || _showTranspSurfaces))
 			{
-				auto centerPt = (mesh.maxPt + mesh.minPt) * 0.5f;
 				auto vec = (mesh.maxPt - mesh.minPt) * 0.5f;
 
 				if (//std::max(vec.x, std::max(vec.y, vec.z)) > 500.0f ||
 					ViewSpaceBBoxInsideFrustum(
-						centerPt * _viewMat,
+						_meshViewCenters.Get(meshInd),
 						math3d::transform_dir(math3d::vec3f(vec.x, 0.0f, 0.0f), _viewMat),
 						math3d::transform_dir(math3d::vec3f(0.0f, vec.y, 0.0f), _viewMat),
 						math3d::transform_dir(math3d::vec3f(0.0f, 0.0f, vec.z), _viewMat),
 						_frustumPlanes))
 				{
+					// Use the coarsest level whose error, seen from the closest point of the bounding box, stays
+					// below the pixel threshold.
+					if (_meshLodsEnabled)
+					{
+						math3d::vec3f closestPt(
+							std::clamp(_cameraPosition.x, mesh.minPt.x, mesh.maxPt.x),
+							std::clamp(_cameraPosition.y, mesh.minPt.y, mesh.maxPt.y),
+							std::clamp(_cameraPosition.z, mesh.minPt.z, mesh.maxPt.z));
+						float distance = std::max((closestPt - _cameraPosition).length(), 1.0f);
+
+						for (int lodInd = mesh.numLods - 1; lodInd > 0; --lodInd)
+						{
+							if (mesh.lods[lodInd].error * pixelsPerUnit / distance <= _lodErrorPixels)
+							{
+								_meshLods[meshInd] = static_cast<uint8_t>(lodInd);
+								break;
+							}
+						}
+					}
+
+					// Transparent surfaces are drawn without face culling, so only their clusters outside of the view are
+					// skipped. Meshes with no visible clusters are left out altogether.
+					const ObjScene::Lod& lod = mesh.lods[_meshLods[meshInd]];
+					int numTriangles = lod.numIndices / 3;
+
+					if (_clusterCulling)
+					{
+						numTriangles = CullClusters(meshInd, lod, !material.transparent, _meshClusterDraws[meshInd]);
+						if (numTriangles == 0)
+							continue;
+					}
+
 					if (material.transparent)
 						_visibleTranspObjects.push_back(&mesh);
 					else
 						_visibleObjects.push_back(&mesh);
+
+					_visibleTriangles += numTriangles;
 				}
 			}
 		}
-	}	
+	}
+
+	if (!_clusterDraws.empty())
+		_clusterDrawBuf->BufferSubData(0, _clusterDraws.size() * sizeof(gls::DrawIndexedIndirectData), _clusterDraws.data());
+}
+
+void DeferredRenderer::TransformToView(const PointArrays& points, PointArrays& viewPoints, size_t first, size_t count) const
+{
+	math3d::transform_points(
+		points.x.data() + first, points.y.data() + first, points.z.data() + first,
+		viewPoints.x.data() + first, viewPoints.y.data() + first, viewPoints.z.data() + first,
+		count, _viewMat);
+}
+
+int DeferredRenderer::CullClusters(int meshInd, const ObjScene::Lod& lod, bool cullBackFacing, ClusterDrawRange& range)
+{
+	range.first = static_cast<int32_t>(_clusterDraws.size());
+	int numTriangles = 0;
+	bool prevVisible = false;
+
+	TransformToView(_clusterCenters, _clusterViewCenters, lod.clusterOffset, lod.numClusters);
+
+	for (int clusterInd = lod.clusterOffset; clusterInd < lod.clusterOffset + lod.numClusters; ++clusterInd)
+	{
+		const ObjScene::Cluster& cluster = _sponzaScene.GetCluster(clusterInd);
+		math3d::vec3f vec = (cluster.maxPt - cluster.minPt) * 0.5f;
+		math3d::vec3f camToCenter = _clusterCenters.Get(clusterInd) - _cameraPosition;
+
+		bool visible =
+			!(cullBackFacing && math3d::dot(camToCenter, cluster.coneAxis) >= cluster.coneCutoff * camToCenter.length() + vec.length()) &&
+			ViewSpaceBBoxInsideFrustum(
+				_clusterViewCenters.Get(clusterInd),
+				math3d::transform_dir(math3d::vec3f(vec.x, 0.0f, 0.0f), _viewMat),
+				math3d::transform_dir(math3d::vec3f(0.0f, vec.y, 0.0f), _viewMat),
+				math3d::transform_dir(math3d::vec3f(0.0f, 0.0f, vec.z), _viewMat),
+				_frustumPlanes);
+
+		if (visible)
+		{
+			// Clusters of a level of detail are contiguous in the index buffer, so runs of visible clusters
+			// become one draw.
+			if (prevVisible)
+				_clusterDraws.back().count += cluster.numIndices;
+			else
+				_clusterDraws.push_back({ static_cast<gls::uint>(cluster.numIndices), 1, static_cast<gls::uint>(cluster.indexOffset), 0, static_cast<gls::uint>(meshInd) });
+
+			numTriangles += cluster.numIndices / 3;
+			++_visibleClusters;
+		}
+
+		prevVisible = visible;
+	}
+
+	_testedClusters += lod.numClusters;
+	range.count = static_cast<int32_t>(_clusterDraws.size()) - range.first;
+	return numTriangles;
 }
 
 void DeferredRenderer::UpdateLightObjectInteractions()
 {
-	if (_renderPath != RenderPath::Deferred)
+	PROFILE_ZONE("UpdateLightObjectInteractions");
+
+	bool opaqueNeeded = _renderPath != RenderPath::Deferred;
+	bool transpNeeded = _showTranspSurfaces;
+
+	size_t numObjects = _visibleObjects.size() + _visibleTranspObjects.size();
+	_interactionOffsets.assign(numObjects + 1, 0);
+	_interactionLights.clear();
+
+	// The incremental update visits every visible light, the grid only lights near visible objects. Visiting
+	// all lights pays off when most of them interact with something, judging by the previous frame.
+	bool incremental = _incrementalInteractions && _interactionCount >= _visibleLights.size();
+	_interactionCache.ResetCounters();
+
+	if (incremental)
 	{
-		_interactions.resize(_visibleObjects.size());
+		UpdateInteractionsIncremental(opaqueNeeded, transpNeeded);
 
-		for (size_t objInd = 0; objInd < _visibleObjects.size(); ++objInd)
+		if (_validateInteractions)
+			ValidateInteractions();
+	}
+	else
+	{
+		// Interactions hold indices into _visibleLights. The grid returns lights in cell order; sorting them
+		// makes shaders read the light palette front to back. Lists which aren't needed are left empty.
+		auto findInteractions = [this](size_t objInd, const ObjScene::Mesh* obj, bool needed)
 		{
-			const ObjScene::Mesh* obj = _visibleObjects[objInd];
-			_interactions[objInd].clear();
+			if (needed)
+			{
+				size_t first = _interactionLights.size();
+				_lightGrid.QueryAABB(obj->minPt, obj->maxPt, [this](uint32_t lightIndex)
+				{
+					int32_t visibleIndex = _lightVisibleIndex[lightIndex];
+					if (visibleIndex >= 0)
+						_interactionLights.push_back(visibleIndex);
+				});
+				std::sort(_interactionLights.begin() + first, _interactionLights.end());
+			}
+			_interactionOffsets[objInd + 1] = static_cast<int32_t>(_interactionLights.size());
+		};
+
+		for (size_t objInd = 0; objInd < _visibleObjects.size(); ++objInd)
+			findInteractions(objInd, _visibleObjects[objInd], opaqueNeeded);
+
+		for (size_t objInd = 0; objInd < _visibleTranspObjects.size(); ++objInd)
+			findInteractions(_visibleObjects.size() + objInd, _visibleTranspObjects[objInd], transpNeeded);
+	}
+
+	_interactionCount = _interactionLights.size();
+}
+
+void DeferredRenderer::UpdateInteractionsIncremental(bool opaqueNeeded, bool transpNeeded)
+{
+	PROFILE_ZONE("UpdateInteractionsIncremental");
 
-			for (size_t lightInd = 0; lightInd < _visibleLights.size(); ++lightInd)
+	// Each light's set of overlapping meshes comes from the cache, which recomputes only the lights that moved far
+	// enough to enter or leave a mesh bounding box. The sets don't depend on the view, so a camera change only
+	// redistributes them over the visible objects.
+
+	_meshObjectIndex.assign(_sponzaScene.GetMeshCount(), -1);
+
+	if (opaqueNeeded)
+	{
+		for (size_t objInd = 0; objInd < _visibleObjects.size(); ++objInd)
+			_meshObjectIndex[_sponzaScene.GetMeshIndex(*_visibleObjects[objInd])] = static_cast<int32_t>(objInd);
+	}
+	if (transpNeeded)
+	{
+		for (size_t objInd = 0; objInd < _visibleTranspObjects.size(); ++objInd)
+			_meshObjectIndex[_sponzaScene.GetMeshIndex(*_visibleTranspObjects[objInd])] = static_cast<int32_t>(_visibleObjects.size() + objInd);
+	}
+
+	// Lights are visited in the order they're stored, so that the light and cache data is read sequentially. Visible
+	// indices grow in the same order, so the lists come out sorted like the ones from the grid. Every light adds to
+	// several lists, so the pairs are collected and counted first, then placed into the lists.
+	_interactionCache.Resize(_lights.size());
+	_interactionCache.SetCandidateMargin(_lightSourceSpeed * InteractionCandidateMarginTime);
+
+	struct Interaction
+	{
+		int32_t objInd;
+		int32_t visibleIndex;
+	};
+
+	FrameVector<Interaction> interactions { FrameAllocator<Interaction>(_frameArena) };
+	interactions.reserve(_interactionCount);
+
+	for (size_t lightIndex = 0; lightIndex < _lights.size(); ++lightIndex)
+	{
+		int32_t visibleIndex = _lightVisibleIndex[lightIndex];
+		if (visibleIndex < 0)
+			continue;
+
+		const PointLight& light = _lights[lightIndex];
+		math3d::vec4f sphere(light.position, light.radius * _lightRadiusScale);
+
+		for (int32_t meshInd : _interactionCache.GetBoxes(lightIndex, sphere))
+		{
+			int32_t objInd = _meshObjectIndex[meshInd];
+			if (objInd >= 0)
 			{
-				if (AABBOverlapsSphere(obj->minPt, obj->maxPt, _visibleLights[lightInd]->position, _visibleLights[lightInd]->radius * _lightRadiusScale))
-					_interactions[objInd].push_back(static_cast<int32_t>(lightInd));
+				interactions.push_back({ objInd, visibleIndex });
+				++_interactionOffsets[objInd + 1];
 			}
 		}
 	}
 
-	if (_showTranspSurfaces)
-	{
-		_transpInteractions.resize(_visibleTranspObjects.size());
+	std::partial_sum(_interactionOffsets.begin(), _interactionOffsets.end(), _interactionOffsets.begin());
 
-		for (size_t objInd = 0; objInd < _visibleTranspObjects.size(); ++objInd)
+	FrameVector<int32_t> fillPos(_interactionOffsets.begin(), _interactionOffsets.end() - 1, FrameAllocator<int32_t>(_frameArena));
+	_interactionLights.resize(interactions.size());
+	for (const Interaction& interaction : interactions)
+		_interactionLights[fillPos[interaction.objInd]++] = interaction.visibleIndex;
+}
+
+void DeferredRenderer::ValidateInteractions()
+{
+	PROFILE_ZONE("ValidateInteractions");
+
+	// Compares the incremental lists with a full rebuild from the light grid.
+	auto validate = [this](const char* listName, const std::vector<const ObjScene::Mesh*>& objects, size_t firstObject)
+	{
+		for (size_t objInd = 0; objInd < objects.size(); ++objInd)
 		{
-			const ObjScene::Mesh* obj = _visibleTranspObjects[objInd];
-			_transpInteractions[objInd].clear();
+			std::vector<int32_t>& expected = _validationInteractions;
+			expected.clear();
+			_lightGrid.QueryAABB(objects[objInd]->minPt, objects[objInd]->maxPt, [this, &expected](uint32_t lightIndex)
+			{
+				if (_lightVisibleIndex[lightIndex] >= 0)
+					expected.push_back(_lightVisibleIndex[lightIndex]);
+			});
+			std::sort(expected.begin(), expected.end());
+
+			const int32_t* first = _interactionLights.data() + _interactionOffsets[firstObject + objInd];
+			const int32_t* last = _interactionLights.data() + _interactionOffsets[firstObject + objInd + 1];
 
-			for (size_t lightInd = 0; lightInd < _visibleLights.size(); ++lightInd)
+			if (!std::equal(expected.begin(), expected.end(), first, last))
 			{
-				if (AABBOverlapsSphere(obj->minPt, obj->maxPt, _visibleLights[lightInd]->position, _visibleLights[lightInd]->radius * _lightRadiusScale))
-					_transpInteractions[objInd].push_back(static_cast<int32_t>(lightInd));
+				_console.PrintLn("Interaction validation failed: %s object %d (%s) has %d lights, full rebuild found %d.",
+					listName, static_cast<int>(objInd), objects[objInd]->name.c_str(),
+					static_cast<int>(last - first), static_cast<int>(expected.size()));
+				return;
 			}
 		}
-	}
+	};
+
+	if (_renderPath != RenderPath::Deferred)
+		validate("opaque", _visibleObjects, 0);
+	if (_showTranspSurfaces)
+		validate("transparent", _visibleTranspObjects, _visibleObjects.size());
+}
+
+DeferredRenderer::LightRange DeferredRenderer::GetInteractions(size_t objInd) const
+{
+	return { _interactionOffsets[objInd], _interactionOffsets[objInd + 1] - _interactionOffsets[objInd] };
+}
+
+DeferredRenderer::LightRange DeferredRenderer::GetTranspInteractions(size_t objInd) const
+{
+	return GetInteractions(_visibleObjects.size() + objInd);
+}
+
+void DeferredRenderer::UploadInteractions()
+{
+	PROFILE_ZONE("UploadInteractions");
+
+	// All lists go to the GPU in one upload. Draws find their mesh's range in the table through the base
+	// instance, so nothing is uploaded between them.
+
+	ReserveLightIndexBuffer(_interactionLights.size());
+	if (!_interactionLights.empty())
+		_lightIndexBuf->BufferSubData(0, sizeof(int32_t) * _interactionLights.size(), _interactionLights.data());
+
+	for (size_t objInd = 0; objInd < _visibleObjects.size(); ++objInd)
+		_meshLightRanges[_sponzaScene.GetMeshIndex(*_visibleObjects[objInd])] = GetInteractions(objInd);
+	for (size_t objInd = 0; objInd < _visibleTranspObjects.size(); ++objInd)
+		_meshLightRanges[_sponzaScene.GetMeshIndex(*_visibleTranspObjects[objInd])] = GetTranspInteractions(objInd);
+
+	_meshLightRangeBuf->BufferSubData(0, sizeof(LightRange) * _meshLightRanges.size(), _meshLightRanges.data());
 }
 
 void DeferredRenderer::RecordDemo(const char* demoName)
@@ -2151,6 +3564,8 @@ void DeferredRenderer::PlayDemo(const char* demoName)
 
 void DeferredRenderer::UpdateDemo()
 {
+	PROFILE_ZONE("UpdateDemo");
+
 	if (_demoPlayer.GetState() == DemoPlayer::State::Ready)
 	{
 		if (_loopDemoPlayback && !_demoPlaybackCanceled)
@@ -2203,7 +3618,8 @@ void DeferredRenderer::PlayerSampleUpdate(int32_t id, size_t size, const void* d
 
 	case DemoDataId::Lights:
 		_lights.resize(size / sizeof(PointLight));
-		copyDataTo(*_lights.data());
+		if (!_lights.empty())
+			copyDataTo(*_lights.data());
 		break;
 
 	case DemoDataId::ShowTranspSurfaces:
@@ -2239,13 +3655,32 @@ void DeferredRenderer::StartBenchmark(const char* demoName)
 {
 	if (_demoPlayer.LoadDemo(demoName))
 	{
+		// Every pass must be measured with its final shaders.
+		FinishPendingShaderBuilds(true);
+
+		_benchmarkData.demoName = demoName;
 		_benchmarkData.currentRenderPath = 0;
 		_benchmarkData.oldRenderPath = _renderPath;
 		_benchmarkData.oldShowLightSources = _showLightSources;
 		_benchmarkData.oldVsync = _vsync;
 		_benchmarkData.framesToSkip = BenchmarkData::NumStartFramesToSkip;
+		_benchmarkData.fixedStep = _fixedStepBenchmark;
+		_benchmarkData.measureFrame = false;
+		_benchmarkData.gpuTimerFrames.fill(-1);
+		_benchmarkData.nextGpuTimerQuery = 0;
 		_demoPlaybackCanceled = false;
 
+		// Times are added every frame. With room for the frames of a fixed step run they don't reallocate while
+		// frames are measured.
+		size_t expectedFrames = static_cast<size_t>(_demoPlayer.GetDuration() / BenchmarkData::FixedStepDt) + 1;
+		for (auto& results : _benchmarkData.results)
+		{
+			results.frameTimes.reserve(expectedFrames);
+			results.cpuTimes.reserve(expectedFrames);
+			results.gpuTimes.reserve(expectedFrames);
+			results.heapAllocations = 0;
+		}
+
 		_runMode = RunMode::Benchmark;
 		_showLightSources = false;
 		_renderPath = RenderPath::Forward;
@@ -2258,15 +3693,66 @@ void DeferredRenderer::StartBenchmark(const char* demoName)
 	}
 }
 
+void DeferredRenderer::BeginGpuFrameTimer()
+{
+	// The query being reused was issued NumGpuTimerQueries frames ago, so its result is normally ready by now.
+	int queryIndex = _benchmarkData.nextGpuTimerQuery;
+	ReadGpuFrameTimer(queryIndex);
+
+	if (_benchmarkData.measureFrame)
+	{
+		auto& results = _benchmarkData.results[_benchmarkData.currentRenderPath];
+		_benchmarkData.gpuTimerFrames[queryIndex] = static_cast<int>(results.cpuTimes.size());
+		results.gpuTimes.resize(results.cpuTimes.size() + 1, 0.0f);
+	}
+	else
+	{
+		_benchmarkData.gpuTimerFrames[queryIndex] = -1;
+	}
+
+	_benchmarkData.gpuTimerPending[queryIndex] = true;
+	_benchmarkData.gpuTimerScales[queryIndex] = _resolutionScale;
+	_benchmarkData.gpuTimerQueries[queryIndex]->BeginQuery(gls::QueryType::TimeElapsed);
+}
+
+void DeferredRenderer::EndGpuFrameTimer()
+{
+	_benchmarkData.gpuTimerQueries[_benchmarkData.nextGpuTimerQuery]->EndQuery();
+	_benchmarkData.nextGpuTimerQuery = (_benchmarkData.nextGpuTimerQuery + 1) % BenchmarkData::NumGpuTimerQueries;
+}
+
+void DeferredRenderer::ReadGpuFrameTimer(int queryIndex)
+{
+	if (!_benchmarkData.gpuTimerPending[queryIndex])
+		return;
+
+	gls::uint64 timeNs = _benchmarkData.gpuTimerQueries[queryIndex]->GetResultUI64();
+	_gpuFrameTime = static_cast<float>(timeNs) / 1000000.0f;
+	_gpuFrameScale = _benchmarkData.gpuTimerScales[queryIndex];
+	_benchmarkData.gpuTimerPending[queryIndex] = false;
+
+	int frame = _benchmarkData.gpuTimerFrames[queryIndex];
+	if (frame < 0)
+		return;
+
+	auto& results = _benchmarkData.results[_benchmarkData.currentRenderPath];
+	if (static_cast<size_t>(frame) < results.gpuTimes.size())
+		results.gpuTimes[frame] = _gpuFrameTime;
+	_benchmarkData.gpuTimerFrames[queryIndex] = -1;
+}
+
 void DeferredRenderer::UpdateBenchmark(float frameTime)
 {
+	PROFILE_ZONE("UpdateBenchmark");
+
 	if (_demoPlayer.GetState() == DemoPlayer::State::Playing)
 	{
 		if (_benchmarkData.framesToSkip == 0)
 		{
-			// Add current frame time in milliseconds.
+			// Add current frame time in milliseconds. CPU and GPU times are added when the frame is rendered.
 			auto& results = _benchmarkData.results[_benchmarkData.currentRenderPath];
 			results.frameTimes.push_back(frameTime * 1000.0f);
+			_benchmarkData.measureFrame = true;
 		}
 		else
 		{
@@ -2275,6 +3761,10 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 	}
 	else if (_demoPlayer.GetState() == DemoPlayer::State::Ready)
 	{
+		// Collect GPU times still in flight before results of this render path are used.
+		for (int i = 0; i < BenchmarkData::NumGpuTimerQueries; ++i)
+			ReadGpuFrameTimer(i);
+
 		if (_benchmarkData.currentRenderPath == 2 || _demoPlaybackCanceled)
 		{
 			// Benchmark is finished. Play the demo once more in a loop with a fixed step to
@@ -2289,14 +3779,13 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 
 			std::vector<LightObjectVisAndInteractions> lightObjVisAndInteractions;
 			_renderPath = RenderPath::Forward;	// Set to forward so that interactions are calculated.
-			constexpr float FixedDtStep = 1.0f / 60.0f;
-			
-			_demoPlayer.StartPlaying();
+			constexpr float FixedDtStep = BenchmarkData::FixedStepDt;
 
-			auto accumOp = [](const auto& a, const auto& b) { return a + b.size(); };
+			_demoPlayer.StartPlaying();
 
 			while (_demoPlayer.GetState() == DemoPlayer::State::Playing)
 			{
+				ResetFrameData();
 				_demoPlayer.Update(FixedDtStep);
 				UpdateCamera(FixedDtStep);
 				UpdateLights(FixedDtStep);
@@ -2306,8 +3795,7 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 				lightObjVisAndInteractions.push_back({
 					_visibleLights.size(),
 					_visibleObjects.size() + (_showTranspSurfaces ? _visibleTranspObjects.size() : 0),
-					std::accumulate(_interactions.begin(), _interactions.end(), static_cast<size_t>(0), accumOp) +
-						(_showTranspSurfaces ? std::accumulate(_transpInteractions.begin(), _transpInteractions.end(), static_cast<size_t>(0), accumOp) : 0)
+					_interactionLights.size()
 				});
 			}
 
@@ -2323,10 +3811,15 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 				if (!results.valid)
 					continue;
 
+				results.dtStats = ComputeFrameTimeStats(results.frameTimes);
+				results.cpuStats = ComputeFrameTimeStats(results.cpuTimes);
+				results.gpuStats = ComputeFrameTimeStats(results.gpuTimes);
+
 				// Calculate minimum, maximum and average frame times;
 				// calculate frames per second rolling average values over 60 frames.
 				float rcpCount = 1.0f / results.frameTimes.size();
-				std::vector<float> fpsValues;
+				FrameVector<float> fpsValues { FrameAllocator<float>(_frameArena) };
+				fpsValues.reserve(results.frameTimes.size());
 				std::array<float, 60> rollingBuf = { };
 				float timeAccum = 0.0f;
 				int numFrames = 0;
@@ -2393,8 +3886,8 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 			}
 			auto now = std::chrono::system_clock::now();
 			auto ttNow = std::chrono::system_clock::to_time_t(now);
-			std::stringstream csvFileName;
-			csvFileName << dirPath << "results_" << std::put_time(std::localtime(&ttNow), "%F_%H-%M-%S") << "__" << _viewportWidth << "x" << _viewportHeight << ".bmark";
+			std::stringstream resultsFileName;
+			resultsFileName << dirPath << "results_" << std::put_time(std::localtime(&ttNow), "%F_%H-%M-%S") << "__" << _viewportWidth << "x" << _viewportHeight;
 
 			struct Punct : std::numpunct<char>
 			{
@@ -2403,13 +3896,13 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 				virtual std::string do_grouping() const override { return ""; }
 			};
 
-			std::ofstream csvFile(csvFileName.str(), std::ios::binary);
+			std::ofstream csvFile(resultsFileName.str() + ".bmark", std::ios::binary);
 
 			if (csvFile.good())
 			{
 				csvFile.imbue(std::locale(csvFile.getloc(), new Punct));
-				csvFile << "ForwardTime,ForwardDt,ForwardSPTime,ForwardSPDt,DeferredTime,DeferredDt,"
-					"VisInterTime,NumVisObjects,NumVisLights,NumInteractions\n";
+				csvFile << "ForwardTime,ForwardDt,ForwardCpu,ForwardGpu,ForwardSPTime,ForwardSPDt,ForwardSPCpu,ForwardSPGpu,"
+					"DeferredTime,DeferredDt,DeferredCpu,DeferredGpu,VisInterTime,NumVisObjects,NumVisLights,NumInteractions\n";
 
 				float intrTime = 0.0f, rndrTimes[3] = {};
 				bool somethingToWrite = true;
@@ -2418,15 +3911,23 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 					somethingToWrite = false;
 					for (size_t rpInd = 0; rpInd < 3; ++rpInd)
 					{
-						if (i < _benchmarkData.results[rpInd].frameTimes.size())
+						const auto& results = _benchmarkData.results[rpInd];
+						if (i < results.frameTimes.size())
 						{
-							csvFile << rndrTimes[rpInd] << "," << _benchmarkData.results[rpInd].frameTimes[i] << ",";
-							rndrTimes[rpInd] += _benchmarkData.results[rpInd].frameTimes[i] / 1000.0f;
+							csvFile << rndrTimes[rpInd] << "," << results.frameTimes[i] << ",";
+							if (i < results.cpuTimes.size())
+								csvFile << results.cpuTimes[i];
+							csvFile << ",";
+							if (i < results.gpuTimes.size())
+								csvFile << results.gpuTimes[i];
+							csvFile << ",";
+							// Time column is demo time, which lets runs be aligned frame by frame.
+							rndrTimes[rpInd] += _benchmarkData.fixedStep ? BenchmarkData::FixedStepDt : results.frameTimes[i] / 1000.0f;
 							somethingToWrite = true;
 						}
 						else
 						{
-							csvFile << ",,";
+							csvFile << ",,,,";
 						}
 					}
 
@@ -2446,9 +3947,91 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 				}
 			}
 
+			// Write statistics together with build and driver information to a JSON file next to the CSV.
+
+			std::ofstream jsonFile(resultsFileName.str() + ".json", std::ios::binary);
+
+			if (jsonFile.good())
+			{
+				auto jsonString = [](const char* str)
+				{
+					std::string result = "\"";
+					for (const char* ch = str ? str : ""; *ch; ++ch)
+					{
+						if (*ch == '"' || *ch == '\\')
+							result += '\\';
+						if (static_cast<unsigned char>(*ch) >= 0x20)
+							result += *ch;
+					}
+					return result + "\"";
+				};
+
+				const gls::ContextInfo& info = _renderContext->GetInfo();
+
+#if defined (_MSC_VER)
+				std::string compiler = "MSVC " + std::to_string(_MSC_VER);
+#elif defined (__clang__)
+				std::string compiler = std::string("Clang ") + __clang_version__;
+#elif defined (__GNUC__)
+				std::string compiler = std::string("GCC ") + __VERSION__;
+#else
+				std::string compiler = "unknown";
+#endif
+#if defined (NDEBUG)
+				const char* buildType = "Release";
+#else
+				const char* buildType = "Debug";
+#endif
+
+				jsonFile.imbue(std::locale(jsonFile.getloc(), new Punct));
+				jsonFile << "{\n";
+				jsonFile << "\t\"demo\": " << jsonString(_benchmarkData.demoName.c_str()) << ",\n";
+				jsonFile << "\t\"viewport\": [" << _viewportWidth << ", " << _viewportHeight << "],\n";
+				jsonFile << "\t\"fixedStep\": " << (_benchmarkData.fixedStep ? "true" : "false") << ",\n";
+				jsonFile << "\t\"halfResLighting\": " << (_halfResLighting ? "true" : "false") << ",\n";
+				jsonFile << "\t\"build\": {\n";
+				jsonFile << "\t\t\"type\": " << jsonString(buildType) << ",\n";
+				jsonFile << "\t\t\"compiler\": " << jsonString(compiler.c_str()) << ",\n";
+				jsonFile << "\t\t\"date\": " << jsonString(__DATE__ " " __TIME__) << "\n";
+				jsonFile << "\t},\n";
+				jsonFile << "\t\"driver\": {\n";
+				jsonFile << "\t\t\"vendor\": " << jsonString(info.vendor) << ",\n";
+				jsonFile << "\t\t\"renderer\": " << jsonString(info.renderer) << ",\n";
+				jsonFile << "\t\t\"version\": " << jsonString(info.versionString) << ",\n";
+				jsonFile << "\t\t\"shadingLanguageVersion\": " << jsonString(info.shadingLanguageVersion) << "\n";
+				jsonFile << "\t},\n";
+				jsonFile << "\t\"renderPaths\": {\n";
+
+				const char* rpathNames[] = { "Forward", "ForwardSP", "Deferred" };
+				bool first = true;
+				for (size_t rpInd = 0; rpInd < 3; ++rpInd)
+				{
+					const auto& results = _benchmarkData.results[rpInd];
+					if (!results.valid)
+						continue;
+
+					jsonFile << (first ? "" : ",\n") << "\t\t\"" << rpathNames[rpInd] << "\": {\n";
+					jsonFile << "\t\t\t\"frameTime\": ";
+					WriteFrameTimeStatsJson(jsonFile, results.dtStats, "\t\t\t");
+					jsonFile << ",\n\t\t\t\"cpuTime\": ";
+					WriteFrameTimeStatsJson(jsonFile, results.cpuStats, "\t\t\t");
+					jsonFile << ",\n\t\t\t\"gpuTime\": ";
+					WriteFrameTimeStatsJson(jsonFile, results.gpuStats, "\t\t\t");
+					jsonFile << "\n\t\t}";
+					first = false;
+				}
+
+				jsonFile << "\n\t}\n";
+				jsonFile << "}\n";
+			}
+
 			// We can now discard frame times.
 			for (auto& results : _benchmarkData.results)
+			{
 				results.frameTimes.clear();
+				results.cpuTimes.clear();
+				results.gpuTimes.clear();
+			}
 
 			// Revert old settings and activate the benchmark results popup dialog.
 
@@ -2469,3 +4052,127 @@ void DeferredRenderer::UpdateBenchmark(float frameTime)
 		}
 	}
 }
+
+bool DeferredRenderer::RunHeadlessBenchmark(const char* demoName, int width, int height, gls::ICommandLogger* commandLogger)
+{
+	// Run the whole benchmark on the null render context. Nothing is drawn, so only CPU times and command
+	// counts are meaningful, but they are deterministic thanks to the fixed step.
+
+	gls::CreateNullContextInfo info;
+	info.version = 440;
+	info.width = width;
+	info.height = height;
+	info.logger = &_console;
+	info.commandLogger = commandLogger;
+
+	_nullRenderContext = gls::CreateNullRenderContext(info);
+	_renderContext = _nullRenderContext;
+
+	if (!_renderContext || !InitCommon())
+		return false;
+
+	OnResize(width, height);
+
+	_fixedStepBenchmark = true;
+	StartBenchmark(demoName);
+	if (_runMode != RunMode::Benchmark)
+	{
+		_console.PrintLn("Failed to load demo: %s", demoName);
+		Deinit();
+		return false;
+	}
+
+	const char* rpathNames[] = {
+		"Forward",
+		"Forward SP",
+		"Deferred",
+	};
+
+	int renderPath = _benchmarkData.currentRenderPath;
+	float frameTime = BenchmarkData::FixedStepDt;
+	_nullRenderContext->ResetStats();
+
+	while (_runMode == RunMode::Benchmark)
+	{
+		auto frameStart = std::chrono::high_resolution_clock::now();
+
+		Update(frameTime);
+
+		if (_runMode != RunMode::Benchmark || _benchmarkData.currentRenderPath != renderPath)
+		{
+			PrintHeadlessStats(rpathNames[renderPath], _benchmarkData.results[renderPath]);
+			_nullRenderContext->ResetStats();
+			renderPath = _benchmarkData.currentRenderPath;
+		}
+
+		Render();
+
+		std::chrono::duration<float> elapsed = std::chrono::high_resolution_clock::now() - frameStart;
+		frameTime = elapsed.count();
+	}
+
+	for (int rpathInd = 0; rpathInd < CountOf(rpathNames); ++rpathInd)
+	{
+		const auto& results = _benchmarkData.results[rpathInd];
+		if (results.valid)
+		{
+			_console.PrintLn("%-12s CPU median %.3f ms, p99 %.3f ms, %d spikes",
+				rpathNames[rpathInd], results.cpuStats.median, results.cpuStats.p99, static_cast<int>(results.cpuStats.spikes.size()));
+		}
+	}
+
+	Deinit();
+	return true;
+}
+
+void DeferredRenderer::PrintHeadlessStats(const char* renderPathName, const BenchmarkData::Results& results)
+{
+	const gls::RenderStats& stats = _nullRenderContext->GetStats();
+	double rcpFrames = stats.frames ? 1.0 / stats.frames : 0.0;
+	double rcpMeasuredFrames = results.cpuTimes.empty() ? 0.0 : 1.0 / results.cpuTimes.size();
+
+	_console.PrintLn("%-12s %llu frames; per frame: %.1f draws, %.0f vertices, %.1f shader changes, %.1f bindings, %.1f state changes, %.1f KB uploaded, %.2f heap allocations",
+		renderPathName, static_cast<unsigned long long>(stats.frames), stats.drawCalls * rcpFrames, stats.vertices * rcpFrames,
+		stats.shaderChanges * rcpFrames, stats.resourceBindings * rcpFrames, stats.stateChanges * rcpFrames,
+		(stats.bufferBytesUploaded + stats.textureBytesUploaded) * rcpFrames / 1024.0, results.heapAllocations * rcpMeasuredFrames);
+}
+
+#if defined (ENABLE_PROFILER)
+
+void DeferredRenderer::StartTraceCapture(int numFrames)
+{
+	_traceFramesLeft = numFrames;
+	BeginProfilerCapture();
+}
+
+void DeferredRenderer::UpdateTraceCapture()
+{
+	if (_traceFramesLeft == 0 || --_traceFramesLeft > 0)
+		return;
+
+	EndProfilerCapture();
+
+	std::string dirPath = GetFullPath("../Traces/");
+	if (!std::filesystem::exists(dirPath))
+	{
+		std::error_code ec;
+		std::filesystem::create_directory(dirPath, ec);
+	}
+	auto ttNow = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	std::stringstream traceFileName;
+	traceFileName << dirPath << "trace_" << std::put_time(std::localtime(&ttNow), "%F_%H-%M-%S") << ".json";
+
+	uint64_t droppedZones = 0;
+	if (WriteProfilerTrace(traceFileName.str().c_str(), &droppedZones))
+	{
+		_console.PrintLn("CPU trace written to %s", traceFileName.str().c_str());
+		if (droppedZones > 0)
+			_console.PrintLn("Warning: %llu profile zones didn't fit into the trace buffers.", static_cast<unsigned long long>(droppedZones));
+	}
+	else
+	{
+		_console.PrintLn("Error: failed to write CPU trace to %s", traceFileName.str().c_str());
+	}
+}
+
+#endif // ENABLE_PROFILER
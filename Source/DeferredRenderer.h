@@ -3,13 +3,22 @@
 
 #include <vector>
 #include <array>
+#include <string>
+#include <chrono>
+#include <random>
 #include <Math/math3d.h>
 #include <GLSlayer/RenderContext.h>
+#include <GLSlayer/NullRenderContext.h>
 #include <imgui/imgui.h>
 #include "IRenderer.h"
 #include "Console.h"
 #include "ObjScene.h"
 #include "DemoPlayer.h"
+#include "ShaderCache.h"
+#include "BenchmarkStats.h"
+#include "LightGrid.h"
+#include "LightInteractionCache.h"
+#include "FrameArena.h"
 
 
 class DeferredRenderer : public IRenderer
@@ -18,6 +27,8 @@ public:
 	DeferredRenderer() = default;
 	~DeferredRenderer();
 
+	DeferredRenderer& operator = (DeferredRenderer&&) = default;
+
 	virtual bool Init(gls::CreateContextInfo& info) override;
 	virtual void Deinit() override;
 	virtual gls::FramebufferFormat GetFramebufferFormat() override;
@@ -35,8 +46,11 @@ public:
 	virtual void OnRBtnUp(int x, int y) override;
 	virtual void OnLostKeyboardFocus() override;
 
+	bool RunHeadlessBenchmark(const char* demoName, int width, int height, gls::ICommandLogger* commandLogger);
+
 private:
-	static constexpr int MaxLights = 1000;
+	static constexpr int MaxRandomLights = 500000;
+	static constexpr size_t InitialLightBufferCapacity = 1024;
 	static constexpr float MovementSpeed = 200.0f;
 	static constexpr float FastMovementSpeed = 400.0f;
 	static constexpr float LightMinFalloffExp = 0.9f;
@@ -47,6 +61,21 @@ private:
 	static constexpr float DefaultFOV = 70.0f;
 	static constexpr float MinFOV = 30.0f;
 	static constexpr float MaxFOV = 120.0f;
+	static constexpr float NearPlane = 10.0f;
+	static constexpr float FarPlane = 4000.0f;
+	static constexpr float SmallLightMaxScreenFraction = 0.05f;	// Lights covering at most this part of the screen are shaded with quads.
+	static constexpr int TraceCaptureFrames = 300;
+	static constexpr float MinResolutionScale = 0.5f;
+	static constexpr float ResolutionBudgetFraction = 0.9f;	// Part of the frame budget dynamic resolution aims for.
+	static constexpr float ResolutionDeadZone = 0.02f;		// Smaller scale changes are ignored.
+	static constexpr float MaxResolutionStepDown = 0.9f;	// Largest relative changes of the scale in one frame.
+	static constexpr float MaxResolutionStepUp = 1.02f;
+	static constexpr float FrameTimeSmoothing = 0.1f;
+	static constexpr float InteractionCandidateMarginTime = 0.5f;	// Seconds of light movement covered by cached interaction candidates.
+	static constexpr int ImGuiBufferFrames = 3;	// Frames of UI geometry the ImGui buffers hold; the GPU may still read the older ones.
+	static constexpr std::array<int, 4> LightCountBuckets = { 1, 4, 16, 64 };	// Light loop permutations; larger counts use the generic shader.
+
+	using LightLoopShaders = std::array<gls::IFragmentShader*, LightCountBuckets.size()>;
 
 	enum class RenderPath : int
 	{
@@ -87,54 +116,129 @@ private:
 	struct BenchmarkData
 	{
 		static constexpr int NumStartFramesToSkip = 5;
+		static constexpr float FixedStepDt = 1.0f / 60.0f;
+		static constexpr int NumGpuTimerQueries = 4;
 
 		struct Results
 		{
 			std::vector<float> frameTimes;
+			std::vector<float> cpuTimes;	// Update and render CPU time per frame in milliseconds.
+			std::vector<float> gpuTimes;	// GPU time per frame in milliseconds.
 			float averageDt;
 			float minDt;
 			float maxDt;
 			float averageFPS;
 			float minFPS;
 			float maxFPS;
+			FrameTimeStats dtStats;
+			FrameTimeStats cpuStats;
+			FrameTimeStats gpuStats;
+			uint64_t heapAllocations = 0;	// Made by the measured frames.
 			bool valid;
 		};
 		
 		std::array<Results, 3> results;	// Results for 3 render paths.
+		std::string demoName;
 		int currentRenderPath;
 		int framesToSkip;
+		bool fixedStep = false;		// Advance the demo by FixedStepDt per frame instead of by wall-clock time.
+		bool measureFrame = false;	// Record CPU and GPU times for the frame being rendered.
+		std::array<gls::IQuery*, NumGpuTimerQueries> gpuTimerQueries = {};
+		std::array<int, NumGpuTimerQueries> gpuTimerFrames = {};	// Benchmark frame index measured by each query, -1 if none.
+		std::array<bool, NumGpuTimerQueries> gpuTimerPending = {};	// Query was issued and its result not read yet.
+		std::array<float, NumGpuTimerQueries> gpuTimerScales = {};	// Resolution scale of the frame measured by each query.
+		int nextGpuTimerQuery = 0;
 		RenderPath oldRenderPath;
 		bool oldVsync;
 		bool oldShowLightSources;
 	};
 
-	gls::IVertexShader* LoadVertexShader(const char* fileName);
-	gls::IFragmentShader* LoadFragmentShader(const char* fileName);
+	// Points as separate arrays of coordinates, which the batched transform processes four at a time.
+	struct PointArrays
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+
+		void Resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); }
+		void Set(size_t i, const math3d::vec3f& p) { x[i] = p.x; y[i] = p.y; z[i] = p.z; }
+		math3d::vec3f Get(size_t i) const { return math3d::vec3f(x[i], y[i], z[i]); }
+	};
+
+	// Indirect draws of a mesh's visible clusters in _clusterDraws.
+	struct ClusterDrawRange
+	{
+		int32_t first;
+		int32_t count;
+	};
+
+	// Lights of an object in _interactionLights. Also the per-instance vertex attribute of single pass draws.
+	struct LightRange
+	{
+		int32_t first;
+		int32_t count;
+	};
+
+	struct PendingShaderBuild
+	{
+		gls::IShader* shader;
+		std::string fileName;
+		std::string source;
+	};
+
+	gls::IVertexShader* LoadVertexShader(const char* fileName, const std::vector<std::string>& defines = {});
+	gls::IFragmentShader* LoadFragmentShader(const char* fileName, const std::vector<std::string>& defines = {});
+	gls::IFragmentShader* SelectLightLoopShader(const LightLoopShaders& bucketShaders, gls::IFragmentShader* genericShader, int numLights);
+	bool FinishShaderBuild(gls::IShader* shader);
+	void FinishPendingShaderBuilds(bool wait);
+	bool IsShaderReady(gls::IShader* shader);
 	void CreateFramebuffers(int width, int height);
 	void DestroyFramebuffers();
+	void DrawMesh(const ObjScene::Mesh* mesh);
 	void RenderGeometryPass();
+	void DrawViewportRect();
+	void DownsampleGBuffer();
 	void RenderLightingPass();
+	void UpsampleLighting();
 	void RenderGBufferPreview();
 	void RenderForward();
 	void RenderForwardSinglePass();
 	void RenderForwardTransparent();
 	void RenderForwardTransparentSinglePass();
+	void RenderTransparentOIT();
+	void RenderTransparentSurfaces();
+	void BlitSceneToScreen();
 	void RenderLightSources();
 	void RenderImGui();
+	void ReserveImGuiBuffers(size_t numVertices, size_t numIndices);
+	void DestroyImGuiBuffers();
 	void ImGuiSettingsDlg();
 	void ImGuiDemoDlg();
 	void ImGuiRecordingOverlay(float frameTime);
 	void ImGuiBenchmarkResultsDlg();
 	void CreateRandomLights(int count, const math3d::vec3f& min_pt, const math3d::vec3f& max_pt);
+	void ReserveLightBuffers(size_t numLights);
+	void ReserveLightIndexBuffer(size_t numIndices);
 	void CreateNewLight(const math3d::vec3f& position, const math3d::vec3f& moveDir);
 	void RemoveAllLights();
 	void CreateSphere(float radius, int slices, int stacks);
 	void DestroySphere();
+	void ResetFrameData();
 	void UpdateCamera(float frameTime);
+	void UpdateResolutionScale();
+	void UpdateRenderSize();
 	void UpdateProjectionMatrix();
 	void UpdateLights(float frameTime);
 	void UpdateVisibleObjects();
+	void TransformToView(const PointArrays& points, PointArrays& viewPoints, size_t first, size_t count) const;
+	int CullClusters(int meshInd, const ObjScene::Lod& lod, bool cullBackFacing, ClusterDrawRange& range);
 	void UpdateLightObjectInteractions();
+	LightRange GetInteractions(size_t objInd) const;
+	LightRange GetTranspInteractions(size_t objInd) const;
+	void UploadInteractions();
+	void ClassifyLights();
+	void UpdateInteractionsIncremental(bool opaqueNeeded, bool transpNeeded);
+	void ValidateInteractions();
 
 	void RecordDemo(const char* demoName);
 	void PlayDemo(const char* demoName);
@@ -142,9 +246,17 @@ private:
 	void PlayerSampleUpdate(int32_t id, size_t size, const void* data);
 	void RecorderSamplingFunc();
 	void StartBenchmark(const char* demoName);
+	void BeginGpuFrameTimer();
+	void EndGpuFrameTimer();
+	void ReadGpuFrameTimer(int queryIndex);
 	void UpdateBenchmark(float frameTime);
+	bool InitCommon();
+	void PrintHeadlessStats(const char* renderPathName, const BenchmarkData::Results& results);
+	void StartTraceCapture(int numFrames);
+	void UpdateTraceCapture();
 
 	gls::IRenderContext* _renderContext = nullptr;
+	gls::INullRenderContext* _nullRenderContext = nullptr;	// Set when running headless; same object as _renderContext.
 	gls::IFramebuffer* _gbuffer = nullptr;
 	gls::ITexture2D* _texDiffuse = nullptr;
 	gls::ITexture2D* _texNormal = nullptr;
@@ -152,48 +264,102 @@ private:
 	gls::ITexture2D* _depthBuffer = nullptr;
 	gls::IFramebuffer* _sceneBuffer = nullptr;
 	gls::ITexture2D* _texSceneColor = nullptr;
+	gls::IFramebuffer* _transpBuffer = nullptr;
+	gls::ITexture2D* _texTranspAccum = nullptr;		// Sum of weighted premultiplied colors and weighted alphas.
+	gls::ITexture2D* _texTranspRevealage = nullptr;	// Product of (1 - alpha) of transparent surfaces.
+	gls::IFramebuffer* _halfResGBuffer = nullptr;		// Every other pixel of the G-buffer, for half resolution lighting.
+	gls::ITexture2D* _texHalfPosition = nullptr;
+	gls::ITexture2D* _texHalfNormal = nullptr;
+	gls::ITexture2D* _halfResDepthBuffer = nullptr;
+	gls::IFramebuffer* _halfResLightBuffer = nullptr;
+	gls::ITexture2D* _texHalfLighting = nullptr;		// Sum of the light reaching the surfaces, without albedo.
 	gls::ITextureBuffer* _lightInfoTex = nullptr;
 	gls::IBuffer* _lightInfoBuf = nullptr;
 	gls::ITextureBuffer* _lightIndexTex = nullptr;
-	gls::IBuffer* _lightIndexBuf = nullptr;
+	gls::IBuffer* _lightIndexBuf = nullptr;		// Interaction lists of all visible objects.
+	size_t _lightBufferCapacity = 0;	// Number of lights _lightInfoBuf can hold.
+	size_t _lightIndexCapacity = 0;		// Number of light indices _lightIndexBuf can hold.
+	gls::IBuffer* _meshLightRangeBuf = nullptr;		// LightRange of each mesh, indexed by the draw's base instance.
+
+	// Memory for data built and used within one frame. Vectors using it are emptied by ResetFrameData at the
+	// start of Update, before the arena is reset.
+	FrameArena _frameArena;
+	uint64_t _frameStartHeapAllocations = 0;
+	int _frameHeapAllocations = 0;		// Heap allocations made by the last whole frame.
+	FrameVector<math3d::vec4f> _lightInfoData { FrameAllocator<math3d::vec4f>(_frameArena) };	// Palette of visible lights for _lightInfoBuf, two texels per light.
+	FrameVector<math3d::vec4f> _lightQuadVerts { FrameAllocator<math3d::vec4f>(_frameArena) };	// Screen rectangles of quad shaded lights; w holds the palette index.
+	FrameVector<const PointLight*> _sphereLights { FrameAllocator<const PointLight*>(_frameArena) };	// Visible lights shaded with stencil tested spheres.
+	// Lights interacting with the visible objects, opaque objects first and transparent ones after them. Lights of
+	// object i are _interactionLights[_interactionOffsets[i]] up to the next object's offset, sorted by their
+	// visible index. Lists the render path doesn't need are empty.
+	FrameVector<int32_t> _interactionOffsets { FrameAllocator<int32_t>(_frameArena) };
+	FrameVector<int32_t> _interactionLights { FrameAllocator<int32_t>(_frameArena) };
 
 	gls::IFragmentShader* _fragShaderGeometryPass = nullptr;
 	gls::IVertexShader* _vertShaderScreenSpace = nullptr;
 	gls::IFragmentShader* _fragShaderVisGBuffer = nullptr;
 	gls::IVertexShader* _vertShaderLightingPass = nullptr;
 	gls::IFragmentShader* _fragShaderLightingPass = nullptr;
+	gls::IVertexShader* _vertShaderLightQuad = nullptr;
+	gls::IFragmentShader* _fragShaderLightingPassQuad = nullptr;
+	gls::IFragmentShader* _fragShaderLightingPassHalfRes = nullptr;
+	gls::IFragmentShader* _fragShaderLightingPassQuadHalfRes = nullptr;
+	gls::IFragmentShader* _fragShaderDownsampleGBuffer = nullptr;
+	gls::IFragmentShader* _fragShaderLightingUpsample = nullptr;
 	gls::IVertexShader* _vertShaderLightSource = nullptr;
 	gls::IFragmentShader* _fragShaderLightSource = nullptr;
 	gls::IVertexShader* _vertShaderImGui = nullptr;
 	gls::IFragmentShader* _fragShaderImGui = nullptr;
 	gls::IVertexShader* _vertShaderForward = nullptr;
+	gls::IVertexShader* _vertShaderForwardSP = nullptr;
 	gls::IFragmentShader* _fragShaderForward = nullptr;
 	gls::IFragmentShader* _fragShaderForwardSP = nullptr;
 	gls::IFragmentShader* _fragShaderForwardTransp = nullptr;
 	gls::IFragmentShader* _fragShaderForwardTranspSP = nullptr;
+	LightLoopShaders _fragShaderForwardSPBuckets = {};
+	LightLoopShaders _fragShaderForwardTranspSPBuckets = {};
+	gls::IFragmentShader* _fragShaderForwardTranspOIT = nullptr;
+	LightLoopShaders _fragShaderForwardTranspOITBuckets = {};
+	gls::IFragmentShader* _fragShaderTranspResolve = nullptr;
 	gls::IVertexShader* _vertShaderDepthOnly = nullptr;
 
 	gls::IVertexFormat* _vertexFormat = nullptr;
 	gls::IVertexFormat* _vertFmtScreenRect = nullptr;
 	gls::IVertexFormat* _vertFmtSphere = nullptr;
+	gls::IVertexFormat* _vertFmtLightQuad = nullptr;
+	gls::IVertexFormat* _vertFmtLightRange = nullptr;	// Scene vertices with a LightRange per instance in stream 1.
 	gls::IVertexFormat* _vertFmtImGui = nullptr;
 
 	gls::IBuffer* _ubufSceneXformData = nullptr;
 	gls::IBuffer* _ubufLightData = nullptr;
 	gls::IBuffer* _ubufGbufferTexViewData = nullptr;
+	gls::IBuffer* _ubufUpsampleData = nullptr;
 	gls::IBuffer* _ubufImGui = nullptr;
 
 	gls::IBuffer* _rectVertBuf = nullptr;
 	gls::IBuffer* _sphereVertBuf = nullptr;
 	gls::IBuffer* _sphereIndexBuf = nullptr;
+	// The ImGui buffers are split into ImGuiBufferFrames parts, used in turn, and stay mapped. A fence marks when
+	// the GPU is done with a part.
 	gls::IBuffer* _imGuiVertBuffer = nullptr;
 	gls::IBuffer* _imGuiIndexBuffer = nullptr;
+	ImDrawVert* _imGuiVertices = nullptr;
+	ImDrawIdx* _imGuiIndices = nullptr;
+	size_t _imGuiVertCapacity = 0;		// Vertices and indices one part of the buffers can hold.
+	size_t _imGuiIndexCapacity = 0;
+	gls::SyncObject _imGuiFences[ImGuiBufferFrames] = {};
+	int _imGuiBufferFrame = 0;
+	gls::IBuffer* _clusterDrawBuf = nullptr;
+	gls::IBuffer* _lightQuadVertBuf = nullptr;	// Six vertices per light, holds as many lights as _lightInfoBuf.
 
 	gls::ISamplerState* _samplerSurfaceTex = nullptr;
 	gls::ISamplerState* _samplerLinearClamp = nullptr;
 	gls::ISamplerState* _samplerGBuffer = nullptr;
 
 	ObjScene _sponzaScene;
+	ShaderCache _shaderCache;
+	std::vector<PendingShaderBuild> _pendingShaders;
+	std::vector<gls::IShader*> _failedShaders;
 	Console _console;
 	DemoPlayer _demoPlayer;
 	ImGuiIO* _imGuiIO = nullptr;
@@ -202,10 +368,35 @@ private:
 	math3d::mat4f _viewMat, _projMat, _viewProjMat;
 	std::vector<PointLight> _lights;
 	std::vector<const PointLight*> _visibleLights;
+	std::vector<int32_t> _lightVisibleIndex;	// Index of each light in _visibleLights, -1 if not visible.
+	LightGrid _lightGrid;
 	std::vector<const ObjScene::Mesh*> _visibleObjects;
 	std::vector<const ObjScene::Mesh*> _visibleTranspObjects;
-	std::vector<std::vector<int32_t>> _interactions;
-	std::vector<std::vector<int32_t>> _transpInteractions;
+	LightInteractionCache _interactionCache;
+	std::vector<int32_t> _meshObjectIndex;		// Object index of each visible mesh in the interaction lists, -1 for the others.
+	std::vector<LightRange> _meshLightRanges;	// Uploaded to _meshLightRangeBuf with the interactions.
+	size_t _interactionCount = 0;	// Sum of the lengths of the interaction lists of the last frame.
+	std::vector<int32_t> _validationInteractions;	// Lists of a full rebuild, one object at a time.
+	math3d::mat4f _visibleObjectsViewProjMat;	// View-projection matrix the visible object lists were found with.
+	bool _visibleObjectsValid = false;
+	bool _visibleObjectsShowTransp = false;
+	std::vector<uint8_t> _meshLods;		// Level of detail drawn for each mesh, chosen with the visible objects.
+	int _visibleTriangles = 0;
+	bool _meshLodsEnabled = true;
+	float _lodErrorPixels = 1.0f;		// Largest screen space error of a level of detail.
+	std::vector<gls::DrawIndexedIndirectData> _clusterDraws;	// Uploaded to _clusterDrawBuf with the visible objects.
+	std::vector<ClusterDrawRange> _meshClusterDraws;
+	PointArrays _meshCenters;		// Bounding box centers, transformed to view space in one batch for culling.
+	PointArrays _meshViewCenters;
+	PointArrays _clusterCenters;
+	PointArrays _clusterViewCenters;
+	int _visibleClusters = 0;
+	int _testedClusters = 0;		// Clusters of the chosen levels of detail of meshes inside the frustum.
+	bool _clusterCulling = true;
+	bool _smallLightQuads = true;
+	int _quadShadedLights = 0;
+	bool _incrementalInteractions = true;
+	bool _validateInteractions = false;
 	std::vector<math3d::vec4f> _frustumPlanes;
 	std::vector<float> _framerateValues;
 	float _framerateValueAddTime = 0.0f;
@@ -218,6 +409,14 @@ private:
 	math3d::vec3f _lightBoundsMax;
 	int _viewportWidth = 0;
 	int _viewportHeight = 0;
+	int _renderWidth = 0;		// Size of the framebuffer region the scene is rendered to, before upscaling.
+	int _renderHeight = 0;
+	bool _dynamicResolution = false;
+	float _frameBudgetMs = 16.7f;
+	float _resolutionScale = 1.0f;
+	float _fullResFrameTime = 0.0f;		// Smoothed estimate of the GPU frame time at full resolution, in milliseconds.
+	float _gpuFrameTime = 0.0f;			// GPU time of the last frame read from the timer queries, in milliseconds.
+	float _gpuFrameScale = 1.0f;		// Resolution scale that frame was rendered at.
 	math3d::vec3f _cameraPosition;
 	math3d::vec3f _cameraForwardVector;
 	math3d::vec3f _cameraRightVector;
@@ -242,6 +441,8 @@ private:
 	bool _bmarkResultsDlgVisible = false;
 	bool _showLightSources = true;
 	bool _showTranspSurfaces = true;
+	bool _oitTransparency = false;
+	bool _halfResLighting = false;
 
 	math3d::vec3f _newLightColor = math3d::vec3f(1.0f, 1.0f, 1.0f);
 	float _newLightFalloffExponent = 1.0f;
@@ -253,12 +454,16 @@ private:
 	bool _newLightRandomParams = true;
 	float _lightSourceSpeed = 70.0f;
 	int _randomLightsToCreate = 128;
+	std::mt19937 _lightRandomGen { std::random_device{}() };
 
 	float _demoRecordingTimer = 0.0f;
 	bool _demoSampleLights = false;
 	bool _loopDemoPlayback = false;
 	bool _demoPlaybackCanceled = false;
+	bool _fixedStepBenchmark = true;
 	BenchmarkData _benchmarkData;
+	std::chrono::high_resolution_clock::time_point _frameStartTime;
+	int _traceFramesLeft = 0;
 };
 
 #endif // _DEFERRED_RENDERER_H_
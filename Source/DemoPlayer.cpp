@@ -1,9 +1,116 @@
 #include "DemoPlayer.h"
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <Math/transform.h>
 #include "Utils.h"
 
 namespace fs = std::filesystem;
 
+
+// Version 2 and later demo files start with this header. The sample blocks that follow have the same layout as in
+// version 1 files, which have no header at all: [float time][int32 id, int32 size, data]... -1, with the
+// last block ending with -2 instead. The blocks are followed by keyframe snapshots (sample records of the
+// complete state, ending with -1), the block index and the keyframe index. Since version 3, keyframe records
+// don't copy the sample data: their size is SampleRefSize and it's followed by the uint64 file offset of
+// the data of the same sample's record in a block, so large samples like the light list are stored once.
+#pragma pack(push, 1)
+struct DemoFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	float duration;
+	uint32_t blockCount;
+	uint32_t keyframeCount;
+	uint64_t blockIndexOffset;
+	uint64_t keyframeIndexOffset;
+};
+
+struct DemoBlockIndexEntry
+{
+	float time;
+	uint64_t offset;
+};
+
+struct DemoKeyframeIndexEntry
+{
+	float time;
+	uint32_t blockIndex;
+	uint64_t offset;
+};
+#pragma pack(pop)
+
+static constexpr uint32_t DemoFileMagic = 0x4F4D4544;	// "DEMO"
+static constexpr uint32_t DemoFileVersion = 3;
+static constexpr int32_t SampleRefSize = -1;
+
+template <typename T>
+static bool ReadValue(const char*& ptr, const char* end, T& value)
+{
+	if (end - ptr < static_cast<ptrdiff_t>(sizeof(T)))
+		return false;
+
+	memcpy(&value, ptr, sizeof(T));
+	ptr += sizeof(T);
+	return true;
+}
+
+// Calls func(id, size, data) for every sample record starting at offset, up to the end of the block.
+// Returns false if a record runs past the end of the data.
+template <typename Func>
+static bool ForEachSample(const char* data, size_t dataSize, size_t offset, Func func)
+{
+	const char* ptr = data + offset;
+	const char* end = data + dataSize;
+
+	while (true)
+	{
+		int32_t id;
+		if (!ReadValue(ptr, end, id))
+			return false;
+
+		// End of sample block or end of demo.
+		if (id == -1 || id == -2)
+			return true;
+
+		int32_t size;
+		if (!ReadValue(ptr, end, size))
+			return false;
+
+		if (size == SampleRefSize)
+		{
+			// The referenced data is preceded by its size, like in any sample record.
+			uint64_t dataOffset;
+			if (!ReadValue(ptr, end, dataOffset) || dataOffset < 4 || dataOffset > dataSize)
+				return false;
+
+			const char* refPtr = data + dataOffset - 4;
+			int32_t refSize;
+			if (!ReadValue(refPtr, end, refSize) || refSize < 0 || end - refPtr < refSize)
+				return false;
+
+			if (!func(id, static_cast<size_t>(refSize), refPtr))
+				return true;
+
+			continue;
+		}
+
+		if (size < 0 || end - ptr < size)
+			return false;
+
+		if (!func(id, static_cast<size_t>(size), ptr))
+			return true;
+
+		ptr += size;
+	}
+}
+
+static void AppendValue(std::vector<char>& buffer, const void* data, size_t size)
+{
+	const char* start = reinterpret_cast<const char*>(data);
+	buffer.insert(buffer.end(), start, start + size);
+}
+
 DemoPlayer::~DemoPlayer()
 {
 	if (_state == State::Playing)
@@ -12,10 +119,18 @@ DemoPlayer::~DemoPlayer()
 		StopRecording();
 }
 
-void DemoPlayer::SetCallbacks(RecorderSamplingFunc samplingFunc, PlayerSampleUpdaterFunc sampleUpdaterFunc)
+void DemoPlayer::SetCallbacks(RecorderSamplingFunc samplingFunc, PlayerSampleUpdaterFunc sampleUpdaterFunc, InterpolationMap interpolation)
 {
 	_samplingFunc = std::move(samplingFunc);
 	_sampleUpdaterFunc = std::move(sampleUpdaterFunc);
+
+	_interpolatedSamples.clear();
+	for (const auto& [id, interp] : interpolation)
+	{
+		if (interp != Interpolation::Step)
+			_interpolatedSamples[id].interpolation = interp;
+	}
+	ResetInterpolatedSamples();
 }
 
 const std::vector<std::string>& DemoPlayer::GetDemoList() const
@@ -85,16 +200,24 @@ bool DemoPlayer::StartRecording(const char* demoName, float freqHz)
 	if (_recordFile == nullptr)
 		return false;
 
+	// The header is written again with the final counts and offsets when the recording stops.
+	DemoFileHeader header = {};
+	header.magic = DemoFileMagic;
+	header.version = DemoFileVersion;
+	fwrite(&header, sizeof(header), 1, _recordFile);
+
 	_samplePeriod = 1.0f / std::clamp(freqHz, 10.0f, 120.0f);
 	_sampleTime = 0.0f;
 	_currentTime = 0.0f;
+	_lastKeyframeTime = 0.0f;
+	_recordedBlocks.clear();
+	_recordedKeyframes.clear();
 	_state = State::Recording;
 
 	// Write the first block with time stamp 0.
 	_numSamplesWritten = 0;
 	_samplingFunc();
-	uint32_t endId = -1;
-	fwrite(&endId, 4, 1, _recordFile);
+	EndRecordedBlock();
 
 	return true;
 }
@@ -115,22 +238,32 @@ void DemoPlayer::RecordSample(int32_t id, RecCond recCond, size_t size, const vo
 
 		// If this is the first sample in this block, write the current time before it.
 		if (_numSamplesWritten == 0)
+		{
 			fwrite(&_currentTime, 4, 1, _recordFile);
+			_recordedBlocks.push_back({ _currentTime, static_cast<size_t>(ftell(_recordFile)) });
+		}
 
 		fwrite(&id, 4, 1, _recordFile);
 		int32_t size32 = static_cast<int32_t>(size);
 		fwrite(&size32, 4, 1, _recordFile);
+		_lastRecordedOffsetMap[id] = static_cast<uint64_t>(ftell(_recordFile));
 		fwrite(data, 1, size, _recordFile);
-		const char* start = reinterpret_cast<const char*>(data);
-		const char* end = reinterpret_cast<const char*>(data) + size;
-		_lastRecordedDataMap[id] = std::vector(start, end);
+
+		// Only samples recorded if changed need their last value kept in memory. The value is copied into the
+		// vector kept from the previous sample, which allocates only if the sample grew.
+		if (recCond == RecCond::IfChanged)
+		{
+			const char* start = reinterpret_cast<const char*>(data);
+			const char* end = reinterpret_cast<const char*>(data) + size;
+			_lastRecordedDataMap[id].assign(start, end);
+		}
 		_numSamplesWritten++;
 	}
 	else if (_state == State::Ready)
 	{
 		const char* start = reinterpret_cast<const char*>(data);
 		const char* end = reinterpret_cast<const char*>(data) + size;
-		_initialDataMap[id] = std::vector(start, end);
+		_initialDataMap[id].assign(start, end);
 	}
 }
 
@@ -146,11 +279,40 @@ void DemoPlayer::StopRecording()
 {
 	if (_state == State::Recording)
 	{
-		// Write the last empty block and close the file.
+		// Write the last empty block.
 		fwrite(&_currentTime, 4, 1, _recordFile);
 		int32_t endId = -2;
 		fwrite(&endId, 4, 1, _recordFile);
 
+		// Write the keyframe snapshots and the indices, then fill in the header and close the file.
+		std::vector<DemoKeyframeIndexEntry> keyframeIndex;
+		keyframeIndex.reserve(_recordedKeyframes.size());
+		for (const RecordedKeyframe& keyframe : _recordedKeyframes)
+		{
+			keyframeIndex.push_back({ keyframe.time, keyframe.blockIndex, static_cast<uint64_t>(ftell(_recordFile)) });
+			fwrite(keyframe.samples.data(), 1, keyframe.samples.size(), _recordFile);
+		}
+
+		DemoFileHeader header;
+		header.magic = DemoFileMagic;
+		header.version = DemoFileVersion;
+		header.duration = _currentTime;
+		header.blockCount = static_cast<uint32_t>(_recordedBlocks.size());
+		header.keyframeCount = static_cast<uint32_t>(keyframeIndex.size());
+
+		header.blockIndexOffset = ftell(_recordFile);
+		for (const BlockInfo& block : _recordedBlocks)
+		{
+			DemoBlockIndexEntry entry = { block.time, block.offset };
+			fwrite(&entry, sizeof(entry), 1, _recordFile);
+		}
+
+		header.keyframeIndexOffset = ftell(_recordFile);
+		fwrite(keyframeIndex.data(), sizeof(DemoKeyframeIndexEntry), keyframeIndex.size(), _recordFile);
+
+		fseek(_recordFile, 0, SEEK_SET);
+		fwrite(&header, sizeof(header), 1, _recordFile);
+
 		fclose(_recordFile);
 		_recordFile = nullptr;
 
@@ -158,6 +320,9 @@ void DemoPlayer::StopRecording()
 		_sampleTime = 0.0f;
 		_samplePeriod = 0.0f;
 		_lastRecordedDataMap.clear();
+		_lastRecordedOffsetMap.clear();
+		_recordedBlocks.clear();
+		_recordedKeyframes.clear();
 		_state = State::Ready;
 	}
 }
@@ -175,39 +340,47 @@ bool DemoPlayer::LoadDemo(const char* demoName)
 	if (ec)
 		return false;
 
-	FILE* file = fopen(demoPath.string().c_str(), "rb");
-	if (file == nullptr)
+	UnloadDemo();
+
+	if (!_file.Open(demoPath.string().c_str()))
 		return false;
 
-	fseek(file, 0, SEEK_END);
-	long size = ftell(file);
-	_data.resize(size);
-	fseek(file, 0, SEEK_SET);
-	fread(_data.data(), 1, size, file);
-	fclose(file);
+	uint32_t magic = 0;
+	const char* ptr = _file.GetData();
+	ReadValue(ptr, _file.GetData() + _file.GetSize(), magic);
 
-	_currentDataPtr = _data.data();
+	bool valid = (magic == DemoFileMagic) ? ReadIndexV2() : BuildIndexV1();
+	if (!valid)
+	{
+		UnloadDemo();
+		return false;
+	}
 
 	return true;
 }
 
 void DemoPlayer::UnloadDemo()
 {
-	_data.clear();
-	_currentDataPtr = nullptr;
+	_file.Close();
+	_blocks.clear();
+	_keyframes.clear();
+	_nextBlock = 0;
+	_duration = 0.0f;
+	ClearLoopRange();
 }
 
 bool DemoPlayer::StartPlaying()
 {
 	if (_state != State::Ready ||
-		_data.empty() ||
+		!_file.IsOpen() ||
 		_sampleUpdaterFunc == nullptr)
 	{
 		return false;
 	}
 
 	_currentTime = 0.0f;
-	_currentDataPtr = _data.data();
+	_nextBlock = 0;
+	ResetInterpolatedSamples();
 	_state = State::Playing;
 
 	return true;
@@ -221,6 +394,52 @@ void DemoPlayer::StopPlaying()
 	}
 }
 
+bool DemoPlayer::Seek(float time)
+{
+	if (!_file.IsOpen() || _sampleUpdaterFunc == nullptr)
+		return false;
+
+	time = std::clamp(time, 0.0f, _duration);
+
+	// Restore the state from the last keyframe before the target time and replay only the blocks after it.
+	// Without keyframes (version 1 files) playback is replayed from the first block.
+	_nextBlock = 0;
+	ResetInterpolatedSamples();
+	auto keyframe = std::upper_bound(_keyframes.begin(), _keyframes.end(), time,
+		[](float t, const KeyframeInfo& kf) { return t < kf.time; });
+	if (keyframe != _keyframes.begin())
+	{
+		--keyframe;
+		_nextBlock = keyframe->blockIndex + 1;
+		if (!ApplySamples(keyframe->offset, keyframe->time, _nextBlock))
+			return false;
+	}
+
+	while (_nextBlock < _blocks.size() && _blocks[_nextBlock].time <= time)
+	{
+		if (!ApplySamples(_blocks[_nextBlock].offset, _blocks[_nextBlock].time, _nextBlock + 1))
+			return false;
+		_nextBlock++;
+	}
+
+	_currentTime = time;
+	UpdateInterpolatedSamples();
+
+	return true;
+}
+
+void DemoPlayer::SetLoopRange(float startTime, float endTime)
+{
+	_loopStartTime = startTime;
+	_loopEndTime = endTime;
+}
+
+void DemoPlayer::ClearLoopRange()
+{
+	_loopStartTime = 0.0f;
+	_loopEndTime = -1.0f;
+}
+
 void DemoPlayer::TakeSamplesSnapshot()
 {
 	if (_state == State::Ready)
@@ -250,59 +469,265 @@ void DemoPlayer::RestoreSamplesSnapshot()
 void DemoPlayer::PlayUpdate(float dt)
 {
 	_currentTime += dt;
-	if (_currentDataPtr == nullptr)
-		_currentDataPtr = _data.data();
+
+	if (_loopEndTime > _loopStartTime && _currentTime >= _loopEndTime)
+	{
+		if (!Seek(_loopStartTime))
+			StopPlaying();
+		return;
+	}
+
+	while (_nextBlock < _blocks.size() && _blocks[_nextBlock].time <= _currentTime)
+	{
+		if (!ApplySamples(_blocks[_nextBlock].offset, _blocks[_nextBlock].time, _nextBlock + 1))
+		{
+			// Malformed sample block.
+			StopPlaying();
+			return;
+		}
+
+		_nextBlock++;
+	}
+
+	UpdateInterpolatedSamples();
+
+	// End of demo.
+	if (_nextBlock == _blocks.size() && _currentTime >= _duration)
+		StopPlaying();
+}
+
+void DemoPlayer::RecordUpdate(float dt)
+{
+	_currentTime += dt;
+	_sampleTime += dt;
+	if (_sampleTime >= _samplePeriod)
+	{
+		_sampleTime -= _samplePeriod;
+
+		_numSamplesWritten = 0;
+		_samplingFunc();
+		EndRecordedBlock();
+	}
+}
+
+void DemoPlayer::EndRecordedBlock()
+{
+	if (_numSamplesWritten == 0)
+		return;
+
+	// Write id -1 to mark the end of the sample block.
+	int32_t endId = -1;
+	fwrite(&endId, 4, 1, _recordFile);
+
+	// Periodically snapshot the complete state so that playback can seek without replaying from the start.
+	if (_recordedKeyframes.empty() || _currentTime - _lastKeyframeTime >= KeyframeInterval)
+	{
+		RecordedKeyframe keyframe;
+		keyframe.time = _currentTime;
+		keyframe.blockIndex = static_cast<uint32_t>(_recordedBlocks.size() - 1);
+		for (const auto& [id, dataOffset] : _lastRecordedOffsetMap)
+		{
+			AppendValue(keyframe.samples, &id, 4);
+			AppendValue(keyframe.samples, &SampleRefSize, 4);
+			AppendValue(keyframe.samples, &dataOffset, 8);
+		}
+		AppendValue(keyframe.samples, &endId, 4);
+
+		_recordedKeyframes.push_back(std::move(keyframe));
+		_lastKeyframeTime = _currentTime;
+	}
+}
+
+bool DemoPlayer::ReadIndexV2()
+{
+	const char* data = _file.GetData();
+	const char* end = data + _file.GetSize();
+	const char* ptr = data;
+	size_t fileSize = _file.GetSize();
+
+	DemoFileHeader header;
+	// Version 2 files differ only in storing keyframe data inline, which is still read.
+	if (!ReadValue(ptr, end, header) || header.version < 2 || header.version > DemoFileVersion)
+		return false;
+
+	// Every offset is validated here; sample records are bounds-checked when they are applied.
+	if (header.blockIndexOffset > fileSize ||
+		(fileSize - header.blockIndexOffset) / sizeof(DemoBlockIndexEntry) < header.blockCount ||
+		header.keyframeIndexOffset > fileSize ||
+		(fileSize - header.keyframeIndexOffset) / sizeof(DemoKeyframeIndexEntry) < header.keyframeCount)
+	{
+		return false;
+	}
+
+	_blocks.reserve(header.blockCount);
+	ptr = data + header.blockIndexOffset;
+	for (uint32_t i = 0; i < header.blockCount; ++i)
+	{
+		DemoBlockIndexEntry entry;
+		if (!ReadValue(ptr, end, entry) || entry.offset >= fileSize)
+			return false;
+		_blocks.push_back({ entry.time, static_cast<size_t>(entry.offset) });
+	}
+
+	_keyframes.reserve(header.keyframeCount);
+	ptr = data + header.keyframeIndexOffset;
+	for (uint32_t i = 0; i < header.keyframeCount; ++i)
+	{
+		DemoKeyframeIndexEntry entry;
+		if (!ReadValue(ptr, end, entry) || entry.offset >= fileSize || entry.blockIndex >= header.blockCount)
+			return false;
+		_keyframes.push_back({ entry.time, entry.blockIndex, static_cast<size_t>(entry.offset) });
+	}
+
+	_duration = header.duration;
+
+	return !_blocks.empty();
+}
+
+bool DemoPlayer::BuildIndexV1()
+{
+	// Version 1 files have no index, so find the blocks by walking through them once.
+	// A truncated file is played up to its last complete block.
+	const char* data = _file.GetData();
+	const char* end = data + _file.GetSize();
+	const char* ptr = data;
 
 	while (true)
 	{
-		float time = *reinterpret_cast<float*>(_currentDataPtr);
-		if (time > _currentTime)
+		float time;
+		if (!ReadValue(ptr, end, time))
 			break;
 
-		_currentDataPtr += sizeof(float);
+		size_t offset = ptr - data;
+		bool complete = false;
+		bool endOfDemo = false;
 
 		while (true)
 		{
-			int32_t id = *reinterpret_cast<int32_t*>(_currentDataPtr);
-			_currentDataPtr += sizeof(int32_t);
-			if (id == -1)
+			int32_t id;
+			if (!ReadValue(ptr, end, id))
+				break;
+
+			if (id == -1 || id == -2)
 			{
-				// End of sample block.
+				complete = true;
+				endOfDemo = (id == -2);
 				break;
 			}
-			else if (id == -2)
+
+			int32_t size;
+			if (!ReadValue(ptr, end, size) || size < 0 || end - ptr < size)
+				break;
+			ptr += size;
+		}
+
+		if (!complete)
+			break;
+
+		_duration = time;
+
+		if (endOfDemo)
+			break;
+
+		_blocks.push_back({ time, offset });
+	}
+
+	return !_blocks.empty();
+}
+
+bool DemoPlayer::ApplySamples(size_t offset, float time, size_t nextBlock)
+{
+	return ForEachSample(_file.GetData(), _file.GetSize(), offset,
+		[this, time, nextBlock](int32_t id, size_t size, const char* data)
+		{
+			auto it = _interpolatedSamples.find(id);
+			if (it != _interpolatedSamples.end())
 			{
-				// End of demo.
-				StopPlaying();
-				return;
+				// Start a new interpolation segment from this sample and find where it ends.
+				InterpolatedSample& sample = it->second;
+				sample.startTime = time;
+				sample.startValue.assign(data, data + size);
+				sample.searchBlock = nextBlock;
+				sample.endValid = false;
+				FindNextSample(id, sample);
 			}
 
-			int32_t size = *reinterpret_cast<int32_t*>(_currentDataPtr);
-			_currentDataPtr += sizeof(int32_t);
+			_sampleUpdaterFunc(id, size, data);
+			return true;
+		});
+}
 
-			_sampleUpdaterFunc(id, size, _currentDataPtr);
+void DemoPlayer::ResetInterpolatedSamples()
+{
+	for (auto& [id, sample] : _interpolatedSamples)
+	{
+		sample.startValue.clear();
+		sample.endValid = false;
+	}
+}
 
-			_currentDataPtr += size;
+void DemoPlayer::FindNextSample(int32_t id, InterpolatedSample& sample)
+{
+	for (size_t blockInd = sample.searchBlock; blockInd < _blocks.size(); ++blockInd)
+	{
+		bool found = false;
+		ForEachSample(_file.GetData(), _file.GetSize(), _blocks[blockInd].offset,
+			[&](int32_t sampleId, size_t size, const char* data)
+			{
+				if (sampleId != id)
+					return true;
+
+				sample.endValue.assign(data, data + size);
+				found = true;
+				return false;
+			});
+
+		if (found)
+		{
+			// Samples recorded with RecCond::IfChanged are missing while the value doesn't change, so the
+			// value is held until the block just before the next sample and interpolated from there.
+			if (blockInd > 0)
+				sample.startTime = std::max(sample.startTime, _blocks[blockInd - 1].time);
+			sample.endTime = _blocks[blockInd].time;
+			sample.endValid = (sample.endValue.size() == sample.startValue.size() && sample.endTime > sample.startTime);
+			return;
 		}
 	}
 }
 
-void DemoPlayer::RecordUpdate(float dt)
+void DemoPlayer::UpdateInterpolatedSamples()
 {
-	_currentTime += dt;
-	_sampleTime += dt;
-	if (_sampleTime >= _samplePeriod)
+	for (auto& [id, sample] : _interpolatedSamples)
 	{
-		_sampleTime -= _samplePeriod;
+		if (!sample.endValid || _currentTime <= sample.startTime)
+			continue;
 
-		_numSamplesWritten = 0;
-		_samplingFunc();
+		float t = std::min((_currentTime - sample.startTime) / (sample.endTime - sample.startTime), 1.0f);
+		sample.value = sample.startValue;
 
-		if (_numSamplesWritten > 0)
+		if (sample.interpolation == Interpolation::Spherical && sample.value.size() == sizeof(math3d::vec3f))
 		{
-			// Write id -1 to mark the end of the sample block.
-			int32_t endId = -1;
-			fwrite(&endId, 4, 1, _recordFile);
+			math3d::vec3f start, end;
+			memcpy(&start, sample.startValue.data(), sizeof(start));
+			memcpy(&end, sample.endValue.data(), sizeof(end));
+
+			math3d::quatf rotation = math3d::nlerp(math3d::quat_identity_f, math3d::rotation_arc(start, end), t);
+			math3d::vec3f result = math3d::rotate(start, rotation);
+			memcpy(sample.value.data(), &result, sizeof(result));
 		}
+		else
+		{
+			size_t count = sample.value.size() / sizeof(float);
+			for (size_t i = 0; i < count; ++i)
+			{
+				float start, end;
+				memcpy(&start, sample.startValue.data() + i * sizeof(float), sizeof(float));
+				memcpy(&end, sample.endValue.data() + i * sizeof(float), sizeof(float));
+				float result = math3d::lerp(start, end, t);
+				memcpy(sample.value.data() + i * sizeof(float), &result, sizeof(float));
+			}
+		}
+
+		_sampleUpdaterFunc(id, sample.value.size(), sample.value.data());
 	}
 }
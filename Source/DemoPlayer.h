@@ -8,6 +8,7 @@
 #include <string>
 #include <map>
 #include <cstdio>
+#include "MappedFile.h"
 
 class DemoPlayer
 {
@@ -28,9 +29,23 @@ public:
 		IfChanged,
 	};
 
+	// How samples of one id are applied between their recorded time stamps during playback.
+	enum class Interpolation
+	{
+		Step,		// Applied as recorded.
+		Linear,		// Component-wise lerp of a float array.
+		Spherical,	// Rotation between unit vec3 directions (quaternion nlerp).
+	};
+
+	using InterpolationMap = std::map<int32_t, Interpolation>;
+
+	DemoPlayer() = default;
 	~DemoPlayer();
 
-	void SetCallbacks(RecorderSamplingFunc samplingFunc, PlayerSampleUpdaterFunc sampleUpdaterFunc);
+	DemoPlayer(DemoPlayer&&) = default;
+	DemoPlayer& operator = (DemoPlayer&&) = default;
+
+	void SetCallbacks(RecorderSamplingFunc samplingFunc, PlayerSampleUpdaterFunc sampleUpdaterFunc, InterpolationMap interpolation = {});
 	State GetState() const { return _state; }
 	const std::vector<std::string>& GetDemoList() const;
 
@@ -48,27 +63,83 @@ public:
 	void UnloadDemo();
 	bool StartPlaying();
 	void StopPlaying();
+	bool Seek(float time);
+	void SetLoopRange(float startTime, float endTime);
+	void ClearLoopRange();
+	float GetDuration() const { return _duration; }
+	float GetCurrentTime() const { return _currentTime; }
 
 	void TakeSamplesSnapshot();
 	void RestoreSamplesSnapshot();
 
 private:
+	static constexpr float KeyframeInterval = 2.0f;	// Seconds between full state snapshots in recorded demos.
+
+	struct BlockInfo
+	{
+		float time;
+		size_t offset;		// Offset of the block's sample records in the demo file.
+	};
+
+	struct KeyframeInfo
+	{
+		float time;
+		uint32_t blockIndex;	// The snapshot holds the state after this block is applied.
+		size_t offset;			// Offset of the snapshot's sample records in the demo file.
+	};
+
+	struct RecordedKeyframe
+	{
+		float time;
+		uint32_t blockIndex;
+		std::vector<char> samples;
+	};
+
+	struct InterpolatedSample
+	{
+		Interpolation interpolation;
+		float startTime;
+		float endTime;
+		std::vector<char> startValue;
+		std::vector<char> endValue;
+		std::vector<char> value;
+		size_t searchBlock;		// First block to search for the next sample of this id.
+		bool endValid;
+	};
+
 	void PlayUpdate(float dt);
 	void RecordUpdate(float dt);
+	void EndRecordedBlock();
+	bool ReadIndexV2();
+	bool BuildIndexV1();
+	bool ApplySamples(size_t offset, float time, size_t nextBlock);
+	void ResetInterpolatedSamples();
+	void FindNextSample(int32_t id, InterpolatedSample& sample);
+	void UpdateInterpolatedSamples();
 
 	State _state = State::Ready;
 	std::vector<std::string> _demoList;
 	float _currentTime = 0.0f;
 	float _sampleTime = 0.0f;
 	float _samplePeriod = 0.0f;
-	char* _currentDataPtr = nullptr;
-	std::vector<char> _data;
+	float _duration = 0.0f;
+	float _loopStartTime = 0.0f;
+	float _loopEndTime = -1.0f;
+	MappedFile _file;
+	std::vector<BlockInfo> _blocks;
+	std::vector<KeyframeInfo> _keyframes;
+	size_t _nextBlock = 0;
 	FILE* _recordFile = nullptr;
+	std::vector<BlockInfo> _recordedBlocks;
+	std::vector<RecordedKeyframe> _recordedKeyframes;
+	float _lastKeyframeTime = 0.0f;
 	std::map<int32_t, std::vector<char>> _lastRecordedDataMap;
+	std::map<int32_t, uint64_t> _lastRecordedOffsetMap;	// File offsets of the last recorded data of each sample.
 	std::map<int32_t, std::vector<char>> _initialDataMap;
 	int _numSamplesWritten = 0;
 	RecorderSamplingFunc _samplingFunc;
 	PlayerSampleUpdaterFunc _sampleUpdaterFunc;
+	std::map<int32_t, InterpolatedSample> _interpolatedSamples;
 };
 
 #endif // _DEMO_PLAYER_H_
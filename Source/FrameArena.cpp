@@ -0,0 +1,91 @@
+#include "FrameArena.h"
+#include <new>
+#include <utility>
+#include <algorithm>
+
+
+FrameArena::FrameArena(size_t blockSize)
+{
+	_blocks = AllocateBlock(blockSize);
+}
+
+FrameArena::~FrameArena()
+{
+	FreeBlocks();
+}
+
+FrameArena& FrameArena::operator = (FrameArena&& other)
+{
+	std::swap(_blocks, other._blocks);
+	std::swap(_offset, other._offset);
+	std::swap(_usedSize, other._usedSize);
+	std::swap(_peakSize, other._peakSize);
+	return *this;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	uintptr_t start = reinterpret_cast<uintptr_t>(GetBlockData(_blocks)) + _offset;
+	size_t padding = (alignment - start % alignment) % alignment;
+
+	if (_offset + padding + size > _blocks->size)
+	{
+		// The rest of the block is left unused; the new block is at least as large as the last one, so that a frame
+		// much larger than the first block doesn't need a long chain of them.
+		_usedSize += _blocks->size;
+		Block* block = AllocateBlock(std::max(size + alignment, _blocks->size));
+		block->next = _blocks;
+		_blocks = block;
+		_offset = 0;
+
+		start = reinterpret_cast<uintptr_t>(GetBlockData(_blocks));
+		padding = (alignment - start % alignment) % alignment;
+	}
+
+	_offset += padding;
+	void* ptr = GetBlockData(_blocks) + _offset;
+	_offset += size;
+	return ptr;
+}
+
+void FrameArena::Reset()
+{
+	size_t usedSize = GetUsedSize();
+	_peakSize = std::max(_peakSize, usedSize);
+
+	if (_blocks->next != nullptr)
+	{
+		// The frame didn't fit into one block. Room for twice as much covers frames which are a bit larger.
+		FreeBlocks();
+		_blocks = AllocateBlock(usedSize * 2);
+	}
+
+	_offset = 0;
+	_usedSize = 0;
+}
+
+size_t FrameArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for (Block* block = _blocks; block != nullptr; block = block->next)
+		capacity += block->size;
+	return capacity;
+}
+
+FrameArena::Block* FrameArena::AllocateBlock(size_t size)
+{
+	Block* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+	block->next = nullptr;
+	block->size = size;
+	return block;
+}
+
+void FrameArena::FreeBlocks()
+{
+	while (_blocks != nullptr)
+	{
+		Block* next = _blocks->next;
+		::operator delete(_blocks);
+		_blocks = next;
+	}
+}
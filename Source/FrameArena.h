@@ -0,0 +1,91 @@
+#ifndef _FRAME_ARENA_H_
+#define _FRAME_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Linear allocator for data which lives until the end of a frame. Allocations take the next bytes of a block and
+// are only freed together, by Reset at the start of the next frame. A frame which doesn't fit into the block gets
+// more blocks, and the following Reset replaces all of them with one block large enough for that frame, so after
+// the largest frames have been seen the arena doesn't touch the heap any more.
+class FrameArena
+{
+public:
+	static constexpr size_t DefaultBlockSize = 256 * 1024;
+
+	explicit FrameArena(size_t blockSize = DefaultBlockSize);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator = (const FrameArena&) = delete;
+	// Exchanges the memory of the arenas. Allocators keep referring to the arena they were created with.
+	FrameArena& operator = (FrameArena&& other);
+
+	void* Allocate(size_t size, size_t alignment);
+	// Frees everything allocated since the last reset. Memory from the arena must not be used after this.
+	void Reset();
+
+	size_t GetUsedSize() const { return _usedSize + _offset; }	// Bytes taken since the last reset, with padding.
+	size_t GetPeakSize() const { return _peakSize; }
+	size_t GetCapacity() const;
+
+private:
+	// Blocks are linked through a header at their start.
+	struct Block
+	{
+		Block* next;
+		size_t size;	// Usable bytes after the header.
+	};
+
+	Block* AllocateBlock(size_t size);
+	void FreeBlocks();
+	char* GetBlockData(Block* block) const { return reinterpret_cast<char*>(block + 1); }
+
+	Block* _blocks = nullptr;	// Most recently allocated block first; allocations are made from it.
+	size_t _offset = 0;			// Bytes taken from the first block.
+	size_t _usedSize = 0;		// Bytes taken from the other blocks, including their unused ends.
+	size_t _peakSize = 0;
+};
+
+
+// Standard library allocator which takes memory from a frame arena. Deallocation does nothing, so containers
+// using it must be emptied with ResetFrameVector before the arena is reset. Containers keep their arena when
+// they're assigned to.
+template <typename T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	explicit FrameAllocator(FrameArena& arena) : _arena(&arena) { }
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) : _arena(other._arena) { }
+
+	T* allocate(size_t count) { return static_cast<T*>(_arena->Allocate(count * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) { }
+
+	template <typename U>
+	bool operator == (const FrameAllocator<U>& other) const { return _arena == other._arena; }
+	template <typename U>
+	bool operator != (const FrameAllocator<U>& other) const { return _arena != other._arena; }
+
+private:
+	template <typename U>
+	friend class FrameAllocator;
+
+	FrameArena* _arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+// Empties the vector and lets go of its memory, so it can be filled again after the arena is reset.
+template <typename T>
+void ResetFrameVector(FrameVector<T>& vec)
+{
+	vec = FrameVector<T>(vec.get_allocator());
+}
+
+#endif // _FRAME_ARENA_H_
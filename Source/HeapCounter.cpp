@@ -0,0 +1,35 @@
+#include "HeapCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+static std::atomic<uint64_t> s_allocationCount { 0 };
+
+
+uint64_t GetHeapAllocationCount()
+{
+	return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+// The other forms of new and delete which aren't aligned are implemented by the standard library with these.
+
+void* operator new(std::size_t size)
+{
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* ptr = std::malloc(size > 0 ? size : 1);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
@@ -0,0 +1,10 @@
+#ifndef _HEAP_COUNTER_H_
+#define _HEAP_COUNTER_H_
+
+#include <cstdint>
+
+// Number of heap allocations made through operator new since the program started, on all threads. The global
+// operator new is replaced to count them, so that frames which are expected not to allocate can be checked.
+uint64_t GetHeapAllocationCount();
+
+#endif // _HEAP_COUNTER_H_
@@ -0,0 +1,95 @@
+#include "LightGrid.h"
+#include <cmath>
+
+
+void LightGrid::Clear()
+{
+	_lights.clear();
+	_cells.clear();
+	_maxRadius = 0.0f;
+	_reinsertCount = 0;
+}
+
+void LightGrid::CollectSpheres()
+{
+	_rebuildSpheres.resize(_lights.size());
+	for (const auto& [key, cell] : _cells)
+	{
+		for (const CellLight& light : cell.lights)
+			_rebuildSpheres[light.index] = light.sphere;
+	}
+}
+
+void LightGrid::Rebuild()
+{
+	// Cells about the size of a light keep both the number of cells a query visits and the number of
+	// lights tested in each of them low.
+	float radiusSum = 0.0f;
+	_maxRadius = 0.0f;
+	for (const math3d::vec4f& sphere : _rebuildSpheres)
+	{
+		radiusSum += sphere.w;
+		_maxRadius = std::max(_maxRadius, sphere.w);
+	}
+
+	float meanRadius = _rebuildSpheres.empty() ? 0.0f : radiusSum / _rebuildSpheres.size();
+	_cellSize = std::max(meanRadius, 1.0f);
+	_invCellSize = 1.0f / _cellSize;
+	_cells.clear();
+
+	for (size_t i = 0; i < _rebuildSpheres.size(); ++i)
+		Insert(static_cast<uint32_t>(i), _rebuildSpheres[i]);
+
+	_reinsertCount = _rebuildSpheres.size();
+	_rebuildSpheres.clear();
+}
+
+void LightGrid::Insert(uint32_t lightIndex, const math3d::vec4f& sphere)
+{
+	uint64_t cellKey = GetCellKey(sphere);
+	auto [it, inserted] = _cells.try_emplace(cellKey);
+	Cell& cell = it->second;
+	if (inserted)
+	{
+		cell.key = cellKey;
+		cell.x = GetCellCoord(sphere.x);
+		cell.y = GetCellCoord(sphere.y);
+		cell.z = GetCellCoord(sphere.z);
+		cell.lights.reserve(ReservedCellLights);
+	}
+
+	LightEntry& light = _lights[lightIndex];
+	light.cell = &cell;
+	light.slot = static_cast<uint32_t>(cell.lights.size());
+	cell.lights.push_back({ sphere, lightIndex });
+}
+
+void LightGrid::Remove(uint32_t lightIndex)
+{
+	// Empty cells are kept, lights tend to come back to them.
+	LightEntry& light = _lights[lightIndex];
+	std::vector<CellLight>& cellLights = light.cell->lights;
+	cellLights[light.slot] = cellLights.back();
+	_lights[cellLights[light.slot].index].slot = light.slot;
+	cellLights.pop_back();
+}
+
+int LightGrid::GetCellCoord(float value) const
+{
+	float coord = std::floor(value * _invCellSize);
+	return static_cast<int>(std::clamp(coord, float(-CellCoordBias), float(CellCoordBias - 1)));
+}
+
+uint64_t LightGrid::GetCellKey(const math3d::vec4f& sphere) const
+{
+	return GetCellKey(GetCellCoord(sphere.x), GetCellCoord(sphere.y), GetCellCoord(sphere.z));
+}
+
+uint64_t LightGrid::GetCellKey(int x, int y, int z)
+{
+	constexpr uint64_t mask = (uint64_t(1) << CellCoordBits) - 1;
+	return
+		(uint64_t(x + CellCoordBias) & mask) |
+		((uint64_t(y + CellCoordBias) & mask) << CellCoordBits) |
+		((uint64_t(z + CellCoordBias) & mask) << (CellCoordBits * 2));
+}
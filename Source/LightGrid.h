@@ -0,0 +1,214 @@
+#ifndef _LIGHT_GRID_H_
+#define _LIGHT_GRID_H_
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <Math/math3d.h>
+#include <Math/transform.h>
+#include "Utils.h"
+
+
+// Spatial hash over light spheres. Every light is kept in the uniform grid cell which contains its center;
+// queries look into the cells within the largest light radius of the query volume. Only lights that move
+// to another cell are reinserted when the grid is updated.
+class LightGrid
+{
+public:
+	// Synchronizes the grid with numLights spheres; getSphere(i) returns vec4f(center, radius) of light i.
+	// The grid is rebuilt when the number of lights changes or the mean radius moves away from the cell size.
+	template <typename GetSphere>
+	void Update(size_t numLights, GetSphere getSphere);
+
+	// Calls func(lightIndex) for every light whose sphere overlaps the box.
+	template <typename Func>
+	void QueryAABB(const math3d::vec3f& minPt, const math3d::vec3f& maxPt, Func func) const;
+
+	// Calls func(lightIndex) for every light whose sphere is inside the view frustum. Planes are in view space.
+	template <typename Func>
+	void QueryFrustum(const math3d::mat4f& viewMat, const std::vector<math3d::vec4f>& planes, Func func) const;
+
+	void Clear();
+	size_t GetLightCount() const { return _lights.size(); }
+	size_t GetCellCount() const { return _cells.size(); }
+	float GetCellSize() const { return _cellSize; }
+	size_t GetReinsertCount() const { return _reinsertCount; }	// Lights moved to another cell by the last update.
+
+private:
+	// Spheres are stored in the cells, so that queries read each cell's lights from contiguous memory.
+	struct CellLight
+	{
+		math3d::vec4f sphere;
+		uint32_t index;
+	};
+
+	struct Cell
+	{
+		uint64_t key;
+		int x, y, z;
+		std::vector<CellLight> lights;
+	};
+
+	// Cells are never removed from the map between rebuilds, so pointers to them stay valid.
+	struct LightEntry
+	{
+		Cell* cell;
+		uint32_t slot;		// Position in the cell's light list.
+	};
+
+	static constexpr int CellCoordBits = 21;
+	static constexpr int CellCoordBias = 1 << (CellCoordBits - 1);
+	static constexpr size_t ReservedCellLights = 8;	// Room made in new cells, so lights moving between cells rarely allocate.
+
+	void CollectSpheres();
+	void Rebuild();
+	void Insert(uint32_t lightIndex, const math3d::vec4f& sphere);
+	void Remove(uint32_t lightIndex);
+	int GetCellCoord(float value) const;
+	uint64_t GetCellKey(const math3d::vec4f& sphere) const;
+	static uint64_t GetCellKey(int x, int y, int z);
+
+	template <typename CellFunc>
+	void ForEachCellInRange(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, CellFunc func) const;
+
+	float _cellSize = 0.0f;
+	float _invCellSize = 0.0f;
+	float _maxRadius = 0.0f;
+	size_t _reinsertCount = 0;
+	std::vector<LightEntry> _lights;
+	std::vector<math3d::vec4f> _rebuildSpheres;	// Light spheres by light index, used only while rebuilding.
+	std::unordered_map<uint64_t, Cell> _cells;
+};
+
+
+template <typename GetSphere>
+void LightGrid::Update(size_t numLights, GetSphere getSphere)
+{
+	if (numLights != _lights.size())
+	{
+		// Collect the spheres first, the cell size depends on them.
+		_lights.assign(numLights, {});
+		_rebuildSpheres.resize(numLights);
+		for (size_t i = 0; i < numLights; ++i)
+			_rebuildSpheres[i] = getSphere(i);
+		Rebuild();
+		return;
+	}
+
+	_reinsertCount = 0;
+	float radiusSum = 0.0f;
+	float maxRadius = 0.0f;
+
+	for (size_t i = 0; i < numLights; ++i)
+	{
+		math3d::vec4f sphere = getSphere(i);
+		radiusSum += sphere.w;
+		maxRadius = std::max(maxRadius, sphere.w);
+
+		LightEntry& light = _lights[i];
+		if (GetCellKey(sphere) == light.cell->key)
+		{
+			light.cell->lights[light.slot].sphere = sphere;
+		}
+		else
+		{
+			Remove(static_cast<uint32_t>(i));
+			Insert(static_cast<uint32_t>(i), sphere);
+			++_reinsertCount;
+		}
+	}
+
+	_maxRadius = maxRadius;
+
+	// Keep the cells about the size of a light, see Rebuild.
+	float meanRadius = numLights > 0 ? radiusSum / numLights : 0.0f;
+	if (numLights > 0 && (meanRadius > _cellSize * 2.0f || meanRadius < _cellSize * 0.5f))
+	{
+		CollectSpheres();
+		Rebuild();
+	}
+}
+
+template <typename CellFunc>
+void LightGrid::ForEachCellInRange(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, CellFunc func) const
+{
+	// Look up the cells in the range one by one, unless there are fewer occupied cells than that.
+	uint64_t rangeCells = uint64_t(maxX - minX + 1) * uint64_t(maxY - minY + 1) * uint64_t(maxZ - minZ + 1);
+
+	if (rangeCells <= _cells.size())
+	{
+		for (int z = minZ; z <= maxZ; ++z)
+		{
+			for (int y = minY; y <= maxY; ++y)
+			{
+				for (int x = minX; x <= maxX; ++x)
+				{
+					auto it = _cells.find(GetCellKey(x, y, z));
+					if (it != _cells.end())
+						func(it->second);
+				}
+			}
+		}
+	}
+	else
+	{
+		for (const auto& [key, cell] : _cells)
+		{
+			if (cell.x >= minX && cell.x <= maxX && cell.y >= minY && cell.y <= maxY && cell.z >= minZ && cell.z <= maxZ)
+				func(cell);
+		}
+	}
+}
+
+template <typename Func>
+void LightGrid::QueryAABB(const math3d::vec3f& minPt, const math3d::vec3f& maxPt, Func func) const
+{
+	if (_lights.empty())
+		return;
+
+	// A light can overlap the box only if its center is within the largest radius of it.
+	ForEachCellInRange(
+		GetCellCoord(minPt.x - _maxRadius), GetCellCoord(minPt.y - _maxRadius), GetCellCoord(minPt.z - _maxRadius),
+		GetCellCoord(maxPt.x + _maxRadius), GetCellCoord(maxPt.y + _maxRadius), GetCellCoord(maxPt.z + _maxRadius),
+		[&](const Cell& cell)
+		{
+			for (const CellLight& light : cell.lights)
+			{
+				if (AABBOverlapsSphere(minPt, maxPt, light.sphere.rvec3(), light.sphere.w))
+					func(light.index);
+			}
+		});
+}
+
+template <typename Func>
+void LightGrid::QueryFrustum(const math3d::mat4f& viewMat, const std::vector<math3d::vec4f>& planes, Func func) const
+{
+	// Cells are culled as boxes grown by the largest light radius, then the lights of visible cells one by one.
+	float halfSize = _cellSize * 0.5f + _maxRadius;
+	math3d::vec3f halfVecR = math3d::transform_dir(math3d::vec3f(halfSize, 0.0f, 0.0f), viewMat);
+	math3d::vec3f halfVecS = math3d::transform_dir(math3d::vec3f(0.0f, halfSize, 0.0f), viewMat);
+	math3d::vec3f halfVecT = math3d::transform_dir(math3d::vec3f(0.0f, 0.0f, halfSize), viewMat);
+
+	for (const auto& [key, cell] : _cells)
+	{
+		if (cell.lights.empty())
+			continue;
+
+		math3d::vec3f cellCenter(
+			(cell.x + 0.5f) * _cellSize,
+			(cell.y + 0.5f) * _cellSize,
+			(cell.z + 0.5f) * _cellSize);
+
+		if (!ViewSpaceBBoxInsideFrustum(cellCenter * viewMat, halfVecR, halfVecS, halfVecT, planes))
+			continue;
+
+		for (const CellLight& light : cell.lights)
+		{
+			if (ViewSpaceSphereInsideFrustum(light.sphere.rvec3() * viewMat, light.sphere.w, planes))
+				func(light.index);
+		}
+	}
+}
+
+#endif // _LIGHT_GRID_H_
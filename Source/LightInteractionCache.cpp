@@ -0,0 +1,123 @@
+#include "LightInteractionCache.h"
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+
+// Candidate spheres are larger than the light's by this fraction of its radius, plus the candidate margin.
+static constexpr float CandidateRadiusScale = 0.5f;
+// Covers rounding differences between the distance used for the slack and the exact overlap test.
+static constexpr float SlackEpsilon = 0.01f;
+// Boxes reserved for each new light's set and candidates.
+static constexpr size_t ReservedBoxes = 32;
+static constexpr size_t ReservedCandidateBoxes = 64;
+
+
+// Squared distance from the point to the box. Gives exactly the same result as the sum in AABBOverlapsSphere,
+// since adding the zero terms of axes inside the box doesn't change it, but without branches.
+static float BoxDistanceSq(const math3d::vec3f& minPt, const math3d::vec3f& maxPt, const math3d::vec4f& sphere)
+{
+	float sx = std::max(std::max(minPt.x - sphere.x, sphere.x - maxPt.x), 0.0f);
+	float sy = std::max(std::max(minPt.y - sphere.y, sphere.y - maxPt.y), 0.0f);
+	float sz = std::max(std::max(minPt.z - sphere.z, sphere.z - maxPt.z), 0.0f);
+	return sx * sx + sy * sy + sz * sz;
+}
+
+void LightInteractionCache::SetBoxes(const std::vector<math3d::vec3f>& minPts, const std::vector<math3d::vec3f>& maxPts)
+{
+	_boxMinPts = minPts;
+	_boxMaxPts = maxPts;
+	Invalidate();
+}
+
+void LightInteractionCache::Resize(size_t numLights)
+{
+	size_t oldNumLights = _boxes.size();
+
+	_spheres.resize(numLights);
+	_slacks.resize(numLights, -1.0f);
+	_boxes.resize(numLights);
+	_candidates.resize(numLights);
+
+	// Sets of moving lights keep reaching new sizes for a long time; with room for typical sets reserved up
+	// front, they don't reallocate from frame to frame.
+	for (size_t lightIndex = oldNumLights; lightIndex < numLights; ++lightIndex)
+	{
+		_boxes[lightIndex].reserve(ReservedBoxes);
+		_candidates[lightIndex].boxes.reserve(ReservedCandidateBoxes);
+	}
+}
+
+void LightInteractionCache::Invalidate()
+{
+	std::fill(_slacks.begin(), _slacks.end(), -1.0f);
+}
+
+const std::vector<int32_t>& LightInteractionCache::GetBoxes(size_t lightIndex, const math3d::vec4f& sphere)
+{
+	// The distance from a point to a box changes at most as much as the point moves.
+	const math3d::vec4f& oldSphere = _spheres[lightIndex];
+	float slack = _slacks[lightIndex];
+	math3d::vec3f move = sphere.rvec3() - oldSphere.rvec3();
+	if (slack >= 0.0f && sphere.w == oldSphere.w && math3d::dot(move, move) < slack * slack)
+		return _boxes[lightIndex];
+
+	// The candidates can be reused while they contain every box the light may overlap.
+	const math3d::vec4f& candidateSphere = _candidates[lightIndex].sphere;
+	if (slack < 0.0f || (sphere.rvec3() - candidateSphere.rvec3()).length() + sphere.w >= candidateSphere.w)
+		FindCandidates(lightIndex, sphere);
+
+	Recompute(lightIndex, sphere);
+	return _boxes[lightIndex];
+}
+
+void LightInteractionCache::FindCandidates(size_t lightIndex, const math3d::vec4f& sphere)
+{
+	Candidates& candidates = _candidates[lightIndex];
+	candidates.boxes.clear();
+
+	float candidateRadius = sphere.w * (1.0f + CandidateRadiusScale) + _candidateMargin;
+	float candidateRadiusSq = candidateRadius * candidateRadius;
+	float nearestOtherSq = FLT_MAX;
+
+	for (size_t boxInd = 0; boxInd < _boxMinPts.size(); ++boxInd)
+	{
+		float dist = BoxDistanceSq(_boxMinPts[boxInd], _boxMaxPts[boxInd], sphere);
+
+		if (dist <= candidateRadiusSq)
+			candidates.boxes.push_back(static_cast<int32_t>(boxInd));
+		else
+			nearestOtherSq = std::min(nearestOtherSq, dist);
+	}
+
+	// Grow the candidate sphere up to the nearest box which isn't a candidate; lights far from all boxes
+	// then keep their candidates much longer.
+	candidates.sphere = math3d::vec4f(sphere.rvec3(), nearestOtherSq < FLT_MAX ? std::sqrt(nearestOtherSq) : FLT_MAX);
+
+	++_fullRecomputeCount;
+}
+
+void LightInteractionCache::Recompute(size_t lightIndex, const math3d::vec4f& sphere)
+{
+	const Candidates& candidates = _candidates[lightIndex];
+	std::vector<int32_t>& boxes = _boxes[lightIndex];
+	boxes.clear();
+
+	// Boxes which aren't candidates are further from the center than the candidate sphere reaches.
+	float radius = sphere.w;
+	float slack = candidates.sphere.w - (sphere.rvec3() - candidates.sphere.rvec3()).length() - radius;
+
+	for (int32_t boxInd : candidates.boxes)
+	{
+		float dist = BoxDistanceSq(_boxMinPts[boxInd], _boxMaxPts[boxInd], sphere);
+
+		if (dist <= radius * radius)
+			boxes.push_back(boxInd);
+
+		slack = std::min(slack, std::abs(std::sqrt(dist) - radius));
+	}
+
+	_spheres[lightIndex] = sphere;
+	_slacks[lightIndex] = std::max(slack - SlackEpsilon, 0.0f);
+	++_recomputeCount;
+}
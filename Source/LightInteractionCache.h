@@ -0,0 +1,59 @@
+#ifndef _LIGHT_INTERACTION_CACHE_H_
+#define _LIGHT_INTERACTION_CACHE_H_
+
+#include <cstdint>
+#include <vector>
+#include <Math/math3d.h>
+
+
+// Caches the set of boxes each light's sphere overlaps. Together with the set, the distance from the light's
+// center to the nearest box boundary it could cross is stored; until the light moves further than that, or its
+// radius changes, no box can start or stop overlapping it and the set is reused. Otherwise only the boxes
+// overlapping a larger candidate sphere around the light are tested again, and all boxes only once the light
+// leaves the candidate sphere.
+class LightInteractionCache
+{
+public:
+	// Sets the boxes interactions are found for and invalidates all lights.
+	void SetBoxes(const std::vector<math3d::vec3f>& minPts, const std::vector<math3d::vec3f>& maxPts);
+	// New lights start invalid; cached sets stay valid for any light, since they depend only on its sphere.
+	void Resize(size_t numLights);
+	void Invalidate();
+	// Distance added to candidate sphere radii; about as far as lights move in a few dozen frames works best.
+	void SetCandidateMargin(float margin) { _candidateMargin = margin; }
+
+	// Returns indices of boxes overlapping the sphere, in increasing order. Same result as testing the sphere
+	// against every box with AABBOverlapsSphere.
+	const std::vector<int32_t>& GetBoxes(size_t lightIndex, const math3d::vec4f& sphere);
+
+	size_t GetBoxCount() const { return _boxMinPts.size(); }
+	// Lights tested against their candidates and against all boxes since the last ResetCounters.
+	size_t GetRecomputeCount() const { return _recomputeCount; }
+	size_t GetFullRecomputeCount() const { return _fullRecomputeCount; }
+	void ResetCounters() { _recomputeCount = 0; _fullRecomputeCount = 0; }
+
+private:
+	// Data needed only when a light's set is recomputed.
+	struct Candidates
+	{
+		math3d::vec4f sphere;
+		std::vector<int32_t> boxes;		// Boxes overlapping the candidate sphere.
+	};
+
+	void FindCandidates(size_t lightIndex, const math3d::vec4f& sphere);
+	void Recompute(size_t lightIndex, const math3d::vec4f& sphere);
+
+	std::vector<math3d::vec3f> _boxMinPts;
+	std::vector<math3d::vec3f> _boxMaxPts;
+
+	// Per light data, split so that lights with a valid set read only the first three arrays.
+	std::vector<math3d::vec4f> _spheres;		// Spheres the sets were found for.
+	std::vector<float> _slacks;					// Distance the center can move before the set may change, negative if invalid.
+	std::vector<std::vector<int32_t>> _boxes;
+	std::vector<Candidates> _candidates;
+	float _candidateMargin = 0.0f;
+	size_t _recomputeCount = 0;
+	size_t _fullRecomputeCount = 0;
+};
+
+#endif // _LIGHT_INTERACTION_CACHE_H_
@@ -1,9 +1,83 @@
+#include <cstdio>
+#include <cstring>
+#include <memory>
 #include "Application.h"
 #include "DeferredRenderer.h"
+#include "Profiler.h"
 
 
-int main()
+// Writes every command executed by the null render context to a text file, one per line.
+class FileCommandLogger : public gls::ICommandLogger
 {
-	Application framework("Deferred shading", 1024, 768);
-	framework.Run(new DeferredRenderer);
+public:
+	FileCommandLogger(const char* fileName) : _file(fopen(fileName, "w")) { }
+	~FileCommandLogger() { if (_file) fclose(_file); }
+
+	virtual void LogCommand(const char* command) override
+	{
+		if (_file)
+			fprintf(_file, "%s\n", command);
+	}
+
+private:
+	FILE* _file;
+};
+
+
+int main(int argc, char* argv[])
+{
+	// DeferredShading [--headless <demo> [--command-log <file>]] [--trace <file>]
+	// --headless runs the benchmark without a window or GPU, --trace captures a CPU trace of the whole run.
+	const char* headlessDemo = nullptr;
+	const char* commandLogFileName = nullptr;
+	const char* traceFileName = nullptr;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+			headlessDemo = argv[i + 1];
+		else if (strcmp(argv[i], "--command-log") == 0)
+			commandLogFileName = argv[i + 1];
+		else if (strcmp(argv[i], "--trace") == 0)
+			traceFileName = argv[i + 1];
+	}
+
+#if defined (ENABLE_PROFILER)
+	if (traceFileName)
+		BeginProfilerCapture();
+#else
+	if (traceFileName)
+		printf("The profiler is not compiled in, --trace is ignored.\n");
+#endif
+
+	int result;
+
+	if (headlessDemo)
+	{
+		std::unique_ptr<FileCommandLogger> commandLogger;
+		if (commandLogFileName)
+			commandLogger = std::make_unique<FileCommandLogger>(commandLogFileName);
+
+		auto renderer = std::make_unique<DeferredRenderer>();
+		result = renderer->RunHeadlessBenchmark(headlessDemo, 1024, 768, commandLogger.get()) ? 0 : 1;
+	}
+	else
+	{
+		Application framework("Deferred shading", 1024, 768);
+		result = framework.Run(new DeferredRenderer);
+	}
+
+#if defined (ENABLE_PROFILER)
+	if (traceFileName)
+	{
+		EndProfilerCapture();
+		uint64_t droppedZones = 0;
+		if (!WriteProfilerTrace(traceFileName, &droppedZones))
+			printf("Failed to write CPU trace to %s\n", traceFileName);
+		else if (droppedZones > 0)
+			printf("%llu profile zones didn't fit into the trace buffers.\n", static_cast<unsigned long long>(droppedZones));
+	}
+#endif
+
+	return result;
 }
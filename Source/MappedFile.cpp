@@ -0,0 +1,134 @@
+#include "MappedFile.h"
+#include <utility>
+#if defined (_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#elif defined (__linux__)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator = (MappedFile&& other)
+{
+	if (this != &other)
+	{
+		Close();
+
+#if defined (_WIN32)
+		_fileHandle = std::exchange(other._fileHandle, nullptr);
+		_mappingHandle = std::exchange(other._mappingHandle, nullptr);
+#endif
+		_data = std::exchange(other._data, nullptr);
+		_size = std::exchange(other._size, 0);
+	}
+
+	return *this;
+}
+
+#if defined (_WIN32)
+
+bool MappedFile::Open(const char* fileName)
+{
+	Close();
+
+	HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_fileHandle = file;
+	_mappingHandle = mapping;
+	_data = static_cast<const char*>(data);
+	_size = static_cast<size_t>(size.QuadPart);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mappingHandle)
+		CloseHandle(_mappingHandle);
+	if (_fileHandle)
+		CloseHandle(_fileHandle);
+
+	_fileHandle = nullptr;
+	_mappingHandle = nullptr;
+	_data = nullptr;
+	_size = 0;
+}
+
+#elif defined (__linux__)
+
+bool MappedFile::Open(const char* fileName)
+{
+	Close();
+
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	// The mapping stays valid after the descriptor is closed.
+	if (data == MAP_FAILED)
+		return false;
+
+	_data = static_cast<const char*>(data);
+	_size = static_cast<size_t>(st.st_size);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (_data)
+		munmap(const_cast<char*>(_data), _size);
+
+	_data = nullptr;
+	_size = 0;
+}
+
+#endif
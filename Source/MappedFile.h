@@ -0,0 +1,35 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+
+
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator = (const MappedFile&) = delete;
+	MappedFile(MappedFile&& other);
+	MappedFile& operator = (MappedFile&& other);
+
+	bool Open(const char* fileName);
+	void Close();
+
+	bool IsOpen() const { return _data != nullptr; }
+	const char* GetData() const { return _data; }
+	size_t GetSize() const { return _size; }
+
+private:
+#if defined (_WIN32)
+	void* _fileHandle = nullptr;
+	void* _mappingHandle = nullptr;
+#endif
+	const char* _data = nullptr;
+	size_t _size = 0;
+};
+
+#endif // _MAPPED_FILE_H_
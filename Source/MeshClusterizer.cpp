@@ -0,0 +1,210 @@
+#include "MeshClusterizer.h"
+#include <cmath>
+#include <cfloat>
+#include <numeric>
+#include <algorithm>
+#include "Utils.h"
+
+
+// Clusters with at least this many triangles are closed before taking a triangle turned further than
+// MinClusterNormalCos from the cluster's normal, so that their cones stay narrow enough to cull.
+static constexpr int MinClusterTriangles = 64;
+static constexpr float MinClusterNormalCos = 0.7f;
+
+
+void BuildClusters(
+	const std::vector<ObjScene::Vertex>& vertices,
+	std::vector<int32_t>& indices,
+	int indexOffset,
+	int numIndices,
+	std::vector<ObjScene::Cluster>& clusters)
+{
+	size_t numTris = numIndices / 3;
+	if (numTris == 0)
+		return;
+
+	const int32_t* tris = indices.data() + indexOffset;
+	auto position = [&](size_t tri, int corner) -> const math3d::vec3f& { return vertices[tris[tri * 3 + corner]].position; };
+
+	// Unit normals and centroids of triangles. Degenerate triangles get a null normal.
+
+	std::vector<math3d::vec3f> normals(numTris);
+	std::vector<math3d::vec3f> centroids(numTris);
+	float totalArea = 0.0f;
+
+	for (size_t t = 0; t < numTris; ++t)
+	{
+		const math3d::vec3f& p0 = position(t, 0);
+		const math3d::vec3f& p1 = position(t, 1);
+		const math3d::vec3f& p2 = position(t, 2);
+		math3d::vec3f n = math3d::cross(p1 - p0, p2 - p0);
+		float len = n.length();
+		normals[t] = len > 0.0f ? n / len : math3d::vec3f(0.0f, 0.0f, 0.0f);
+		centroids[t] = (p0 + p1 + p2) / 3.0f;
+		totalArea += len * 0.5f;
+	}
+
+	// Triangles are neighbours when they share a position, even across texture or normal seams. Vertices at the
+	// same position map to one point.
+
+	auto [minIt, maxIt] = std::minmax_element(tris, tris + numTris * 3);
+	int32_t baseIndex = *minIt;
+	size_t numVerts = static_cast<size_t>(*maxIt - baseIndex + 1);
+
+	std::vector<int32_t> sortedVerts(numVerts);
+	std::iota(sortedVerts.begin(), sortedVerts.end(), 0);
+	auto lessPos = [&](int32_t a, int32_t b)
+	{
+		const math3d::vec3f& pa = vertices[baseIndex + a].position;
+		const math3d::vec3f& pb = vertices[baseIndex + b].position;
+		return pa.x != pb.x ? pa.x < pb.x : pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z;
+	};
+	std::sort(sortedVerts.begin(), sortedVerts.end(), lessPos);
+
+	std::vector<int32_t> pointOf(numVerts);
+	int32_t numPoints = 0;
+	for (size_t i = 0; i < numVerts; ++i)
+	{
+		if (i > 0 && lessPos(sortedVerts[i - 1], sortedVerts[i]))
+			++numPoints;
+		pointOf[sortedVerts[i]] = numPoints;
+	}
+	++numPoints;
+
+	// Triangles around each point, packed into one array.
+
+	std::vector<int32_t> pointTriStart(numPoints + 1, 0);
+	for (size_t i = 0; i < numTris * 3; ++i)
+		++pointTriStart[pointOf[tris[i] - baseIndex] + 1];
+	std::partial_sum(pointTriStart.begin(), pointTriStart.end(), pointTriStart.begin());
+
+	std::vector<int32_t> pointTris(numTris * 3);
+	std::vector<int32_t> fillPos(pointTriStart.begin(), pointTriStart.end() - 1);
+	for (size_t i = 0; i < numTris * 3; ++i)
+		pointTris[fillPos[pointOf[tris[i] - baseIndex]]++] = static_cast<int32_t>(i / 3);
+
+	// A cluster of the largest size covers about this radius; distances from the cluster's center are scored
+	// relative to it.
+	float clusterRadius = std::sqrt(totalArea / numTris * ObjScene::MaxClusterTriangles / 3.14159265f);
+	if (clusterRadius <= 0.0f)
+		clusterRadius = 1.0f;
+
+	std::vector<bool> assigned(numTris, false);
+	std::vector<int32_t> frontierCluster(numTris, -1);	// Cluster whose frontier the triangle was last added to.
+	std::vector<int32_t> frontier;
+	std::vector<int32_t> clusterTris;
+	std::vector<int32_t> newIndices;
+	newIndices.reserve(numTris * 3);
+	size_t nextSeed = 0;
+	int32_t clusterInd = 0;
+
+	while (newIndices.size() < numTris * 3)
+	{
+		// Continue from the frontier of the previous cluster when possible; starting next to finished clusters
+		// leaves fewer small islands of triangles for the end.
+
+		int32_t seed = -1;
+		for (int32_t t : frontier)
+		{
+			if (!assigned[t])
+			{
+				seed = t;
+				break;
+			}
+		}
+
+		if (seed < 0)
+		{
+			while (assigned[nextSeed])
+				++nextSeed;
+			seed = static_cast<int32_t>(nextSeed);
+		}
+
+		frontier.clear();
+		clusterTris.clear();
+		math3d::vec3f normalSum(0.0f, 0.0f, 0.0f);
+		math3d::vec3f centroidSum(0.0f, 0.0f, 0.0f);
+
+		auto addTriangle = [&](int32_t t)
+		{
+			assigned[t] = true;
+			clusterTris.push_back(t);
+			normalSum += normals[t];
+			centroidSum += centroids[t];
+
+			for (int corner = 0; corner < 3; ++corner)
+			{
+				int32_t point = pointOf[tris[t * 3 + corner] - baseIndex];
+				for (int32_t i = pointTriStart[point]; i < pointTriStart[point + 1]; ++i)
+				{
+					int32_t n = pointTris[i];
+					if (!assigned[n] && frontierCluster[n] != clusterInd)
+					{
+						frontierCluster[n] = clusterInd;
+						frontier.push_back(n);
+					}
+				}
+			}
+		};
+
+		addTriangle(seed);
+
+		while (clusterTris.size() < ObjScene::MaxClusterTriangles && !frontier.empty())
+		{
+			float normalLen = normalSum.length();
+			math3d::vec3f axis = normalLen > 0.0f ? normalSum / normalLen : math3d::vec3f(0.0f, 0.0f, 0.0f);
+			math3d::vec3f center = centroidSum / static_cast<float>(clusterTris.size());
+
+			size_t best = 0;
+			float bestScore = -FLT_MAX;
+			for (size_t i = 0; i < frontier.size(); ++i)
+			{
+				int32_t t = frontier[i];
+				float score = math3d::dot(normals[t], axis) - (centroids[t] - center).length() / clusterRadius;
+				if (score > bestScore)
+				{
+					bestScore = score;
+					best = i;
+				}
+			}
+
+			int32_t t = frontier[best];
+			if (clusterTris.size() >= MinClusterTriangles && math3d::dot(normals[t], axis) < MinClusterNormalCos)
+				break;
+
+			frontier[best] = frontier.back();
+			frontier.pop_back();
+			addTriangle(t);
+		}
+
+		// Bounds and the normal cone. Degenerate triangles are never drawn and don't narrow the cone.
+
+		ObjScene::Cluster cluster;
+		cluster.indexOffset = indexOffset + static_cast<int>(newIndices.size());
+		cluster.numIndices = static_cast<int>(clusterTris.size() * 3);
+		cluster.minPt = position(clusterTris[0], 0);
+		cluster.maxPt = cluster.minPt;
+
+		float normalLen = normalSum.length();
+		cluster.coneAxis = normalLen > 0.0f ? normalSum / normalLen : math3d::vec3f(0.0f, 0.0f, 1.0f);
+		float minDot = normalLen > 0.0f ? 1.0f : -1.0f;
+
+		for (int32_t t : clusterTris)
+		{
+			for (int corner = 0; corner < 3; ++corner)
+			{
+				ExpandBounds(cluster.minPt, cluster.maxPt, position(t, corner));
+				newIndices.push_back(tris[t * 3 + corner]);
+			}
+
+			if (normals[t] != math3d::vec3f(0.0f, 0.0f, 0.0f))
+				minDot = std::min(minDot, math3d::dot(normals[t], cluster.coneAxis));
+		}
+
+		cluster.coneCutoff = minDot > 0.0f ? std::sqrt(1.0f - minDot * minDot) : 1.0f;
+		clusters.push_back(cluster);
+		++clusterInd;
+	}
+
+	std::copy(newIndices.begin(), newIndices.end(), indices.begin() + indexOffset);
+}
@@ -0,0 +1,20 @@
+#ifndef _MESH_CLUSTERIZER_H_
+#define _MESH_CLUSTERIZER_H_
+
+#include <vector>
+#include <cstdint>
+#include "ObjScene.h"
+
+
+// Splits the triangles of an index range into clusters of up to ObjScene::MaxClusterTriangles connected triangles
+// with similar normals, and reorders the range so that each cluster's triangles are contiguous. Clusters grow from
+// triangle to neighbouring triangle, preferring those close to the cluster's center and facing the same way, which
+// keeps bounding boxes small and normal cones narrow. Appends the clusters, with bounds and normal cones, to clusters.
+void BuildClusters(
+	const std::vector<ObjScene::Vertex>& vertices,
+	std::vector<int32_t>& indices,
+	int indexOffset,
+	int numIndices,
+	std::vector<ObjScene::Cluster>& clusters);
+
+#endif // _MESH_CLUSTERIZER_H_
@@ -0,0 +1,311 @@
+#include "MeshSimplifier.h"
+#include <cmath>
+#include <array>
+#include <queue>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
+
+
+// Collapses which turn a triangle's normal by more than about 78 degrees are rejected.
+static constexpr double MinNormalCos = 0.2;
+
+
+// Sum of squared distances to a set of planes, weighted by the areas of the triangles they come from.
+struct Quadric
+{
+	double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+	double weight = 0;
+
+	void Add(const Quadric& q)
+	{
+		a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+		b2 += q.b2; bc += q.bc; bd += q.bd;
+		c2 += q.c2; cd += q.cd;
+		d2 += q.d2;
+		weight += q.weight;
+	}
+
+	// Mean squared distance of the point from the planes.
+	double Error(const math3d::vec3f& p) const
+	{
+		double x = p.x, y = p.y, z = p.z;
+		double err =
+			a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+			b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+			c2 * z * z + 2 * cd * z +
+			d2;
+		return weight > 0 ? std::max(err, 0.0) / weight : 0.0;
+	}
+};
+
+struct Collapse
+{
+	double cost;
+	int32_t from;
+	int32_t to;
+	uint32_t fromVersion;
+	uint32_t toVersion;
+
+	bool operator > (const Collapse& other) const { return cost > other.cost; }
+};
+
+static math3d::vec3d TriangleNormal(const math3d::vec3f& p0, const math3d::vec3f& p1, const math3d::vec3f& p2)
+{
+	math3d::vec3d e1(p1.x - p0.x, p1.y - p0.y, p1.z - p0.z);
+	math3d::vec3d e2(p2.x - p0.x, p2.y - p0.y, p2.z - p0.z);
+	return math3d::cross(e1, e2);
+}
+
+static Quadric PlaneQuadric(const math3d::vec3f& p0, const math3d::vec3f& p1, const math3d::vec3f& p2)
+{
+	Quadric q;
+	math3d::vec3d n = TriangleNormal(p0, p1, p2);
+	double len = n.length();
+	if (len == 0.0)
+		return q;
+
+	double area = len * 0.5;
+	n /= len;
+	double d = -(n.x * p0.x + n.y * p0.y + n.z * p0.z);
+
+	q.a2 = area * n.x * n.x; q.ab = area * n.x * n.y; q.ac = area * n.x * n.z; q.ad = area * n.x * d;
+	q.b2 = area * n.y * n.y; q.bc = area * n.y * n.z; q.bd = area * n.y * d;
+	q.c2 = area * n.z * n.z; q.cd = area * n.z * d;
+	q.d2 = area * d * d;
+	q.weight = area;
+	return q;
+}
+
+float SimplifyMesh(
+	const std::vector<ObjScene::Vertex>& vertices,
+	const int32_t* indices,
+	size_t numIndices,
+	size_t targetNumIndices,
+	std::vector<int32_t>& result)
+{
+	result.clear();
+
+	size_t numTris = numIndices / 3;
+	if (numTris == 0)
+		return 0.0f;
+
+	// Meshes reference a contiguous range of the scene's vertices; work with indices local to it.
+
+	auto [minIt, maxIt] = std::minmax_element(indices, indices + numTris * 3);
+	int32_t baseIndex = *minIt;
+	size_t numVerts = static_cast<size_t>(*maxIt - baseIndex + 1);
+	auto position = [&](int32_t v) -> const math3d::vec3f& { return vertices[baseIndex + v].position; };
+
+	std::vector<std::array<int32_t, 3>> tris(numTris);
+	std::vector<std::vector<int32_t>> vertTris(numVerts);
+	for (size_t t = 0; t < numTris; ++t)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			tris[t][i] = indices[t * 3 + i] - baseIndex;
+			vertTris[tris[t][i]].push_back(static_cast<int32_t>(t));
+		}
+	}
+
+	// Vertices at the same position (split by different normals or texture coordinates) are the same point of the
+	// surface and share one quadric.
+
+	std::vector<int32_t> sortedVerts(numVerts);
+	std::iota(sortedVerts.begin(), sortedVerts.end(), 0);
+	auto lessPos = [&](int32_t a, int32_t b)
+	{
+		const math3d::vec3f& pa = position(a);
+		const math3d::vec3f& pb = position(b);
+		return pa.x != pb.x ? pa.x < pb.x : pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z;
+	};
+	std::sort(sortedVerts.begin(), sortedVerts.end(), lessPos);
+
+	std::vector<int32_t> pointOf(numVerts);
+	std::vector<int32_t> pointVertCount;
+	for (size_t i = 0; i < numVerts; ++i)
+	{
+		if (i == 0 || lessPos(sortedVerts[i - 1], sortedVerts[i]))
+			pointVertCount.push_back(0);
+		pointOf[sortedVerts[i]] = static_cast<int32_t>(pointVertCount.size() - 1);
+		++pointVertCount.back();
+	}
+
+	size_t numPoints = pointVertCount.size();
+	std::vector<Quadric> quadrics(numPoints);
+	std::vector<bool> locked(numPoints, false);
+	std::unordered_map<uint64_t, int> edgeTriCount;
+
+	for (const auto& tri : tris)
+	{
+		Quadric q = PlaneQuadric(position(tri[0]), position(tri[1]), position(tri[2]));
+
+		for (int i = 0; i < 3; ++i)
+		{
+			quadrics[pointOf[tri[i]]].Add(q);
+
+			uint64_t p0 = static_cast<uint64_t>(pointOf[tri[i]]);
+			uint64_t p1 = static_cast<uint64_t>(pointOf[tri[(i + 1) % 3]]);
+			++edgeTriCount[std::min(p0, p1) << 32 | std::max(p0, p1)];
+		}
+	}
+
+	// Points on open borders, non-manifold edges and attribute seams stay in place.
+
+	for (const auto& [edge, count] : edgeTriCount)
+	{
+		if (count != 2)
+		{
+			locked[edge >> 32] = true;
+			locked[edge & 0xffffffff] = true;
+		}
+	}
+
+	for (size_t p = 0; p < numPoints; ++p)
+	{
+		if (pointVertCount[p] > 1)
+			locked[p] = true;
+	}
+
+	// Collapses are taken cheapest first. Entries go stale when either vertex changes; those are recomputed
+	// when they come up.
+
+	std::vector<uint32_t> versions(numVerts, 0);
+	std::vector<bool> removed(numVerts, false);
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+
+	auto collapseCost = [&](int32_t from, int32_t to)
+	{
+		Quadric q = quadrics[pointOf[from]];
+		q.Add(quadrics[pointOf[to]]);
+		return q.Error(position(to));
+	};
+
+	auto pushCollapse = [&](int32_t from, int32_t to)
+	{
+		if (!locked[pointOf[from]] && pointOf[from] != pointOf[to])
+			queue.push({ collapseCost(from, to), from, to, versions[from], versions[to] });
+	};
+
+	for (const auto& tri : tris)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			pushCollapse(tri[i], tri[(i + 1) % 3]);
+			pushCollapse(tri[(i + 1) % 3], tri[i]);
+		}
+	}
+
+	auto containsPoint = [&](const std::array<int32_t, 3>& tri, int32_t point)
+	{
+		return pointOf[tri[0]] == point || pointOf[tri[1]] == point || pointOf[tri[2]] == point;
+	};
+
+	// Moving the vertex must not flip or fold any triangle around it which stays.
+	auto canCollapse = [&](int32_t from, int32_t to)
+	{
+		const math3d::vec3f& newPos = position(to);
+
+		for (int32_t t : vertTris[from])
+		{
+			const auto& tri = tris[t];
+			if (tri[0] < 0 || containsPoint(tri, pointOf[to]))
+				continue;
+
+			math3d::vec3f p[3] = { position(tri[0]), position(tri[1]), position(tri[2]) };
+			math3d::vec3d oldNormal = TriangleNormal(p[0], p[1], p[2]);
+			for (int i = 0; i < 3; ++i)
+			{
+				if (tri[i] == from)
+					p[i] = newPos;
+			}
+			math3d::vec3d newNormal = TriangleNormal(p[0], p[1], p[2]);
+
+			if (math3d::dot(oldNormal, newNormal) <= MinNormalCos * oldNormal.length() * newNormal.length())
+				return false;
+		}
+
+		return true;
+	};
+
+	size_t numAliveTris = numTris;
+	double maxError = 0.0;
+
+	while (numAliveTris * 3 > targetNumIndices && !queue.empty())
+	{
+		Collapse collapse = queue.top();
+		queue.pop();
+
+		int32_t from = collapse.from;
+		int32_t to = collapse.to;
+
+		if (removed[from] || removed[to])
+			continue;
+
+		if (collapse.fromVersion != versions[from] || collapse.toVersion != versions[to])
+		{
+			pushCollapse(from, to);
+			continue;
+		}
+
+		if (!canCollapse(from, to))
+			continue;
+
+		// Triangles on the collapsed edge degenerate and are removed, the others move over to the kept vertex.
+
+		for (int32_t t : vertTris[from])
+		{
+			auto& tri = tris[t];
+			if (tri[0] < 0)
+				continue;
+
+			if (containsPoint(tri, pointOf[to]))
+			{
+				tri[0] = tri[1] = tri[2] = -1;
+				--numAliveTris;
+			}
+			else
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					if (tri[i] == from)
+						tri[i] = to;
+				}
+				vertTris[to].push_back(t);
+			}
+		}
+
+		quadrics[pointOf[to]].Add(quadrics[pointOf[from]]);
+		removed[from] = true;
+		vertTris[from].clear();
+		++versions[to];
+		maxError = std::max(maxError, collapse.cost);
+
+		std::vector<int32_t>& toTris = vertTris[to];
+		toTris.erase(std::remove_if(toTris.begin(), toTris.end(), [&](int32_t t) { return tris[t][0] < 0; }), toTris.end());
+
+		for (int32_t t : toTris)
+		{
+			for (int32_t v : tris[t])
+			{
+				if (v != to)
+				{
+					pushCollapse(to, v);
+					pushCollapse(v, to);
+				}
+			}
+		}
+	}
+
+	result.reserve(numAliveTris * 3);
+	for (const auto& tri : tris)
+	{
+		if (tri[0] >= 0)
+		{
+			for (int32_t v : tri)
+				result.push_back(baseIndex + v);
+		}
+	}
+
+	return static_cast<float>(std::sqrt(maxError));
+}
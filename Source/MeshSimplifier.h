@@ -0,0 +1,21 @@
+#ifndef _MESH_SIMPLIFIER_H_
+#define _MESH_SIMPLIFIER_H_
+
+#include <vector>
+#include <cstdint>
+#include "ObjScene.h"
+
+
+// Simplifies a triangle list with quadric error metric edge collapses. Vertices are only ever collapsed onto other
+// existing vertices, so the result indexes the same vertex array and can share its vertex buffer. Vertices on open
+// borders and texture or normal seams are never removed, which keeps the silhouette and the texture mapping intact.
+// Stops at targetNumIndices or when no collapse is left which wouldn't flip a triangle. Returns the largest error
+// of the collapses made, as a distance from the original surface in model units.
+float SimplifyMesh(
+	const std::vector<ObjScene::Vertex>& vertices,
+	const int32_t* indices,
+	size_t numIndices,
+	size_t targetNumIndices,
+	std::vector<int32_t>& result);
+
+#endif // _MESH_SIMPLIFIER_H_
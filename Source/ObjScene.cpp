@@ -5,7 +5,20 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tinyobjloader/tiny_obj_loader.h>
 #include "TgaLoader.h"
+#include "MeshSimplifier.h"
+#include "MeshClusterizer.h"
 #include "Utils.h"
+#include "Profiler.h"
+
+
+// Cache files start with the magic and version; caches of other versions are rebuilt from the obj file.
+static constexpr uint32_t CacheFileMagic = 0x4843424f;	// "OBCH"
+static constexpr uint32_t CacheFileVersion = 3;
+
+// Each level of detail is simplified to this fraction of the previous level's triangles. Levels which don't get
+// below MinLodReduction of the previous one aren't worth the memory and end the chain.
+static constexpr float LodTriangleRatio = 0.5f;
+static constexpr float MinLodReduction = 0.8f;
 
 
 static math3d::vec3f CalculateTangent(
@@ -34,6 +47,8 @@ ObjScene::~ObjScene()
 
 bool ObjScene::Load(gls::IRenderContext* renderContext, const char* objFileName)
 {
+	PROFILE_ZONE("ObjScene::Load");
+
 	if (renderContext == nullptr)
 		return false;
 
@@ -46,12 +61,18 @@ bool ObjScene::Load(gls::IRenderContext* renderContext, const char* objFileName)
 	std::vector<ObjScene::Vertex> vertices;
 	std::vector<int32_t> indices;
 
-	if (!LoadCache(fullFilePath, _meshes, materials, vertices, indices))
+	if (!LoadCache(fullFilePath, _meshes, _clusters, materials, vertices, indices))
 	{
 		if (LoadObj(fullFilePath, _meshes, materials, vertices, indices))
-			SaveCache(fullFilePath, _meshes, materials, vertices, indices);
+		{
+			GenerateLods(vertices, _meshes, indices);
+			GenerateClusters(vertices, _meshes, indices, _clusters);
+			SaveCache(fullFilePath, _meshes, _clusters, materials, vertices, indices);
+		}
 		else
+		{
 			return false;
+		}
 	}
 
 	auto cmpFunc = [](const auto& a, const auto& b) -> bool {
@@ -63,6 +84,8 @@ bool ObjScene::Load(gls::IRenderContext* renderContext, const char* objFileName)
 
 	// Create vertex and index buffers.
 	
+	PROFILE_ZONE("CreateBuffersAndTextures");
+
 	_vertexBuffer = _renderContext->CreateBuffer(vertices.size() * sizeof(Vertex), vertices.data(), 0);
 	_indexBuffer = _renderContext->CreateBuffer(indices.size() * 4, indices.data(), 0);
 
@@ -75,6 +98,7 @@ bool ObjScene::Load(gls::IRenderContext* renderContext, const char* objFileName)
 	{
 		if (materials[matIndex].diffuseTexture.empty() == false)
 		{
+			PROFILE_ZONE("LoadDiffuseTexture");
 			TgaLoader tgaLoader;
 			std::string fullTexPath = fullDirPath + "/" + materials[matIndex].diffuseTexture;
 			if (tgaLoader.Load(fullTexPath.c_str()))
@@ -96,6 +120,7 @@ bool ObjScene::Load(gls::IRenderContext* renderContext, const char* objFileName)
 
 		if (materials[matIndex].normalTexture.empty() == false)
 		{
+			PROFILE_ZONE("LoadNormalTexture");
 			TgaLoader tgaLoader;
 			std::string fullTexPath = fullDirPath + "/" + materials[matIndex].normalTexture;
 			if (tgaLoader.Load(fullTexPath.c_str()))
@@ -138,6 +163,7 @@ void ObjScene::Unload()
 		}
 
 		_meshes.clear();
+		_clusters.clear();
 		_materials.clear();
 		_renderContext = nullptr;
 	}
@@ -191,6 +217,8 @@ bool ObjScene::LoadObj(
 	std::vector<ObjScene::Vertex>& vertices,
 	std::vector<int32_t>& indices)
 {
+	PROFILE_ZONE("ObjScene::LoadObj");
+
 	std::string fullDirPath = objFilePath.substr(0, objFilePath.find_last_of("/\\"));
 
 	tinyobj::ObjReaderConfig config;
@@ -199,8 +227,11 @@ bool ObjScene::LoadObj(
 	config.mtl_search_path = fullDirPath;
 
 	tinyobj::ObjReader objReader;
-	if (!objReader.ParseFromFile(objFilePath, config))
-		return false;
+	{
+		PROFILE_ZONE("ParseObj");
+		if (!objReader.ParseFromFile(objFilePath, config))
+			return false;
+	}
 
 	const tinyobj::attrib_t& attrib = objReader.GetAttrib();
 	const std::vector<tinyobj::shape_t>& shapes = objReader.GetShapes();
@@ -219,8 +250,12 @@ bool ObjScene::LoadObj(
 		size_t numIndices = shape.mesh.indices.size();
 		Mesh& mesh = meshes[meshInd];
 		mesh.name = shape.name;
-		mesh.indexOffset = indexOffset;
-		mesh.numIndices = static_cast<int>(numIndices);
+		mesh.numLods = 1;
+		mesh.lods[0].indexOffset = indexOffset;
+		mesh.lods[0].numIndices = static_cast<int>(numIndices);
+		mesh.lods[0].error = 0.0f;
+		mesh.lods[0].clusterOffset = 0;
+		mesh.lods[0].numClusters = 0;
 		mesh.materialIndex = shape.mesh.material_ids[0];
 		constexpr float lowflt = std::numeric_limits<float>::lowest();
 		constexpr float maxflt = std::numeric_limits<float>::max();
@@ -275,6 +310,8 @@ bool ObjScene::LoadObj(
 
 	// Calculate vertex tangents.
 
+	PROFILE_ZONE("CalculateTangents");
+
 	size_t numIndices = indices.size();
 
 	for (size_t i = 0; i < numIndices; i += 3)
@@ -313,30 +350,101 @@ bool ObjScene::LoadObj(
 	return true;
 }
 
+void ObjScene::GenerateLods(
+	const std::vector<ObjScene::Vertex>& vertices,
+	std::vector<ObjScene::Mesh>& meshes,
+	std::vector<int32_t>& indices)
+{
+	PROFILE_ZONE("ObjScene::GenerateLods");
+
+	// Simplified index ranges are appended to the index buffer. Each level is made from the previous one, which is
+	// faster, and its error is the sum of errors along the chain.
+
+	std::vector<int32_t> lodIndices;
+
+	for (Mesh& mesh : meshes)
+	{
+		while (mesh.numLods < MaxLods)
+		{
+			const Lod& prevLod = mesh.lods[mesh.numLods - 1];
+			size_t targetNumIndices = static_cast<size_t>(prevLod.numIndices / 3 * LodTriangleRatio) * 3;
+
+			float error = SimplifyMesh(vertices, indices.data() + prevLod.indexOffset, prevLod.numIndices, targetNumIndices, lodIndices);
+			if (lodIndices.empty() || lodIndices.size() > prevLod.numIndices * MinLodReduction)
+				break;
+
+			Lod& lod = mesh.lods[mesh.numLods++];
+			lod.indexOffset = static_cast<int>(indices.size());
+			lod.numIndices = static_cast<int>(lodIndices.size());
+			lod.error = prevLod.error + error;
+			lod.clusterOffset = 0;
+			lod.numClusters = 0;
+			indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+		}
+	}
+}
+
+void ObjScene::GenerateClusters(
+	const std::vector<ObjScene::Vertex>& vertices,
+	std::vector<ObjScene::Mesh>& meshes,
+	std::vector<int32_t>& indices,
+	std::vector<ObjScene::Cluster>& clusters)
+{
+	PROFILE_ZONE("ObjScene::GenerateClusters");
+
+	clusters.clear();
+
+	for (Mesh& mesh : meshes)
+	{
+		for (int lodInd = 0; lodInd < mesh.numLods; ++lodInd)
+		{
+			Lod& lod = mesh.lods[lodInd];
+			lod.clusterOffset = static_cast<int>(clusters.size());
+			BuildClusters(vertices, indices, lod.indexOffset, lod.numIndices, clusters);
+			lod.numClusters = static_cast<int>(clusters.size()) - lod.clusterOffset;
+		}
+	}
+}
+
 void ObjScene::SaveCache(
 	const std::string& objFilePath,
 	const std::vector<ObjScene::Mesh>& meshes,
+	const std::vector<ObjScene::Cluster>& clusters,
 	const std::vector<ObjScene::MaterialData>& materials,
 	const std::vector<ObjScene::Vertex>& vertices,
 	const std::vector<int32_t>& indices)
 {
+	PROFILE_ZONE("ObjScene::SaveCache");
+
 	std::string cacheFilePath = objFilePath + ".cache";
 	FILE* file = fopen(cacheFilePath.c_str(), "wb");
 	if (file == nullptr)
 		return;
 
+	WriteInt<uint32_t>(file, CacheFileMagic);
+	WriteInt<uint32_t>(file, CacheFileVersion);
 	WriteInt<uint32_t>(file, meshes.size());
 
 	for (auto& mesh : meshes)
 	{
 		WriteString(file, mesh.name);
-		WriteInt<uint32_t>(file, mesh.indexOffset);
-		WriteInt<uint32_t>(file, mesh.numIndices);
 		WriteInt<uint32_t>(file, mesh.materialIndex);
 		WriteVec3(file, mesh.minPt);
 		WriteVec3(file, mesh.maxPt);
+		WriteInt<uint32_t>(file, mesh.numLods);
+
+		for (int lodInd = 0; lodInd < mesh.numLods; ++lodInd)
+		{
+			WriteInt<uint32_t>(file, mesh.lods[lodInd].indexOffset);
+			WriteInt<uint32_t>(file, mesh.lods[lodInd].numIndices);
+			fwrite(&mesh.lods[lodInd].error, 4, 1, file);
+			WriteInt<uint32_t>(file, mesh.lods[lodInd].clusterOffset);
+			WriteInt<uint32_t>(file, mesh.lods[lodInd].numClusters);
+		}
 	}
 
+	WriteInt<uint32_t>(file, clusters.size());
+	fwrite(clusters.data(), sizeof(Cluster), clusters.size(), file);
 
 	WriteInt<uint32_t>(file, materials.size());
 
@@ -384,28 +492,51 @@ static math3d::vec3f ReadVec3(FILE* file)
 bool ObjScene::LoadCache(
 	const std::string& objFilePath,
 	std::vector<ObjScene::Mesh>& meshes,
+	std::vector<ObjScene::Cluster>& clusters,
 	std::vector<ObjScene::MaterialData>& materials,
 	std::vector<ObjScene::Vertex>& vertices,
 	std::vector<int32_t>& indices)
 {
+	PROFILE_ZONE("ObjScene::LoadCache");
+
 	std::string cacheFilePath = objFilePath + ".cache";
 	FILE* file = fopen(cacheFilePath.c_str(), "rb");
 	if (file == nullptr)
 		return false;
 
+	uint32_t magic = ReadInt<uint32_t>(file);
+	uint32_t version = ReadInt<uint32_t>(file);
+	if (magic != CacheFileMagic || version != CacheFileVersion)
+	{
+		fclose(file);
+		return false;
+	}
+
 	uint32_t numMeshes = ReadInt<uint32_t>(file);
 	meshes.resize(numMeshes);
 
 	for (uint32_t i = 0; i < numMeshes; ++i)
 	{
 		meshes[i].name = ReadString(file);
-		meshes[i].indexOffset = ReadInt<uint32_t>(file);
-		meshes[i].numIndices = ReadInt<uint32_t>(file);
 		meshes[i].materialIndex = ReadInt<uint32_t>(file);
 		meshes[i].minPt = ReadVec3(file);
 		meshes[i].maxPt = ReadVec3(file);
+		meshes[i].numLods = std::clamp(static_cast<int>(ReadInt<uint32_t>(file)), 1, MaxLods);
+
+		for (int lodInd = 0; lodInd < meshes[i].numLods; ++lodInd)
+		{
+			meshes[i].lods[lodInd].indexOffset = ReadInt<uint32_t>(file);
+			meshes[i].lods[lodInd].numIndices = ReadInt<uint32_t>(file);
+			fread(&meshes[i].lods[lodInd].error, 4, 1, file);
+			meshes[i].lods[lodInd].clusterOffset = ReadInt<uint32_t>(file);
+			meshes[i].lods[lodInd].numClusters = ReadInt<uint32_t>(file);
+		}
 	}
 
+	uint32_t numClusters = ReadInt<uint32_t>(file);
+	clusters.resize(numClusters);
+	fread(clusters.data(), sizeof(Cluster), numClusters, file);
+
 	uint32_t numMats = ReadInt<uint32_t>(file);
 	materials.resize(numMats);
 
@@ -1,6 +1,7 @@
 #ifndef _OBJ_SCENE_H_
 #define _OBJ_SCENE_H_
 
+#include <array>
 #include <vector>
 #include <string>
 #include <GLSlayer/RenderContext.h>
@@ -10,6 +11,9 @@
 class ObjScene
 {
 public:
+	static constexpr int MaxLods = 4;
+	static constexpr int MaxClusterTriangles = 128;
+
 	ObjScene() = default;
 	~ObjScene();
 
@@ -31,12 +35,35 @@ public:
 		bool transparent = false;
 	};
 
-	struct Mesh
+	// Spatially compact group of triangles within a level of detail, culled on its own. All the triangles face away
+	// from any point p for which dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius, where center
+	// and radius are those of the bounding box's sphere.
+	struct Cluster
+	{
+		int indexOffset;
+		int numIndices;
+		math3d::vec3f minPt;
+		math3d::vec3f maxPt;
+		math3d::vec3f coneAxis;
+		float coneCutoff;	// Sine of the widest angle between a triangle normal and the axis; 1 if the cone can't cull.
+	};
+
+	// Index range of one level of detail. All levels index the same vertices. The range is ordered by cluster.
+	struct Lod
 	{
-		std::string name;
 		int indexOffset;
 		int numIndices;
+		float error;		// Largest distance of the simplified surface from the full detail one, in model units.
+		int clusterOffset;
+		int numClusters;
+	};
+
+	struct Mesh
+	{
+		std::string name;
 		int materialIndex;
+		int numLods;
+		std::array<Lod, MaxLods> lods;		// Level 0 is the full detail mesh.
 		math3d::vec3f minPt;
 		math3d::vec3f maxPt;
 	};
@@ -46,7 +73,11 @@ public:
 
 	int GetMeshCount() const { return (int)_meshes.size(); }
 	const Mesh& GetMesh(int index) const { return _meshes[index]; }
+	int GetMeshIndex(const Mesh& mesh) const { return static_cast<int>(&mesh - _meshes.data()); }
 	
+	int GetClusterCount() const { return (int)_clusters.size(); }
+	const Cluster& GetCluster(int index) const { return _clusters[index]; }
+
 	int GetMaterialCount() const { return (int)_materials.size(); }
 	const Material& GetMaterial(int index) const { return _materials[index]; }
 
@@ -71,9 +102,21 @@ private:
 		std::vector<ObjScene::Vertex>& vertices,
 		std::vector<int32_t>& indices);
 
+	static void GenerateLods(
+		const std::vector<ObjScene::Vertex>& vertices,
+		std::vector<ObjScene::Mesh>& meshes,
+		std::vector<int32_t>& indices);
+
+	static void GenerateClusters(
+		const std::vector<ObjScene::Vertex>& vertices,
+		std::vector<ObjScene::Mesh>& meshes,
+		std::vector<int32_t>& indices,
+		std::vector<ObjScene::Cluster>& clusters);
+
 	static void SaveCache(
 		const std::string& objFilePath,
 		const std::vector<ObjScene::Mesh>& meshes,
+		const std::vector<ObjScene::Cluster>& clusters,
 		const std::vector<ObjScene::MaterialData>& materials,
 		const std::vector<ObjScene::Vertex>& vertices,
 		const std::vector<int32_t>& indices);
@@ -81,6 +124,7 @@ private:
 	static bool LoadCache(
 		const std::string& objFilePath,
 		std::vector<ObjScene::Mesh>& meshes,
+		std::vector<ObjScene::Cluster>& clusters,
 		std::vector<ObjScene::MaterialData>& materials,
 		std::vector<ObjScene::Vertex>& vertices,
 		std::vector<int32_t>& indices);
@@ -89,6 +133,7 @@ private:
 	gls::IBuffer* _vertexBuffer = nullptr;
 	gls::IBuffer* _indexBuffer = nullptr;
 	std::vector<Mesh> _meshes;
+	std::vector<Cluster> _clusters;
 	std::vector<Material> _materials;
 };
 
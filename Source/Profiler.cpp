@@ -0,0 +1,192 @@
+#include "Profiler.h"
+
+#if defined (ENABLE_PROFILER)
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#if defined (_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <time.h>
+#endif
+
+
+struct ZoneEvent
+{
+	const char* name;
+	uint64_t start;
+	uint64_t end;
+};
+
+// Written only by the owning thread. The count is published with release semantics after the event,
+// so the trace writer can read it from another thread.
+struct ThreadZoneBuffer
+{
+	static constexpr uint32_t Capacity = 1 << 18;
+
+	uint32_t threadIndex = 0;
+	std::atomic<uint32_t> generation { 0 };
+	std::atomic<uint32_t> count { 0 };
+	std::atomic<uint64_t> dropped { 0 };
+	std::unique_ptr<ZoneEvent[]> events;
+};
+
+std::atomic<bool> g_profilerCapturing { false };
+
+// Buffers are created once per thread and never freed, so a thread can keep a plain pointer to its own.
+static std::mutex s_bufferListMutex;
+static std::vector<std::unique_ptr<ThreadZoneBuffer>> s_buffers;
+static thread_local ThreadZoneBuffer* t_buffer = nullptr;
+
+// Every capture has a new generation. Buffers still holding zones of an older one are reset by their
+// thread on the first zone recorded in the new capture.
+static std::atomic<uint32_t> s_captureGeneration { 0 };
+static uint64_t s_captureStart = 0;
+
+
+uint64_t ProfilerTimestamp()
+{
+#if defined (_WIN32)
+	static const uint64_t frequency = []() { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return static_cast<uint64_t>(f.QuadPart); }();
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	uint64_t ticks = static_cast<uint64_t>(counter.QuadPart);
+	return ticks / frequency * 1000000000ull + ticks % frequency * 1000000000ull / frequency;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+static ThreadZoneBuffer* GetThreadBuffer()
+{
+	if (t_buffer == nullptr)
+	{
+		auto buffer = std::make_unique<ThreadZoneBuffer>();
+		buffer->events = std::make_unique<ZoneEvent[]>(ThreadZoneBuffer::Capacity);
+
+		std::lock_guard<std::mutex> lock(s_bufferListMutex);
+		buffer->threadIndex = static_cast<uint32_t>(s_buffers.size());
+		t_buffer = buffer.get();
+		s_buffers.push_back(std::move(buffer));
+	}
+
+	return t_buffer;
+}
+
+void RecordProfileZone(const char* name, uint64_t start, uint64_t end)
+{
+	// Zones still open when the capture ended are not recorded.
+	if (!g_profilerCapturing.load(std::memory_order_relaxed))
+		return;
+
+	ThreadZoneBuffer* buffer = GetThreadBuffer();
+
+	uint32_t generation = s_captureGeneration.load(std::memory_order_relaxed);
+	if (buffer->generation.load(std::memory_order_relaxed) != generation)
+	{
+		buffer->count.store(0, std::memory_order_relaxed);
+		buffer->dropped.store(0, std::memory_order_relaxed);
+		buffer->generation.store(generation, std::memory_order_release);
+	}
+
+	uint32_t count = buffer->count.load(std::memory_order_relaxed);
+	if (count < ThreadZoneBuffer::Capacity)
+	{
+		buffer->events[count] = { name, start, end };
+		buffer->count.store(count + 1, std::memory_order_release);
+	}
+	else
+	{
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void BeginProfilerCapture()
+{
+	if (g_profilerCapturing)
+		return;
+
+	s_captureGeneration.fetch_add(1, std::memory_order_relaxed);
+	s_captureStart = ProfilerTimestamp();
+	g_profilerCapturing = true;
+}
+
+void EndProfilerCapture()
+{
+	g_profilerCapturing = false;
+}
+
+bool IsProfilerCapturing()
+{
+	return g_profilerCapturing;
+}
+
+static void WriteJsonString(FILE* file, const char* str)
+{
+	fputc('"', file);
+	for (; *str; ++str)
+	{
+		if (*str == '"' || *str == '\\')
+			fputc('\\', file);
+		fputc(*str, file);
+	}
+	fputc('"', file);
+}
+
+bool WriteProfilerTrace(const char* fileName, uint64_t* droppedZones)
+{
+	FILE* file = fopen(fileName, "w");
+	if (file == nullptr)
+		return false;
+
+	uint32_t generation = s_captureGeneration.load(std::memory_order_relaxed);
+	uint64_t dropped = 0;
+	bool first = true;
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	std::lock_guard<std::mutex> lock(s_bufferListMutex);
+
+	for (const auto& buffer : s_buffers)
+	{
+		if (buffer->generation.load(std::memory_order_acquire) != generation)
+			continue;
+
+		uint32_t count = buffer->count.load(std::memory_order_acquire);
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+			first ? "" : ",\n", buffer->threadIndex, buffer->threadIndex);
+		first = false;
+
+		// Complete events; the viewer nests them by time, so the order within a thread doesn't matter.
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const ZoneEvent& event = buffer->events[i];
+			if (event.start < s_captureStart)
+				continue;
+
+			fprintf(file, ",\n{\"name\":");
+			WriteJsonString(file, event.name);
+			fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				buffer->threadIndex, (event.start - s_captureStart) * 0.001, (event.end - event.start) * 0.001);
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	bool ok = !ferror(file);
+	fclose(file);
+
+	if (droppedZones)
+		*droppedZones = dropped;
+
+	return ok;
+}
+
+#endif // ENABLE_PROFILER
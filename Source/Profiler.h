@@ -0,0 +1,60 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+// Scoped CPU zone profiler. Zones are recorded only while a capture is running, into per-thread
+// buffers which need no locking, and are written as a Chrome trace (chrome://tracing, Perfetto).
+// Without ENABLE_PROFILER the PROFILE_ZONE macro expands to nothing.
+
+#if defined (ENABLE_PROFILER)
+
+#include <cstdint>
+#include <atomic>
+
+
+extern std::atomic<bool> g_profilerCapturing;
+
+uint64_t ProfilerTimestamp();	// Nanoseconds from a monotonic clock.
+void RecordProfileZone(const char* name, uint64_t start, uint64_t end);
+
+void BeginProfilerCapture();
+void EndProfilerCapture();
+bool IsProfilerCapturing();
+// Writes zones of the last capture. Returns the number of dropped zones through droppedZones.
+bool WriteProfilerTrace(const char* fileName, uint64_t* droppedZones = nullptr);
+
+
+// The name must stay valid until the trace is written; normally it's a string literal.
+class ProfileZone
+{
+public:
+	explicit ProfileZone(const char* name) :
+		_name(name),
+		_start(g_profilerCapturing.load(std::memory_order_relaxed) ? ProfilerTimestamp() : 0)
+	{
+	}
+
+	~ProfileZone()
+	{
+		if (_start != 0)
+			RecordProfileZone(_name, _start, ProfilerTimestamp());
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator = (const ProfileZone&) = delete;
+
+private:
+	const char* _name;
+	uint64_t _start;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(_profileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name)
+
+#endif // ENABLE_PROFILER
+
+#endif // _PROFILER_H_
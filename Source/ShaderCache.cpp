@@ -0,0 +1,118 @@
+#include "ShaderCache.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include "Utils.h"
+
+namespace fs = std::filesystem;
+
+
+#pragma pack(push, 1)
+struct ShaderCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint32_t binaryFormat;
+	uint32_t binarySize;
+};
+#pragma pack(pop)
+
+static constexpr uint32_t ShaderCacheMagic = 0x42534C47;	// "GLSB"
+static constexpr uint32_t ShaderCacheVersion = 1;
+
+
+void ShaderCache::Init(gls::IRenderContext* renderContext)
+{
+	_dirPath = GetFullPath("../ShaderCache/");
+
+	// Binaries are valid only for the exact driver that produced them.
+	const gls::ContextInfo& info = renderContext->GetInfo();
+	_driverHash = HashBytes(info.vendor, strlen(info.vendor));
+	_driverHash = HashBytes(info.renderer, strlen(info.renderer), _driverHash);
+	_driverHash = HashBytes(info.versionString, strlen(info.versionString), _driverHash);
+}
+
+bool ShaderCache::LoadBinary(const char* shaderName, const std::string& source, gls::uint& format, std::vector<char>& binary) const
+{
+	if (_dirPath.empty())
+		return false;
+
+	FILE* file = fopen(GetFilePath(shaderName).c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	ShaderCacheHeader header;
+	bool valid =
+		fread(&header, sizeof(header), 1, file) == 1 &&
+		header.magic == ShaderCacheMagic &&
+		header.version == ShaderCacheVersion &&
+		header.key == GetKey(source) &&
+		header.binarySize > 0;
+
+	if (valid)
+	{
+		binary.resize(header.binarySize);
+		valid = fread(binary.data(), 1, header.binarySize, file) == header.binarySize;
+		format = header.binaryFormat;
+	}
+
+	fclose(file);
+	return valid;
+}
+
+void ShaderCache::SaveBinary(const char* shaderName, const std::string& source, gls::IShader* shader) const
+{
+	if (_dirPath.empty())
+		return;
+
+	int size = shader->GetBinarySize();
+	if (size <= 0)
+		return;
+
+	std::vector<char> binary(size);
+	gls::uint format;
+	if (!shader->GetBinary(format, size, binary.data()))
+		return;
+
+	if (!fs::exists(_dirPath))
+	{
+		std::error_code ec;
+		if (!fs::create_directory(_dirPath, ec))
+			return;
+	}
+
+	FILE* file = fopen(GetFilePath(shaderName).c_str(), "wb");
+	if (file == nullptr)
+		return;
+
+	ShaderCacheHeader header;
+	header.magic = ShaderCacheMagic;
+	header.version = ShaderCacheVersion;
+	header.key = GetKey(source);
+	header.binaryFormat = format;
+	header.binarySize = static_cast<uint32_t>(size);
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(binary.data(), 1, size, file);
+	fclose(file);
+}
+
+void ShaderCache::RemoveBinary(const char* shaderName) const
+{
+	if (_dirPath.empty())
+		return;
+
+	std::error_code ec;
+	fs::remove(GetFilePath(shaderName), ec);
+}
+
+uint64_t ShaderCache::GetKey(const std::string& source) const
+{
+	return HashBytes(source.data(), source.size(), _driverHash);
+}
+
+std::string ShaderCache::GetFilePath(const char* shaderName) const
+{
+	return _dirPath + shaderName + ".bin";
+}
@@ -0,0 +1,30 @@
+#ifndef _SHADER_CACHE_H_
+#define _SHADER_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <GLSlayer/RenderContext.h>
+
+
+// Stores linked program binaries on disk so that shaders don't have to be compiled from source on every run.
+// Each entry is keyed by a hash of the shader source and the renderer and driver version strings; a change
+// in any of them invalidates the entry.
+class ShaderCache
+{
+public:
+	void Init(gls::IRenderContext* renderContext);
+
+	bool LoadBinary(const char* shaderName, const std::string& source, gls::uint& format, std::vector<char>& binary) const;
+	void SaveBinary(const char* shaderName, const std::string& source, gls::IShader* shader) const;
+	void RemoveBinary(const char* shaderName) const;
+
+private:
+	uint64_t GetKey(const std::string& source) const;
+	std::string GetFilePath(const char* shaderName) const;
+
+	std::string _dirPath;
+	uint64_t _driverHash = 0;
+};
+
+#endif // _SHADER_CACHE_H_
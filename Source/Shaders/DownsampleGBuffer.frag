@@ -0,0 +1,20 @@
+#version 440
+
+layout(location = 0) out vec4 outPosition;
+layout(location = 1) out vec4 outNormal;
+
+layout(binding = 0) uniform sampler2D depthTex;
+layout(binding = 1) uniform sampler2D positionTex;
+layout(binding = 2) uniform sampler2D normalTex;
+
+
+void main()
+{
+	// Each half resolution pixel takes the top left one of its 2x2 full resolution pixels, unfiltered, so that
+	// it holds a real surface point and the upsampling knows exactly where it came from.
+	ivec2 coords = ivec2(gl_FragCoord.xy) * 2;
+
+	outPosition = texelFetch(positionTex, coords, 0);
+	outNormal = texelFetch(normalTex, coords, 0);
+	gl_FragDepth = texelFetch(depthTex, coords, 0).r;
+}
@@ -10,12 +10,19 @@ layout(location = 0) in vec3 inVertPosition;
 layout(location = 1) in vec3 inVertNormal;
 layout(location = 2) in vec3 inVertTangent;
 layout(location = 3) in vec2 inVertTexcoords;
+#ifdef LIGHT_RANGE
+// First light index and light count of the mesh, an instanced attribute selected by the draw's base instance.
+layout(location = 4) in ivec2 inLightRange;
+#endif
 
 layout(location = 0) out vec3 outWorldPosition;
 layout(location = 1) out vec3 outWorldNormal;
 layout(location = 2) out vec3 outWorldTangent;
 layout(location = 3) out vec3 outWorldBitangent;
 layout(location = 4) out vec2 outTexcoords;
+#ifdef LIGHT_RANGE
+layout(location = 5) flat out ivec2 outLightRange;
+#endif
 
 
 out gl_PerVertex
@@ -32,4 +39,7 @@ void main()
 	outWorldTangent = inVertTangent;
 	outWorldBitangent = cross(outWorldNormal, outWorldTangent);
 	outTexcoords = inVertTexcoords;
+#ifdef LIGHT_RANGE
+	outLightRange = inLightRange;
+#endif
 }
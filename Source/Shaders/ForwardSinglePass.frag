@@ -10,14 +10,10 @@ layout(location = 1) in vec3 inWorldNormal;
 layout(location = 2) in vec3 inWorldTangent;
 layout(location = 3) in vec3 inWorldBitangent;
 layout(location = 4) in vec2 inTexcoords;
+layout(location = 5) flat in ivec2 inLightRange;
 
 layout(location = 0) out vec4 fragColor;
 
-layout(binding = 1) uniform LightData
-{
-	int numLights;
-};
-
 void main()
 {
 	vec4 diffuseColor = texture(diffuseTex, inTexcoords);
@@ -25,10 +21,21 @@ void main()
 	mat3 ws2TsMat = mat3(normalize(inWorldTangent), normalize(inWorldBitangent), normalize(inWorldNormal));
 
 	vec3 lightColor = vec3(0.0, 0.0, 0.0);
+	int firstLight = inLightRange.x;
+	int numLights = inLightRange.y;
+
+#ifdef MAX_LIGHTS
+	// Constant trip count lets the compiler unroll the loop; the renderer guarantees numLights <= MAX_LIGHTS.
+	for (int i = 0; i < MAX_LIGHTS; ++i)
+	{
+		if (i >= numLights)
+			break;
 
+#else
 	for (int i = 0; i < numLights; ++i)
 	{
-		int lightIndex = texelFetch(lightIndices, i).r;
+#endif
+		int lightIndex = texelFetch(lightIndices, firstLight + i).r;
 		vec4 lightPosRadius = texelFetch(lightPalette, lightIndex * 2 + 0);
 		vec4 lightColorAndFalloffExp = texelFetch(lightPalette, lightIndex * 2 + 1);
 
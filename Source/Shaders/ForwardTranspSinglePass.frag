@@ -10,13 +10,14 @@ layout(location = 1) in vec3 inWorldNormal;
 layout(location = 2) in vec3 inWorldTangent;
 layout(location = 3) in vec3 inWorldBitangent;
 layout(location = 4) in vec2 inTexcoords;
+layout(location = 5) flat in ivec2 inLightRange;
 
+#ifdef WEIGHTED_OIT
+layout(location = 0) out vec4 accumColor;
+layout(location = 1) out float revealage;
+#else
 layout(location = 0) out vec4 fragColor;
-
-layout(binding = 1) uniform LightData
-{
-	int numLights;
-};
+#endif
 
 void main()
 {
@@ -28,10 +29,21 @@ void main()
 	mat3 ws2TsMat = mat3(normalize(inWorldTangent), normalize(inWorldBitangent), normalize(inWorldNormal));
 
 	vec3 lightColor = vec3(0.0, 0.0, 0.0);
+	int firstLight = inLightRange.x;
+	int numLights = inLightRange.y;
+
+#ifdef MAX_LIGHTS
+	// Constant trip count lets the compiler unroll the loop; the renderer guarantees numLights <= MAX_LIGHTS.
+	for (int i = 0; i < MAX_LIGHTS; ++i)
+	{
+		if (i >= numLights)
+			break;
 
+#else
 	for (int i = 0; i < numLights; ++i)
 	{
-		int lightIndex = texelFetch(lightIndices, i).r;
+#endif
+		int lightIndex = texelFetch(lightIndices, firstLight + i).r;
 		vec4 lightPosRadius = texelFetch(lightPalette, lightIndex * 2 + 0);
 		vec4 lightColorAndFalloffExp = texelFetch(lightPalette, lightIndex * 2 + 1);
 
@@ -46,5 +58,14 @@ void main()
 		lightColor += lightColorAndFalloffExp.rgb * intensity * falloff;
 	}
 
+#ifdef WEIGHTED_OIT
+	// Weighted blended order-independent transparency (McGuire and Bavoil). Nearer surfaces get larger weights;
+	// the weight function is the paper's, scaled from meters to the scene's centimeters.
+	float viewDepth = 1.0 / gl_FragCoord.w;
+	float weight = diffuseColor.a * clamp(10.0 / (1e-5 + pow(viewDepth / 500.0, 2.0) + pow(viewDepth / 20000.0, 6.0)), 1e-2, 3e3);
+	accumColor = vec4(lightColor * diffuseColor.rgb * diffuseColor.a, diffuseColor.a) * weight;
+	revealage = diffuseColor.a;
+#else
 	fragColor = vec4(lightColor * diffuseColor.rgb, diffuseColor.a);
+#endif
 }
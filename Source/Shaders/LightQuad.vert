@@ -0,0 +1,16 @@
+#version 440
+
+layout(location = 0) in vec4 inVertPosition;	// xyz: normalized device coordinates, w: index of the light in the palette
+
+layout(location = 0) flat out int outLightIndex;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+void main()
+{
+	gl_Position = vec4(inVertPosition.xyz, 1.0);
+	outLightIndex = int(inVertPosition.w);
+}
@@ -6,11 +6,17 @@ layout(binding = 0) uniform SceneXforms
 	vec4 viewport;
 };
 
+#ifdef LIGHT_PALETTE
+// Many lights are drawn at once; each primitive reads its light from the palette.
+layout(binding = 3) uniform samplerBuffer lightPalette;
+layout(location = 0) flat in int inLightIndex;
+#else
 layout(binding = 1) uniform LightData
 {
 	vec4 lightPositionRadius;
 	vec4 lightColorFalloffExp;
 };
+#endif
 
 layout(binding = 0) uniform sampler2D diffuseTex;
 layout(binding = 1) uniform sampler2D positionTex;
@@ -20,15 +26,33 @@ layout(location = 0) out vec4 fragColor;
 
 void main()
 {
+#ifdef LIGHT_PALETTE
+	vec4 lightPositionRadius = texelFetch(lightPalette, inLightIndex * 2 + 0);
+	vec4 lightColorFalloffExp = texelFetch(lightPalette, inLightIndex * 2 + 1);
+#endif
+
+#ifdef HALF_RES
+	// Rendering to the downsampled G-buffer; only the light reaching the surface is stored, the albedo is applied
+	// at full resolution when upsampling.
+	ivec2 coords = ivec2(gl_FragCoord.xy);
+	vec3 position = texelFetch(positionTex, coords, 0).xyz;
+	vec3 normal = normalize(texelFetch(normalTex, coords, 0).xyz);
+#else
 	vec2 uv = (gl_FragCoord.xy - viewport.xy) / viewport.zw;
 	vec4 diffuseColor = texture(diffuseTex, uv);
 	vec3 position = texture(positionTex, uv).xyz;
 	vec3 normal = normalize(texture(normalTex, uv).xyz);
+#endif
 
 	vec3 lightVec = lightPositionRadius.xyz - position;
 	float distance = length(lightVec);
 	float falloff = pow(max(1.0 - distance / lightPositionRadius.w, 0.0), lightColorFalloffExp.a);
 	float intensity = dot(normal, normalize(lightVec));
 
+#ifdef HALF_RES
+	// The float target doesn't clamp like the scene buffer, so light from behind the surface must not subtract.
+	fragColor = vec4(lightColorFalloffExp.rgb * max(intensity, 0.0) * falloff, 1.0);
+#else
 	fragColor = vec4(lightColorFalloffExp.rgb * diffuseColor.rgb * intensity * falloff, 1.0);
+#endif
 }
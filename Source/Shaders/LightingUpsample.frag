@@ -0,0 +1,64 @@
+#version 440
+
+layout(location = 0) out vec4 fragColor;
+
+layout(binding = 0) uniform sampler2D diffuseTex;
+layout(binding = 1) uniform sampler2D positionTex;
+layout(binding = 2) uniform sampler2D normalTex;
+layout(binding = 3) uniform sampler2D halfLightTex;
+layout(binding = 4) uniform sampler2D halfPositionTex;
+layout(binding = 5) uniform sampler2D halfNormalTex;
+
+layout(binding = 1) uniform UpsampleData
+{
+	ivec2 halfMaxCoords;	// Last pixel of the half resolution region lit this frame.
+};
+
+// Half resolution samples this far (in cm) from the pixel's tangent plane get half the weight.
+const float PlaneDistanceScale = 2.0;
+const float NormalPower = 8.0;
+
+
+void main()
+{
+	ivec2 coords = ivec2(gl_FragCoord.xy);
+
+	vec3 normal = texelFetch(normalTex, coords, 0).xyz;
+	if (dot(normal, normal) == 0.0)
+		discard;	// No surface here; the scene buffer keeps its clear color.
+
+	normal = normalize(normal);
+	vec3 position = texelFetch(positionTex, coords, 0).xyz;
+
+	// Half resolution pixel i was taken from full resolution pixel 2i, so this pixel lies between half
+	// resolution pixels coords / 2 and coords / 2 + 1, exactly at them or half way.
+	ivec2 base = coords / 2;
+	vec2 subPixel = vec2(coords - base * 2) * 0.5;
+
+	vec3 light = vec3(0.0);
+	float weightSum = 0.0;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		ivec2 offset = ivec2(i & 1, i >> 1);
+		ivec2 halfCoords = min(base + offset, halfMaxCoords);
+
+		vec2 bilinear = mix(1.0 - subPixel, subPixel, vec2(offset));
+		vec3 halfNormal = texelFetch(halfNormalTex, halfCoords, 0).xyz;
+		vec3 halfPosition = texelFetch(halfPositionTex, halfCoords, 0).xyz;
+
+		// Samples from other surfaces, across depth discontinuities or creases, get little or no weight.
+		float normalWeight = pow(max(dot(normal, halfNormal), 0.0), NormalPower);
+		float planeWeight = 1.0 / (1.0 + abs(dot(halfPosition - position, normal)) / PlaneDistanceScale);
+		float weight = bilinear.x * bilinear.y * normalWeight * planeWeight;
+
+		light += texelFetch(halfLightTex, halfCoords, 0).rgb * weight;
+		weightSum += weight;
+	}
+
+	// No neighbour belongs to this surface (thin features); take the nearest one.
+	light = weightSum > 1e-4 ? light / weightSum : texelFetch(halfLightTex, base, 0).rgb;
+
+	vec4 diffuseColor = texelFetch(diffuseTex, coords, 0);
+	fragColor = vec4(diffuseColor.rgb * light, 1.0);
+}
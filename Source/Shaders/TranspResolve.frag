@@ -0,0 +1,20 @@
+#version 440
+
+layout(location = 0) out vec4 fragColor;
+
+layout(binding = 0) uniform sampler2D accumTex;
+layout(binding = 1) uniform sampler2D revealageTex;
+
+
+void main()
+{
+	ivec2 coords = ivec2(gl_FragCoord.xy);
+
+	float revealage = texelFetch(revealageTex, coords, 0).r;
+	if (revealage == 1.0)
+		discard;
+
+	// Weighted average color of the transparent layers, covering all but the revealed part of the background.
+	vec4 accum = texelFetch(accumTex, coords, 0);
+	fragColor = vec4(accum.rgb / clamp(accum.a, 1e-4, 5e4), revealage);
+}
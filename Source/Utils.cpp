@@ -8,6 +8,7 @@
 	#include <Windows.h>
 #elif defined (__linux__)
 	#include <unistd.h>
+	#include <climits>
 #endif
 #include <Math/transform.h>
 
@@ -23,14 +24,15 @@ std::string GetFullPath(const char* file_name)
 #elif defined (__linux__)
 std::string GetFullPath(const char* file_name)
 {
-	char path[256];
-	readlink("/proc/self/exe", path, sizeof(path));
+	char path[PATH_MAX];
+	ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	path[len > 0 ? len : 0] = '\0';	// readlink doesn't terminate the string.
 	const char* slash = strrchr(path, '/');
 	return slash ? std::string(path, slash - path + 1) + file_name : std::string(file_name);
 }
 #endif
 
-std::string LoadShaderSource(const char* fileName)
+std::string LoadShaderSource(const char* fileName, const std::vector<std::string>& defines)
 {
 	std::string relPath = std::string("../Source/Shaders/") + fileName;
 	std::string fn = GetFullPath(relPath.c_str());
@@ -45,7 +47,54 @@ std::string LoadShaderSource(const char* fileName)
 	fread(source.get(), size, 1, file);
 	source[size] = '\0';
 	fclose(file);
-	return std::string(source.get());
+
+	std::string result(source.get());
+	if (defines.empty())
+		return result;
+
+	// Defines have the form "NAME" or "NAME VALUE" and are inserted right after the #version directive,
+	// which must stay the first statement in the shader.
+	std::string defineBlock;
+	for (const std::string& define : defines)
+		defineBlock += "#define " + define + "\n";
+
+	size_t insertPos = 0;
+	size_t versionPos = result.find("#version");
+	if (versionPos != std::string::npos)
+	{
+		size_t lineEnd = result.find('\n', versionPos);
+		insertPos = (lineEnd != std::string::npos) ? lineEnd + 1 : result.size();
+	}
+
+	result.insert(insertPos, defineBlock);
+	return result;
+}
+
+std::string GetShaderPermutationName(const char* fileName, const std::vector<std::string>& defines)
+{
+	std::string name = fileName;
+	for (const std::string& define : defines)
+	{
+		name += '.';
+		for (char ch : define)
+			name += (ch == ' ') ? '_' : ch;
+	}
+
+	return name;
+}
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+{
+	// 64-bit FNV-1a.
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
 }
 
 void ExpandBounds(math3d::vec3f& minPt, math3d::vec3f& maxPt, const math3d::vec3f& newPt)
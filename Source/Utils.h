@@ -8,7 +8,9 @@
 #include <Math/mat4.h>
 
 std::string GetFullPath(const char* file_name);
-std::string LoadShaderSource(const char* file_name);
+std::string LoadShaderSource(const char* file_name, const std::vector<std::string>& defines = {});
+std::string GetShaderPermutationName(const char* file_name, const std::vector<std::string>& defines);
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
 
 template <typename T, size_t N>
 constexpr int CountOf(T(&)[N])
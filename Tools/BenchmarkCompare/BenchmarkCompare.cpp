@@ -0,0 +1,358 @@
+// Compares benchmark result files (.bmark) written by the DeferredShading benchmark and reports
+// statistically significant frame time regressions of candidate runs against a baseline run.
+//
+// Usage: bmark-compare [options] baseline.bmark candidate.bmark [candidate.bmark ...]
+//
+// The process exits with 0 if no regression was found, 1 if at least one candidate regressed and
+// 2 if the arguments or files could not be read.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "BenchmarkStats.h"
+
+
+struct Sample
+{
+	float time;		// Demo time in seconds.
+	float value;	// Milliseconds.
+};
+
+static constexpr int NumRenderPaths = 3;
+static constexpr int NumMetrics = 3;
+
+static const char* RenderPathColumns[NumRenderPaths] = { "Forward", "ForwardSP", "Deferred" };
+static const char* MetricColumns[NumMetrics] = { "Dt", "Cpu", "Gpu" };
+static const char* MetricNames[NumMetrics] = { "frame", "cpu", "gpu" };
+
+struct BenchmarkRun
+{
+	std::string fileName;
+	std::array<std::array<std::vector<Sample>, NumMetrics>, NumRenderPaths> series;
+};
+
+struct Options
+{
+	float thresholdPercent = 3.0f;	// Minimum median slowdown that counts as a regression.
+	double alpha = 0.01;			// Significance level of the Mann-Whitney U test.
+	float segmentLength = 5.0f;		// Length of demo time segments tested separately, 0 disables them.
+	int minSegmentSamples = 20;
+};
+
+struct Comparison
+{
+	FrameTimeStats baseline;
+	FrameTimeStats candidate;
+	double pValue;
+	float changePercent;
+};
+
+
+static std::vector<std::string> SplitCsvLine(const std::string& line)
+{
+	std::vector<std::string> cells;
+	std::stringstream stream(line);
+	std::string cell;
+	while (std::getline(stream, cell, ','))
+	{
+		if (!cell.empty() && cell.back() == '\r')
+			cell.pop_back();
+		cells.push_back(cell);
+	}
+	return cells;
+}
+
+static int FindColumn(const std::vector<std::string>& header, const std::string& name)
+{
+	auto it = std::find(header.begin(), header.end(), name);
+	return (it != header.end()) ? static_cast<int>(it - header.begin()) : -1;
+}
+
+static bool LoadBenchmarkRun(const char* fileName, BenchmarkRun& run)
+{
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.good())
+	{
+		fprintf(stderr, "Failed to open %s\n", fileName);
+		return false;
+	}
+
+	std::string line;
+	if (!std::getline(file, line))
+	{
+		fprintf(stderr, "%s is empty\n", fileName);
+		return false;
+	}
+
+	// Columns are looked up by name so that files written before CPU and GPU times were recorded still load.
+	std::vector<std::string> header = SplitCsvLine(line);
+	int timeColumns[NumRenderPaths];
+	int metricColumns[NumRenderPaths][NumMetrics];
+	bool anyColumn = false;
+
+	for (int path = 0; path < NumRenderPaths; ++path)
+	{
+		timeColumns[path] = FindColumn(header, std::string(RenderPathColumns[path]) + "Time");
+		for (int metric = 0; metric < NumMetrics; ++metric)
+			metricColumns[path][metric] = FindColumn(header, std::string(RenderPathColumns[path]) + MetricColumns[metric]);
+		anyColumn = anyColumn || timeColumns[path] >= 0;
+	}
+
+	if (!anyColumn)
+	{
+		fprintf(stderr, "%s is not a benchmark results file\n", fileName);
+		return false;
+	}
+
+	run.fileName = fileName;
+
+	while (std::getline(file, line))
+	{
+		std::vector<std::string> cells = SplitCsvLine(line);
+
+		for (int path = 0; path < NumRenderPaths; ++path)
+		{
+			int timeCol = timeColumns[path];
+			if (timeCol < 0 || timeCol >= static_cast<int>(cells.size()) || cells[timeCol].empty())
+				continue;
+
+			float time = strtof(cells[timeCol].c_str(), nullptr);
+
+			for (int metric = 0; metric < NumMetrics; ++metric)
+			{
+				int col = metricColumns[path][metric];
+				if (col >= 0 && col < static_cast<int>(cells.size()) && !cells[col].empty())
+					run.series[path][metric].push_back({ time, strtof(cells[col].c_str(), nullptr) });
+			}
+		}
+	}
+
+	return true;
+}
+
+// Two-sided p-value of the Mann-Whitney U test, using the normal approximation with tie correction.
+static double MannWhitneyU(const std::vector<float>& a, const std::vector<float>& b)
+{
+	size_t n1 = a.size();
+	size_t n2 = b.size();
+	size_t n = n1 + n2;
+	if (n1 == 0 || n2 == 0)
+		return 1.0;
+
+	std::vector<std::pair<float, int>> values;
+	values.reserve(n);
+	for (float v : a)
+		values.push_back({ v, 0 });
+	for (float v : b)
+		values.push_back({ v, 1 });
+	std::sort(values.begin(), values.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+
+	double rankSumA = 0.0;
+	double tieSum = 0.0;
+	for (size_t i = 0; i < n; )
+	{
+		size_t j = i;
+		while (j < n && values[j].first == values[i].first)
+			++j;
+
+		double rank = (i + 1 + j) * 0.5;	// Average of ranks i+1 .. j.
+		for (size_t k = i; k < j; ++k)
+		{
+			if (values[k].second == 0)
+				rankSumA += rank;
+		}
+
+		double t = static_cast<double>(j - i);
+		tieSum += t * t * t - t;
+		i = j;
+	}
+
+	double u = rankSumA - n1 * (n1 + 1) * 0.5;
+	double mean = n1 * n2 * 0.5;
+	double variance = n1 * n2 / 12.0 * ((n + 1) - tieSum / (static_cast<double>(n) * (n - 1)));
+	if (variance <= 0.0)
+		return 1.0;
+
+	double diff = std::max(std::fabs(u - mean) - 0.5, 0.0);	// Continuity correction.
+	double z = diff / std::sqrt(variance);
+	return std::erfc(z / std::sqrt(2.0));
+}
+
+static std::vector<float> GetValues(const std::vector<Sample>& series, float startTime, float endTime)
+{
+	std::vector<float> values;
+	for (const Sample& sample : series)
+	{
+		if (sample.time >= startTime && sample.time < endTime)
+			values.push_back(sample.value);
+	}
+	return values;
+}
+
+static Comparison Compare(const std::vector<float>& baseline, const std::vector<float>& candidate)
+{
+	Comparison result;
+	result.baseline = ComputeFrameTimeStats(baseline);
+	result.candidate = ComputeFrameTimeStats(candidate);
+	result.pValue = MannWhitneyU(baseline, candidate);
+	result.changePercent = (result.baseline.median > 0.0f) ?
+		(result.candidate.median - result.baseline.median) / result.baseline.median * 100.0f : 0.0f;
+	return result;
+}
+
+static bool IsRegression(const Comparison& cmp, double alpha, const Options& options)
+{
+	return cmp.pValue < alpha && cmp.changePercent > options.thresholdPercent;
+}
+
+static bool IsImprovement(const Comparison& cmp, double alpha, const Options& options)
+{
+	return cmp.pValue < alpha && cmp.changePercent < -options.thresholdPercent;
+}
+
+// Prints the comparison of one candidate run against the baseline and returns true if it regressed.
+static bool ReportCandidate(const BenchmarkRun& baseline, const BenchmarkRun& candidate, const Options& options)
+{
+	bool regressed = false;
+
+	printf("\nBaseline:  %s\nCandidate: %s\n\n", baseline.fileName.c_str(), candidate.fileName.c_str());
+	printf("%-10s %-6s %10s %10s %9s %10s %10s %10s\n", "Path", "Metric", "Base med", "Cand med", "Change", "Base p99", "Cand p99", "p-value");
+
+	for (int path = 0; path < NumRenderPaths; ++path)
+	{
+		for (int metric = 0; metric < NumMetrics; ++metric)
+		{
+			const auto& baseSeries = baseline.series[path][metric];
+			const auto& candSeries = candidate.series[path][metric];
+			if (baseSeries.empty() || candSeries.empty())
+				continue;
+
+			std::vector<float> baseValues = GetValues(baseSeries, -INFINITY, INFINITY);
+			std::vector<float> candValues = GetValues(candSeries, -INFINITY, INFINITY);
+			Comparison cmp = Compare(baseValues, candValues);
+
+			const char* verdict = "";
+			if (IsRegression(cmp, options.alpha, options))
+			{
+				verdict = "REGRESSION";
+				regressed = true;
+			}
+			else if (IsImprovement(cmp, options.alpha, options))
+			{
+				verdict = "improvement";
+			}
+
+			printf("%-10s %-6s %10.3f %10.3f %+8.2f%% %10.3f %10.3f %10.2g  %s\n",
+				RenderPathColumns[path], MetricNames[metric], cmp.baseline.median, cmp.candidate.median, cmp.changePercent,
+				cmp.baseline.p99, cmp.candidate.p99, cmp.pValue, verdict);
+
+			// Segments of demo time are tested separately so that a regression in one part of the demo is not
+			// averaged away by the rest. The significance level is divided by the number of segments (Bonferroni).
+			if (options.segmentLength <= 0.0f)
+				continue;
+
+			float endTime = std::min(baseSeries.back().time, candSeries.back().time);
+			int numSegments = static_cast<int>(std::ceil(endTime / options.segmentLength));
+			if (numSegments < 2)
+				continue;
+
+			double segmentAlpha = options.alpha / numSegments;
+
+			for (int seg = 0; seg < numSegments; ++seg)
+			{
+				float segStart = seg * options.segmentLength;
+				float segEnd = segStart + options.segmentLength;
+				std::vector<float> baseSeg = GetValues(baseSeries, segStart, segEnd);
+				std::vector<float> candSeg = GetValues(candSeries, segStart, segEnd);
+				if (static_cast<int>(baseSeg.size()) < options.minSegmentSamples || static_cast<int>(candSeg.size()) < options.minSegmentSamples)
+					continue;
+
+				Comparison segCmp = Compare(baseSeg, candSeg);
+				if (IsRegression(segCmp, segmentAlpha, options))
+				{
+					printf("    %6.1f-%6.1f s %10.3f %10.3f %+8.2f%% %10.3f %10.3f %10.2g  REGRESSION\n",
+						segStart, segEnd, segCmp.baseline.median, segCmp.candidate.median, segCmp.changePercent,
+						segCmp.baseline.p99, segCmp.candidate.p99, segCmp.pValue);
+					regressed = true;
+				}
+			}
+		}
+	}
+
+	return regressed;
+}
+
+static void PrintUsage()
+{
+	printf(
+		"Usage: bmark-compare [options] baseline.bmark candidate.bmark [candidate.bmark ...]\n"
+		"\n"
+		"Options:\n"
+		"  --threshold <percent>  Minimum median slowdown reported as a regression (default 3).\n"
+		"  --alpha <p>            Significance level of the Mann-Whitney U test (default 0.01).\n"
+		"  --segment <seconds>    Length of demo time segments tested separately, 0 to disable (default 5).\n"
+		"  --min-samples <n>      Minimum number of frames in a segment for it to be tested (default 20).\n"
+		"\n"
+		"Exits with 1 if any candidate regressed against the baseline, 2 on errors and 0 otherwise.\n");
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	std::vector<const char*> fileNames;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(arg, "--threshold") == 0 && hasValue)
+			options.thresholdPercent = strtof(argv[++i], nullptr);
+		else if (strcmp(arg, "--alpha") == 0 && hasValue)
+			options.alpha = strtod(argv[++i], nullptr);
+		else if (strcmp(arg, "--segment") == 0 && hasValue)
+			options.segmentLength = strtof(argv[++i], nullptr);
+		else if (strcmp(arg, "--min-samples") == 0 && hasValue)
+			options.minSegmentSamples = atoi(argv[++i]);
+		else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0)
+		{
+			PrintUsage();
+			return 0;
+		}
+		else if (strncmp(arg, "--", 2) == 0)
+		{
+			fprintf(stderr, "Unknown option %s\n", arg);
+			PrintUsage();
+			return 2;
+		}
+		else
+			fileNames.push_back(arg);
+	}
+
+	if (fileNames.size() < 2)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	std::vector<BenchmarkRun> runs(fileNames.size());
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		if (!LoadBenchmarkRun(fileNames[i], runs[i]))
+			return 2;
+	}
+
+	bool regressed = false;
+	for (size_t i = 1; i < runs.size(); ++i)
+		regressed = ReportCandidate(runs[0], runs[i], options) || regressed;
+
+	printf("\n%s\n", regressed ? "Performance regression detected." : "No performance regression detected.");
+	return regressed ? 1 : 0;
+}
@@ -0,0 +1,691 @@
+// Microbenchmarks of the geometry and culling functions run every frame by the renderer.
+//
+// Usage: DeferredShadingBench [options]
+//
+// Every kernel runs on a Sponza-sized data set, matching what the renderer processes per frame,
+// and on a large synthetic data set. Results are printed as time per item and items per second.
+//
+// DeferredShadingBenchScalar is the same program built with MATH3D_NO_SIMD, for comparing the math
+// library's SIMD specializations with its scalar templates, and DeferredShadingBenchAVX2 is built for
+// AVX2 and FMA. With --verify, the program checks the float specializations it was built with against the
+// scalar templates instead of running the benchmarks.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <Math/transform.h>
+#include "Utils.h"
+#include "LightGrid.h"
+
+
+struct DataSet
+{
+	const char* name;
+	std::vector<math3d::vec3f> boxMin;
+	std::vector<math3d::vec3f> boxMax;
+	std::vector<math3d::vec3f> lightPos;
+	std::vector<float> lightRadius;
+	std::vector<math3d::mat4f> modelMats;
+	std::vector<math3d::vec3f> directions;
+	int interactionObjects;		// Number of boxes and lights tested against each other, all pairs.
+	int interactionLights;
+};
+
+struct Result
+{
+	std::string kernel;
+	std::string dataSet;
+	size_t items;		// Items processed by one run.
+	double nsPerItem;	// Median over all timed batches.
+	double itemsPerSecond;
+};
+
+struct Options
+{
+	double minTime = 0.5;	// Seconds spent timing each kernel.
+	bool verify = false;
+	const char* filter = nullptr;
+	const char* jsonFileName = nullptr;
+};
+
+// Bounds of the Sponza scene in model units.
+static const math3d::vec3f SceneMin(-1920.0f, -126.0f, -1105.0f);
+static const math3d::vec3f SceneMax(1800.0f, 1430.0f, 1142.0f);
+
+// Stores results so that the compiler can't remove the benchmarked code.
+static volatile float Sink;
+
+
+static DataSet CreateDataSet(const char* name, int numBoxes, int numLights, int interactionObjects, int interactionLights)
+{
+	DataSet data;
+	data.name = name;
+	data.interactionObjects = interactionObjects;
+	data.interactionLights = interactionLights;
+
+	std::mt19937 gen(1234);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	auto randomPoint = [&]()
+	{
+		return math3d::vec3f(
+			math3d::lerp(SceneMin.x, SceneMax.x, unit(gen)),
+			math3d::lerp(SceneMin.y, SceneMax.y, unit(gen)),
+			math3d::lerp(SceneMin.z, SceneMax.z, unit(gen)));
+	};
+
+	for (int i = 0; i < numBoxes; ++i)
+	{
+		math3d::vec3f center = randomPoint();
+		math3d::vec3f halfSize(
+			math3d::lerp(10.0f, 300.0f, unit(gen)),
+			math3d::lerp(10.0f, 300.0f, unit(gen)),
+			math3d::lerp(10.0f, 300.0f, unit(gen)));
+		data.boxMin.push_back(center - halfSize);
+		data.boxMax.push_back(center + halfSize);
+
+		math3d::mat4f model;
+		model.set_identity();
+		model.rotate_y(unit(gen) * 2.0f * math3d::PI);
+		model.translate(center);
+		data.modelMats.push_back(model);
+		data.directions.push_back(halfSize);
+	}
+
+	for (int i = 0; i < numLights; ++i)
+	{
+		data.lightPos.push_back(randomPoint());
+		data.lightRadius.push_back(math3d::lerp(50.0f, 250.0f, unit(gen)));
+	}
+
+	return data;
+}
+
+static void GetCamera(math3d::mat4f& viewMat, math3d::mat4f& projMat)
+{
+	// Looking down the atrium from one end, as at the start of most demos.
+	viewMat.look_at(math3d::vec3f(-1300.0f, 200.0f, 0.0f), math3d::vec3f(0.0f, 300.0f, 0.0f), math3d::vec3f(0.0f, 1.0f, 0.0f));
+	projMat.perspective(math3d::deg2rad(70.0f), 1024.0f / 768.0f, 10.0f, 4000.0f);
+}
+
+static Result RunKernel(const char* kernel, const DataSet& data, size_t items, const Options& options, const std::function<void()>& func)
+{
+	using Clock = std::chrono::steady_clock;
+	auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+
+	// Warm up caches and find the number of runs which take at least a millisecond, so that
+	// timer resolution doesn't affect the results.
+	func();
+	int runsPerBatch = 1;
+	for (;;)
+	{
+		auto start = Clock::now();
+		for (int i = 0; i < runsPerBatch; ++i)
+			func();
+		if (seconds(Clock::now() - start) >= 0.001 || runsPerBatch >= (1 << 24))
+			break;
+		runsPerBatch *= 2;
+	}
+
+	std::vector<double> batchTimes;
+	auto timingStart = Clock::now();
+	do
+	{
+		auto start = Clock::now();
+		for (int i = 0; i < runsPerBatch; ++i)
+			func();
+		batchTimes.push_back(seconds(Clock::now() - start));
+	}
+	while (seconds(Clock::now() - timingStart) < options.minTime || batchTimes.size() < 5);
+
+	std::nth_element(batchTimes.begin(), batchTimes.begin() + batchTimes.size() / 2, batchTimes.end());
+	double median = batchTimes[batchTimes.size() / 2];
+
+	Result result;
+	result.kernel = kernel;
+	result.dataSet = data.name;
+	result.items = items;
+	result.nsPerItem = median * 1e9 / (static_cast<double>(items) * runsPerBatch);
+	result.itemsPerSecond = 1e9 / result.nsPerItem;
+
+	printf("%-28s %-10s %10zu %12.3f %14.2f\n", kernel, data.name, items, result.nsPerItem, result.itemsPerSecond * 1e-6);
+	return result;
+}
+
+static bool IsSelected(const char* kernel, const Options& options)
+{
+	return !options.filter || strstr(kernel, options.filter);
+}
+
+static void RunDataSet(const DataSet& data, const Options& options, std::vector<Result>& results)
+{
+	math3d::mat4f viewMat, projMat;
+	GetCamera(viewMat, projMat);
+
+	std::vector<math3d::vec4f> frustumPlanes;
+	ExtractFrustumPlanes(projMat, frustumPlanes);
+
+	const size_t numBoxes = data.boxMin.size();
+	const size_t numLights = data.lightPos.size();
+
+	if (IsSelected("ExtractFrustumPlanes", options))
+	{
+		std::vector<math3d::vec4f> planes;
+		results.push_back(RunKernel("ExtractFrustumPlanes", data, 1, options, [&]()
+		{
+			ExtractFrustumPlanes(projMat, planes);
+			Sink = planes[17].w;
+		}));
+	}
+
+	if (IsSelected("mul(mat4, mat4, mat4)", options))
+	{
+		std::vector<math3d::mat4f> modelViewMats(numBoxes);
+		results.push_back(RunKernel("mul(mat4, mat4, mat4)", data, numBoxes, options, [&]()
+		{
+			for (size_t i = 0; i < numBoxes; ++i)
+				math3d::mul(modelViewMats[i], data.modelMats[i], viewMat);
+			Sink = modelViewMats[numBoxes - 1](15);
+		}));
+	}
+
+	if (IsSelected("vec4 * mat4", options))
+	{
+		std::vector<math3d::vec4f> clipPts(numBoxes);
+		results.push_back(RunKernel("vec4 * mat4", data, numBoxes, options, [&]()
+		{
+			for (size_t i = 0; i < numBoxes; ++i)
+				clipPts[i] = math3d::vec4f(data.boxMin[i], 1.0f) * projMat;
+			Sink = clipPts[numBoxes - 1].w;
+		}));
+	}
+
+	if (IsSelected("vec3 * mat4", options))
+	{
+		std::vector<math3d::vec3f> viewPts(numBoxes);
+		results.push_back(RunKernel("vec3 * mat4", data, numBoxes, options, [&]()
+		{
+			for (size_t i = 0; i < numBoxes; ++i)
+				viewPts[i] = data.boxMin[i] * viewMat;
+			Sink = viewPts[numBoxes - 1].z;
+		}));
+	}
+
+	if (IsSelected("transform_points", options))
+	{
+		std::vector<math3d::vec3f> viewPts(numBoxes);
+		results.push_back(RunKernel("transform_points", data, numBoxes, options, [&]()
+		{
+			math3d::transform_points(data.boxMin.data(), viewPts.data(), numBoxes, viewMat);
+			Sink = viewPts[numBoxes - 1].z;
+		}));
+	}
+
+	if (IsSelected("transform_points (SoA)", options))
+	{
+		std::vector<float> x(numBoxes), y(numBoxes), z(numBoxes);
+		for (size_t i = 0; i < numBoxes; ++i)
+		{
+			x[i] = data.boxMin[i].x;
+			y[i] = data.boxMin[i].y;
+			z[i] = data.boxMin[i].z;
+		}
+
+		std::vector<float> viewX(numBoxes), viewY(numBoxes), viewZ(numBoxes);
+		results.push_back(RunKernel("transform_points (SoA)", data, numBoxes, options, [&]()
+		{
+			math3d::transform_points(x.data(), y.data(), z.data(), viewX.data(), viewY.data(), viewZ.data(), numBoxes, viewMat);
+			Sink = viewZ[numBoxes - 1];
+		}));
+	}
+
+	if (IsSelected("transform_dir", options))
+	{
+		std::vector<math3d::vec3f> viewDirs(numBoxes);
+		results.push_back(RunKernel("transform_dir", data, numBoxes, options, [&]()
+		{
+			for (size_t i = 0; i < numBoxes; ++i)
+				viewDirs[i] = math3d::transform_dir(data.directions[i], viewMat);
+			Sink = viewDirs[numBoxes - 1].z;
+		}));
+	}
+
+	// Same work as DeferredRenderer::UpdateLights for each light.
+	if (IsSelected("ViewSpaceSphereInsideFrustum", options))
+	{
+		results.push_back(RunKernel("ViewSpaceSphereInsideFrustum", data, numLights, options, [&]()
+		{
+			int visible = 0;
+			for (size_t i = 0; i < numLights; ++i)
+				visible += ViewSpaceSphereInsideFrustum(data.lightPos[i] * viewMat, data.lightRadius[i], frustumPlanes);
+			Sink = static_cast<float>(visible);
+		}));
+	}
+
+	// Same work as DeferredRenderer::UpdateVisibleObjects for each mesh.
+	if (IsSelected("ViewSpaceBBoxInsideFrustum", options))
+	{
+		results.push_back(RunKernel("ViewSpaceBBoxInsideFrustum", data, numBoxes, options, [&]()
+		{
+			int visible = 0;
+			for (size_t i = 0; i < numBoxes; ++i)
+			{
+				auto centerPt = (data.boxMax[i] + data.boxMin[i]) * 0.5f;
+				auto vec = (data.boxMax[i] - data.boxMin[i]) * 0.5f;
+
+				visible += ViewSpaceBBoxInsideFrustum(
+					centerPt * viewMat,
+					math3d::transform_dir(math3d::vec3f(vec.x, 0.0f, 0.0f), viewMat),
+					math3d::transform_dir(math3d::vec3f(0.0f, vec.y, 0.0f), viewMat),
+					math3d::transform_dir(math3d::vec3f(0.0f, 0.0f, vec.z), viewMat),
+					frustumPlanes);
+			}
+			Sink = static_cast<float>(visible);
+		}));
+	}
+
+	// Same work as DeferredRenderer::UpdateLightObjectInteractions, all objects against all lights.
+	if (IsSelected("AABBOverlapsSphere", options))
+	{
+		const size_t numObjects = data.interactionObjects;
+		const size_t numInterLights = data.interactionLights;
+
+		results.push_back(RunKernel("AABBOverlapsSphere", data, numObjects * numInterLights, options, [&]()
+		{
+			int interactions = 0;
+			for (size_t objInd = 0; objInd < numObjects; ++objInd)
+			{
+				for (size_t lightInd = 0; lightInd < numInterLights; ++lightInd)
+					interactions += AABBOverlapsSphere(data.boxMin[objInd], data.boxMax[objInd], data.lightPos[lightInd], data.lightRadius[lightInd]);
+			}
+			Sink = static_cast<float>(interactions);
+		}));
+	}
+}
+
+// Results of the float functions are compared with the scalar templates evaluated in double precision. The
+// tolerance is relative to the sum of the absolute values of the terms, which bounds the rounding error of both
+// the plain and the fused multiply-add sums.
+class MathVerifier
+{
+public:
+	void Check(const char* func, const char* dataSet, size_t item, float result, double expected, double magnitude)
+	{
+		++_checks;
+		double tolerance = 8.0 * FLT_EPSILON * magnitude + FLT_MIN;
+		if (std::abs(result - expected) <= tolerance)
+			return;
+
+		if (_failures < MaxReportedFailures)
+		{
+			fprintf(stderr, "%s (%s, item %zu): got %.9g, expected %.9g (tolerance %.3g)\n",
+				func, dataSet, item, result, expected, tolerance);
+		}
+		++_failures;
+	}
+
+	void CheckPoint(const char* func, const char* dataSet, size_t item, const math3d::vec3f& result, const math3d::vec3f& in, const math3d::mat4f& m, bool translate)
+	{
+		math3d::mat4d md(m);
+		math3d::mat4d absM = Abs(md);
+		math3d::vec3d vd(in);
+		math3d::vec3d absV(std::abs(vd.x), std::abs(vd.y), std::abs(vd.z));
+
+		math3d::vec3d expected = translate ? vd * md : math3d::transform_dir(vd, md);
+		math3d::vec3d magnitude = translate ? absV * absM : math3d::transform_dir(absV, absM);
+
+		for (int i = 0; i < 3; ++i)
+			Check(func, dataSet, item, result[i], expected[i], magnitude[i]);
+	}
+
+	void CheckVec4(const char* func, const char* dataSet, size_t item, const math3d::vec4f& result, const math3d::vec4f& in, const math3d::mat4f& m)
+	{
+		math3d::mat4d md(m);
+		math3d::vec4d vd(in.x, in.y, in.z, in.w);
+		math3d::vec4d absV(std::abs(vd.x), std::abs(vd.y), std::abs(vd.z), std::abs(vd.w));
+
+		math3d::vec4d expected = vd * md;
+		math3d::vec4d magnitude = absV * Abs(md);
+
+		for (int i = 0; i < 4; ++i)
+			Check(func, dataSet, item, result[i], expected[i], magnitude[i]);
+	}
+
+	void CheckMul(const char* func, const char* dataSet, size_t item, const math3d::mat4f& result, const math3d::mat4f& a, const math3d::mat4f& b)
+	{
+		math3d::mat4d ad(a), bd(b);
+		math3d::mat4d expected, magnitude;
+		math3d::mul(expected, ad, bd);
+		math3d::mul(magnitude, Abs(ad), Abs(bd));
+
+		for (int i = 0; i < 16; ++i)
+			Check(func, dataSet, item, result(i), expected(i), magnitude(i));
+	}
+
+	int GetChecks() const { return _checks; }
+	int GetFailures() const { return _failures; }
+
+private:
+	static constexpr int MaxReportedFailures = 20;
+
+	static math3d::mat4d Abs(const math3d::mat4d& m)
+	{
+		math3d::mat4d r;
+		for (int i = 0; i < 16; ++i)
+			r(i) = std::abs(m(i));
+		return r;
+	}
+
+	int _checks = 0;
+	int _failures = 0;
+};
+
+static void VerifyDataSet(const DataSet& data, MathVerifier& verifier)
+{
+	math3d::mat4f viewMat, projMat;
+	GetCamera(viewMat, projMat);
+
+	const size_t numBoxes = data.boxMin.size();
+	const char* name = data.name;
+
+	// Matrices of the data set, the camera's, and dense random ones with all elements set.
+	std::vector<math3d::mat4f> matrices = { viewMat, projMat };
+	std::mt19937 gen(5678);
+	std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+	for (int i = 0; i < 8; ++i)
+	{
+		math3d::mat4f m;
+		for (int j = 0; j < 16; ++j)
+			m(j) = dist(gen);
+		matrices.push_back(m);
+	}
+	for (size_t i = 0; i < std::min<size_t>(numBoxes, 64); ++i)
+		matrices.push_back(data.modelMats[i]);
+
+	// The scalar mul template writes the result while still reading the arguments, so they can't be the result.
+	for (size_t i = 0; i < numBoxes; ++i)
+	{
+		const math3d::mat4f& a = data.modelMats[i];
+		const math3d::mat4f& b = matrices[i % matrices.size()];
+
+		math3d::mat4f r;
+		math3d::mul(r, a, b);
+		verifier.CheckMul("mul(mat4, mat4, mat4)", name, i, r, a, b);
+	}
+
+	for (size_t i = 0; i < numBoxes; ++i)
+	{
+		const math3d::mat4f& m = matrices[i % matrices.size()];
+
+		math3d::vec4f v4(data.boxMin[i], i % 2 ? 1.0f : data.directions[i].x);
+		verifier.CheckVec4("vec4 * mat4", name, i, v4 * m, v4, m);
+		verifier.CheckPoint("vec3 * mat4", name, i, data.boxMin[i] * m, data.boxMin[i], m, true);
+		verifier.CheckPoint("transform_dir", name, i, math3d::transform_dir(data.directions[i], m), data.directions[i], m, false);
+	}
+
+	// Batched transforms, on counts around multiples of the vector width and on the whole data set, into
+	// another array and in place.
+
+	std::vector<size_t> counts;
+	for (size_t count = 0; count <= 13; ++count)
+		counts.push_back(count);
+	counts.push_back(numBoxes - 1);
+	counts.push_back(numBoxes);
+
+	std::vector<math3d::vec3f> out(numBoxes);
+	std::vector<float> x(numBoxes), y(numBoxes), z(numBoxes);
+	std::vector<float> outX(numBoxes), outY(numBoxes), outZ(numBoxes);
+
+	for (size_t count : counts)
+	{
+		const math3d::mat4f& m = matrices[count % matrices.size()];
+		const std::vector<math3d::vec3f>& in = data.boxMin;
+
+		math3d::transform_points(in.data(), out.data(), count, m);
+		for (size_t i = 0; i < count; ++i)
+			verifier.CheckPoint("transform_points", name, i, out[i], in[i], m, true);
+
+		out.assign(in.begin(), in.end());
+		math3d::transform_points(out.data(), out.data(), count, m);
+		for (size_t i = 0; i < count; ++i)
+			verifier.CheckPoint("transform_points (in place)", name, i, out[i], in[i], m, true);
+
+		math3d::transform_dirs(data.directions.data(), out.data(), count, m);
+		for (size_t i = 0; i < count; ++i)
+			verifier.CheckPoint("transform_dirs", name, i, out[i], data.directions[i], m, false);
+
+		out.assign(data.directions.begin(), data.directions.end());
+		math3d::transform_dirs(out.data(), out.data(), count, m);
+		for (size_t i = 0; i < count; ++i)
+			verifier.CheckPoint("transform_dirs (in place)", name, i, out[i], data.directions[i], m, false);
+
+		for (size_t i = 0; i < numBoxes; ++i)
+		{
+			x[i] = in[i].x;
+			y[i] = in[i].y;
+			z[i] = in[i].z;
+		}
+
+		math3d::transform_points(x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count, m);
+		for (size_t i = 0; i < count; ++i)
+			verifier.CheckPoint("transform_points (SoA)", name, i, math3d::vec3f(outX[i], outY[i], outZ[i]), in[i], m, true);
+
+		math3d::transform_points(x.data(), y.data(), z.data(), x.data(), y.data(), z.data(), count, m);
+		for (size_t i = 0; i < count; ++i)
+			verifier.CheckPoint("transform_points (SoA, in place)", name, i, math3d::vec3f(x[i], y[i], z[i]), in[i], m, true);
+
+		// Points past the count must be left alone.
+		for (size_t i = count; i < numBoxes; ++i)
+		{
+			if (x[i] != in[i].x || y[i] != in[i].y || z[i] != in[i].z)
+			{
+				verifier.Check("transform_points (SoA, past count)", name, i, x[i], in[i].x, 0.0);
+				break;
+			}
+		}
+	}
+}
+
+static void RunLightGrid(const DataSet& data, const Options& options, std::vector<Result>& results)
+{
+	math3d::mat4f viewMat, projMat;
+	GetCamera(viewMat, projMat);
+
+	std::vector<math3d::vec4f> frustumPlanes;
+	ExtractFrustumPlanes(projMat, frustumPlanes);
+
+	const size_t numLights = data.lightPos.size();
+	const size_t numObjects = data.interactionObjects;
+
+	// Lights move about as far per update as they do per frame in the renderer.
+	std::vector<math3d::vec3f> positions(data.lightPos);
+	std::vector<math3d::vec3f> moveDirs(numLights);
+	std::mt19937 gen(4321);
+	std::uniform_real_distribution<float> distNeg(-1.0f, 1.0f);
+	for (math3d::vec3f& dir : moveDirs)
+		dir = math3d::normalize(math3d::vec3f(distNeg(gen), distNeg(gen), distNeg(gen)));
+
+	LightGrid grid;
+	auto getSphere = [&](size_t i) { return math3d::vec4f(positions[i], data.lightRadius[i]); };
+	grid.Update(numLights, getSphere);
+
+	if (IsSelected("LightGrid::Update", options))
+	{
+		float step = 1.0f;
+		results.push_back(RunKernel("LightGrid::Update", data, numLights, options, [&]()
+		{
+			// Move back and forth, so that the lights stay in the scene.
+			step = -step;
+			for (size_t i = 0; i < numLights; ++i)
+				positions[i] += moveDirs[i] * step;
+			grid.Update(numLights, getSphere);
+			Sink = static_cast<float>(grid.GetReinsertCount());
+		}));
+	}
+
+	if (IsSelected("LightGrid::QueryFrustum", options))
+	{
+		results.push_back(RunKernel("LightGrid::QueryFrustum", data, numLights, options, [&]()
+		{
+			int visible = 0;
+			grid.QueryFrustum(viewMat, frustumPlanes, [&visible](uint32_t) { ++visible; });
+			Sink = static_cast<float>(visible);
+		}));
+	}
+
+	// Same interactions as the AABBOverlapsSphere kernel, but against all lights instead of a subset.
+	if (IsSelected("LightGrid::QueryAABB", options))
+	{
+		results.push_back(RunKernel("LightGrid::QueryAABB", data, numObjects, options, [&]()
+		{
+			int interactions = 0;
+			for (size_t objInd = 0; objInd < numObjects; ++objInd)
+				grid.QueryAABB(data.boxMin[objInd], data.boxMax[objInd], [&interactions](uint32_t) { ++interactions; });
+			Sink = static_cast<float>(interactions);
+		}));
+	}
+}
+
+static const char* GetMathInstructionSet()
+{
+#if defined (MATH3D_AVX) && defined (MATH3D_FMA)
+	return "AVX+FMA";
+#elif defined (MATH3D_AVX)
+	return "AVX";
+#elif defined (MATH3D_FMA)
+	return "SSE2+FMA";
+#elif defined (MATH3D_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+static bool WriteJson(const char* fileName, const std::vector<Result>& results)
+{
+	std::ofstream file(fileName);
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open %s\n", fileName);
+		return false;
+	}
+
+#if defined (_MSC_VER)
+	std::string compiler = "MSVC " + std::to_string(_MSC_VER);
+#elif defined (__clang__)
+	std::string compiler = std::string("Clang ") + __clang_version__;
+#elif defined (__GNUC__)
+	std::string compiler = std::string("GCC ") + __VERSION__;
+#else
+	std::string compiler = "unknown";
+#endif
+#if defined (NDEBUG)
+	const char* buildType = "Release";
+#else
+	const char* buildType = "Debug";
+#endif
+
+	file << "{\n";
+	file << "\t\"build\": {\n";
+	file << "\t\t\"type\": \"" << buildType << "\",\n";
+	file << "\t\t\"compiler\": \"" << compiler << "\",\n";
+	file << "\t\t\"math\": \"" << GetMathInstructionSet() << "\"\n";
+	file << "\t},\n";
+	file << "\t\"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& r = results[i];
+		file << "\t\t{ \"kernel\": \"" << r.kernel << "\", \"dataSet\": \"" << r.dataSet << "\", \"items\": " << r.items <<
+			", \"nsPerItem\": " << r.nsPerItem << ", \"itemsPerSecond\": " << r.itemsPerSecond << " }" <<
+			(i + 1 < results.size() ? ",\n" : "\n");
+	}
+	file << "\t]\n";
+	file << "}\n";
+
+	return true;
+}
+
+static void PrintUsage()
+{
+	printf(
+		"Usage: DeferredShadingBench [options]\n"
+		"\n"
+		"Options:\n"
+		"  --min-time <seconds>  Time spent measuring each kernel (default 0.5).\n"
+		"  --filter <text>       Run only the kernels whose name contains the text.\n"
+		"  --json <file>         Also write the results to a JSON file.\n"
+		"  --verify              Check the math library's float functions against its scalar templates\n"
+		"                        and exit with status 1 if any result is out of tolerance.\n");
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(arg, "--min-time") == 0 && hasValue)
+			options.minTime = strtod(argv[++i], nullptr);
+		else if (strcmp(arg, "--filter") == 0 && hasValue)
+			options.filter = argv[++i];
+		else if (strcmp(arg, "--json") == 0 && hasValue)
+			options.jsonFileName = argv[++i];
+		else if (strcmp(arg, "--verify") == 0)
+			options.verify = true;
+		else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0)
+		{
+			PrintUsage();
+			return 0;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown option %s\n", arg);
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	// The Sponza set has the scene's mesh count and the renderer's maximum number of lights.
+	// Interactions are tested between the visible part of it, as the renderer does.
+	DataSet dataSets[] =
+	{
+		CreateDataSet("sponza", 400, 1000, 150, 300),
+		CreateDataSet("synthetic", 100000, 100000, 4000, 4000),
+	};
+
+	printf("Math library: %s\n\n", GetMathInstructionSet());
+
+	if (options.verify)
+	{
+		MathVerifier verifier;
+		for (const DataSet& data : dataSets)
+			VerifyDataSet(data, verifier);
+
+		printf("%d checks, %d out of tolerance\n", verifier.GetChecks(), verifier.GetFailures());
+		return verifier.GetFailures() > 0 ? 1 : 0;
+	}
+
+	printf("%-28s %-10s %10s %12s %14s\n", "Kernel", "Data set", "Items", "ns/item", "Mitems/s");
+
+	std::vector<Result> results;
+	for (const DataSet& data : dataSets)
+		RunDataSet(data, options, results);
+	for (const DataSet& data : dataSets)
+		RunLightGrid(data, options, results);
+
+	if (options.jsonFileName && !WriteJson(options.jsonFileName, results))
+		return 2;
+
+	return 0;
+}